@@ -0,0 +1,104 @@
+// Copyright 2026 Zusitools
+
+#include "allokationen.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+struct BereichsZaehler final {
+  std::atomic<const char*> name { nullptr };
+  std::atomic<uint64_t> anzahl { 0 };
+  std::atomic<uint64_t> bytes { 0 };
+};
+
+constexpr size_t kAnzahlZaehler = 64;
+
+std::atomic<bool> g_verfuegbar { false };
+std::atomic<bool> g_aktiv { false };
+
+// Eintrag 0 sammelt Allokationen ausserhalb eines Bereichs und solche, fuer die kein Eintrag mehr frei ist.
+// Die Eintraege werden ueber die Adresse des Namens gefunden, ohne zu allokieren.
+BereichsZaehler g_zaehler[kAnzahlZaehler];
+
+thread_local const char* t_bereich = nullptr;
+
+BereichsZaehler& ZaehlerFuer(const char* name) {
+  if (name == nullptr) {
+    return g_zaehler[0];
+  }
+  for (size_t i = 1; i < kAnzahlZaehler; ++i) {
+    const char* eintrag = g_zaehler[i].name.load(std::memory_order_acquire);
+    if (eintrag == nullptr && (g_zaehler[i].name.compare_exchange_strong(eintrag, name, std::memory_order_acq_rel))) {
+      return g_zaehler[i];
+    }
+    if (eintrag == name) {
+      return g_zaehler[i];
+    }
+  }
+  return g_zaehler[0];
+}
+
+}  // namespace
+
+bool StarteAllokationsZaehlung() {
+  if (!g_verfuegbar.load()) {
+    return false;
+  }
+  for (auto& zaehler : g_zaehler) {
+    zaehler.name.store(nullptr);
+    zaehler.anzahl.store(0);
+    zaehler.bytes.store(0);
+  }
+  g_aktiv.store(true);
+  return true;
+}
+
+std::vector<AllokationsZaehler> BeendeAllokationsZaehlung() {
+  g_aktiv.store(false);
+
+  std::vector<AllokationsZaehler> result;
+  for (size_t i = 0; i < kAnzahlZaehler; ++i) {
+    const AllokationsZaehler zaehler { g_zaehler[i].name.load(), g_zaehler[i].anzahl.load(), g_zaehler[i].bytes.load() };
+    if (zaehler.anzahl == 0) {
+      continue;
+    }
+    // Gleichlautende Stringliterale aus verschiedenen Uebersetzungseinheiten haben nicht unbedingt dieselbe Adresse
+    const auto it = std::find_if(result.begin(), result.end(), [&zaehler](const AllokationsZaehler& z) {
+      return z.bereich != nullptr && zaehler.bereich != nullptr && !strcmp(z.bereich, zaehler.bereich);
+    });
+    if (it == result.end()) {
+      result.push_back(zaehler);
+    } else {
+      it->anzahl += zaehler.anzahl;
+      it->bytes += zaehler.bytes;
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const AllokationsZaehler& a, const AllokationsZaehler& b) { return a.anzahl > b.anzahl; });
+  return result;
+}
+
+const char* BetreteAllokationsBereich(const char* name) {
+  const char* vorheriger = t_bereich;
+  t_bereich = name;
+  return vorheriger;
+}
+
+void VerlasseAllokationsBereich(const char* vorheriger) {
+  t_bereich = vorheriger;
+}
+
+void MeldeAllokationsZaehler() {
+  g_verfuegbar.store(true);
+}
+
+void ZaehleAllokation(size_t bytes) {
+  if (!g_aktiv.load(std::memory_order_relaxed)) {
+    return;
+  }
+  auto& zaehler = ZaehlerFuer(t_bereich);
+  zaehler.anzahl.fetch_add(1, std::memory_order_relaxed);
+  zaehler.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
@@ -0,0 +1,39 @@
+// Copyright 2026 Zusitools
+
+#ifndef ALLOKATIONEN_HPP_
+#define ALLOKATIONEN_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Zaehlt Heap-Allokationen und ordnet sie dem innersten offenen TraceBereich des
+ * allokierenden Threads zu. Gezaehlt wird nur in Programmen, die allokationen_zaehler.cpp
+ * (Ersatz fuer den globalen operator new) mitlinken, also im Benchmark; in der DLL und
+ * in hekto_batch bleibt es beim Setzen des aktuellen Bereichs.
+ */
+
+struct AllokationsZaehler final {
+  const char* bereich;  ///< Name des TraceBereichs, nullptr fuer Allokationen ausserhalb eines Bereichs
+  uint64_t anzahl;
+  uint64_t bytes;
+};
+
+// Setzt alle Zaehler zurueck und beginnt die Zaehlung. Liefert false, falls kein
+// operator-new-Ersatz gelinkt ist. Andere Threads sollten dabei nicht allokieren.
+bool StarteAllokationsZaehlung();
+
+// Beendet die Zaehlung und liefert die Zaehler aller Bereiche mit mindestens einer Allokation,
+// absteigend nach Anzahl sortiert. Bereiche gleichen Namens werden zusammengefasst.
+std::vector<AllokationsZaehler> BeendeAllokationsZaehlung();
+
+// Fuer TraceBereich: setzt den aktuellen Bereich des Threads und liefert den vorherigen.
+const char* BetreteAllokationsBereich(const char* name);
+void VerlasseAllokationsBereich(const char* vorheriger);
+
+// Fuer den operator-new-Ersatz. Darf selbst nicht allokieren.
+void MeldeAllokationsZaehler();
+void ZaehleAllokation(size_t bytes);
+
+#endif  // ALLOKATIONEN_HPP_
@@ -0,0 +1,64 @@
+// Copyright 2026 Zusitools
+
+// Ersetzt die globalen operator new/delete, damit allokationen.hpp die Allokationen zaehlen kann.
+// Wird nur in den Benchmark gelinkt. Ueberausgerichtete Allokationen (std::align_val_t) werden
+// nicht gezaehlt; im Programm gibt es keine.
+
+#include "allokationen.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+const bool kGemeldet = (MeldeAllokationsZaehler(), true);
+
+void* Allokiere(size_t groesse) noexcept {
+  ZaehleAllokation(groesse);
+  return std::malloc(groesse == 0 ? 1 : groesse);
+}
+
+}  // namespace
+
+void* operator new(size_t groesse) {
+  if (void* result = Allokiere(groesse)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t groesse) {
+  return operator new(groesse);
+}
+
+void* operator new(size_t groesse, const std::nothrow_t&) noexcept {
+  return Allokiere(groesse);
+}
+
+void* operator new[](size_t groesse, const std::nothrow_t&) noexcept {
+  return Allokiere(groesse);
+}
+
+void operator delete(void* zeiger) noexcept {
+  std::free(zeiger);
+}
+
+void operator delete[](void* zeiger) noexcept {
+  std::free(zeiger);
+}
+
+void operator delete(void* zeiger, size_t) noexcept {
+  std::free(zeiger);
+}
+
+void operator delete[](void* zeiger, size_t) noexcept {
+  std::free(zeiger);
+}
+
+void operator delete(void* zeiger, const std::nothrow_t&) noexcept {
+  std::free(zeiger);
+}
+
+void operator delete[](void* zeiger, const std::nothrow_t&) noexcept {
+  std::free(zeiger);
+}
@@ -1,31 +1,28 @@
 #!/usr/bin/env python3
 
+# Aufruf: export.py <normal|tunnel|verwittert> <ziel.dds> [<pfad/zu/hekto_textur>]
+# Exportiert die derzeit sichtbaren Ebenen von textur.svg in allen Mip-Stufen und erzeugt daraus
+# mit hekto_textur die DXT3-Textur. Benoetigt Inkscape und pngtopam (netpbm).
+
 import subprocess
 import os
+import sys
+import tempfile
 
-src_path = os.getcwd()
-os.chdir('/tmp')
-
-nvdxt_path = os.path.join(os.getenv('HOME'), '.wine/drive_c/Programme/NVIDIA Corporation/DDS Utilities')
-
-for level, size, brightness in [
-        (0, 256, .80),
-        (1, 128, .80),
-        (2,  64, .80**2),
-        (3,  32, .80**3),
-        (4,  16, .80**4),
-        (5,   8, .80**5),
-        (6,   4, .80**6),
-        (7,   2, .80**7),
-        (8,   1, .80**8),
-    ]:
-    export_filename = f'export_{level:02}.png'
-    subprocess.check_call(['inkscape', '--without-gui', '--export-area-page', f'--export-png={export_filename}', f'--export-width={size}', f'--export-height={size}', os.path.join(src_path, 'textur.svg')])
-    subprocess.check_call(['wine', os.path.join(nvdxt_path, 'nvdxt.exe'), '-dxt3', '-quality_highest', '-nomipmap',
+variante, ziel = sys.argv[1], os.path.abspath(sys.argv[2])
+hekto_textur = sys.argv[3] if len(sys.argv) > 3 else 'hekto_textur'
 
-        # Nur fuer Tunnel-Variante
-        # '-brightness', str(brightness-1), str(brightness-1), str(brightness-1), '0',
+src_path = os.path.dirname(os.path.abspath(__file__))
 
-        '-file', export_filename])
+with tempfile.TemporaryDirectory() as tmp:
+    stufen = []
+    for level in range(9):
+        size = 256 >> level
+        export_filename = os.path.join(tmp, f'export_{level:02}.png')
+        pam_filename = os.path.join(tmp, f'export_{level:02}.pam')
+        subprocess.check_call(['inkscape', '--without-gui', '--export-area-page', f'--export-png={export_filename}', f'--export-width={size}', f'--export-height={size}', os.path.join(src_path, 'textur.svg')])
+        with open(pam_filename, 'wb') as f:
+            subprocess.check_call(['pngtopam', '-alphapam', export_filename], stdout=f)
+        stufen.append(pam_filename)
 
-subprocess.check_call(['wine', os.path.join(nvdxt_path, 'stitch.exe'), 'export'])
+    subprocess.check_call([hekto_textur, f'--{variante}', ziel] + stufen)
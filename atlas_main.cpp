@@ -0,0 +1,252 @@
+// Copyright 2026 Zusitools
+
+#include "bild.hpp"
+#include "dds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Vermisst den Texturatlas beim Bauen und erzeugt daraus textur_atlas.hpp, gegen das
+ * hekto_builder.cpp seine Texturkoordinaten prueft. Erwarteter Aufbau (siehe textur.svg):
+ *  - oben links die Vorderseite, oben rechts die Rueckseite der Tafel
+ *  - rechts ueber die volle Hoehe der Mast
+ *  - darunter zwei Reihen mit den Ziffern 0 5 3 4 und 1 2 6 7 8 (die 9 ist die gedrehte 6)
+ */
+
+namespace {
+
+constexpr double kBezugsgroesse_px = 256;
+constexpr double kToleranz_px = 0.5;
+
+constexpr std::array<std::array<int, 5>, 2> kZiffernAnordnung {{
+  { 0, 5, 3, 4, -1 },
+  { 1, 2, 6, 7, 8 },
+}};
+
+struct Rechteck final {
+  double links;
+  double oben;
+  double rechts;
+  double unten;
+};
+
+struct Atlas final {
+  Rechteck vorderseite;
+  Rechteck rueckseite;
+  Rechteck mast;
+  std::array<Rechteck, 9> ziffern;
+};
+
+struct Lauf final {
+  double anfang;
+  double ende;
+};
+
+/**
+ * Bereiche mit deckung[i] > 0. Die Kanten sind subpixelgenau: ein Randpixel mit halber
+ * Deckung verschiebt die Kante um einen halben Pixel nach innen.
+ */
+std::vector<Lauf> FindeLaeufe(const std::vector<uint8_t>& deckung, double skalierung) {
+  std::vector<Lauf> result;
+  for (size_t i = 0; i < deckung.size(); ) {
+    if (deckung[i] == 0) {
+      ++i;
+      continue;
+    }
+    const size_t anfang = i;
+    while (i < deckung.size() && deckung[i] != 0) {
+      ++i;
+    }
+    result.push_back({ skalierung * (anfang + 1 - deckung[anfang] / 255.0), skalierung * (i - 1 + deckung[i - 1] / 255.0) });
+  }
+  return result;
+}
+
+bool Vermesse(const Bild& bild, Atlas* atlas, std::string* fehler) {
+  const double skalierung_x = kBezugsgroesse_px / bild.breite;
+  const double skalierung_y = kBezugsgroesse_px / bild.hoehe;
+
+  // Mast: Spalten, die in jeder Zeile deckend sind
+  std::vector<uint8_t> mast_spalte(bild.breite);
+  for (int x = 0; x < bild.breite; ++x) {
+    uint8_t deckung = 255;
+    for (int y = 0; y < bild.hoehe; ++y) {
+      deckung = std::min(deckung, bild.Pixel(x, y)[3]);
+    }
+    mast_spalte[x] = deckung;
+  }
+  const auto mast = FindeLaeufe(mast_spalte, skalierung_x);
+  if (mast.size() != 1) {
+    *fehler = "erwartet genau einen Mast ueber die volle Hoehe, gefunden: " + std::to_string(mast.size());
+    return false;
+  }
+  atlas->mast = { mast[0].anfang, 0, mast[0].ende, kBezugsgroesse_px };
+
+  // Maximale Deckung ohne die Mastspalten
+  auto MaxDeckung = [&](int x0, int x1, int y0, int y1) {
+    uint8_t result = 0;
+    for (int y = y0; y < y1; ++y) {
+      for (int x = x0; x < x1; ++x) {
+        if (mast_spalte[x] == 0) {
+          result = std::max(result, bild.Pixel(x, y)[3]);
+        }
+      }
+    }
+    return result;
+  };
+
+  std::vector<uint8_t> zeilen(bild.hoehe);
+  for (int y = 0; y < bild.hoehe; ++y) {
+    zeilen[y] = MaxDeckung(0, bild.breite, y, y + 1);
+  }
+  const auto baender = FindeLaeufe(zeilen, skalierung_y);
+  if (baender.size() != 1 + kZiffernAnordnung.size()) {
+    *fehler = "erwartet ein Band mit den Tafeln und " + std::to_string(kZiffernAnordnung.size())
+      + " Ziffernreihen, gefunden: " + std::to_string(baender.size()) + " Baender";
+    return false;
+  }
+
+  auto Spalten = [&](const Lauf& band) {
+    std::vector<uint8_t> result(bild.breite);
+    const int y0 = static_cast<int>(std::floor(band.anfang / skalierung_y));
+    const int y1 = static_cast<int>(std::ceil(band.ende / skalierung_y));
+    for (int x = 0; x < bild.breite; ++x) {
+      result[x] = MaxDeckung(x, x + 1, y0, y1);
+    }
+    return FindeLaeufe(result, skalierung_x);
+  };
+
+  const auto tafeln = Spalten(baender[0]);
+  if (tafeln.size() != 2) {
+    *fehler = "erwartet Vorder- und Rueckseite nebeneinander, gefunden: " + std::to_string(tafeln.size()) + " Bereiche";
+    return false;
+  }
+  atlas->vorderseite = { tafeln[0].anfang, baender[0].anfang, tafeln[0].ende, baender[0].ende };
+  atlas->rueckseite = { tafeln[1].anfang, baender[0].anfang, tafeln[1].ende, baender[0].ende };
+
+  for (size_t reihe = 0; reihe < kZiffernAnordnung.size(); ++reihe) {
+    const auto& band = baender[1 + reihe];
+    const auto glyphen = Spalten(band);
+    const auto anzahl = static_cast<size_t>(std::count_if(kZiffernAnordnung[reihe].begin(), kZiffernAnordnung[reihe].end(),
+          [](int ziffer) { return ziffer >= 0; }));
+    if (glyphen.size() != anzahl) {
+      *fehler = "Ziffernreihe " + std::to_string(reihe + 1) + ": erwartet " + std::to_string(anzahl)
+        + " Ziffern, gefunden: " + std::to_string(glyphen.size());
+      return false;
+    }
+    for (size_t i = 0; i < anzahl; ++i) {
+      atlas->ziffern[kZiffernAnordnung[reihe][i]] = { glyphen[i].anfang, band.anfang, glyphen[i].ende, band.ende };
+    }
+  }
+  return true;
+}
+
+bool Nahe(const Rechteck& a, const Rechteck& b) {
+  return std::abs(a.links - b.links) <= kToleranz_px && std::abs(a.oben - b.oben) <= kToleranz_px
+    && std::abs(a.rechts - b.rechts) <= kToleranz_px && std::abs(a.unten - b.unten) <= kToleranz_px;
+}
+
+bool Nahe(const Atlas& a, const Atlas& b) {
+  return Nahe(a.vorderseite, b.vorderseite) && Nahe(a.rueckseite, b.rueckseite) && Nahe(a.mast, b.mast)
+    && std::equal(a.ziffern.begin(), a.ziffern.end(), b.ziffern.begin(), [](const auto& x, const auto& y) { return Nahe(x, y); });
+}
+
+void SchreibeRechteck(FILE* fd, const Rechteck& r) {
+  fprintf(fd, "{ %.3ff, %.3ff, %.3ff, %.3ff }", r.links, r.oben, r.rechts, r.unten);
+}
+
+void SchreibeKopfdatei(FILE* fd, const char* quelle, const Atlas& atlas) {
+  fprintf(fd,
+      "// Erzeugt von hekto_atlas aus %s, nicht von Hand bearbeiten.\n"
+      "\n"
+      "#ifndef TEXTUR_ATLAS_HPP_\n"
+      "#define TEXTUR_ATLAS_HPP_\n"
+      "\n"
+      "namespace textur_atlas {\n"
+      "\n"
+      "// Pixelkoordinaten bezogen auf ein 256x256-Bild, Koordinatensystem wie in Gimp.\n"
+      "struct Rechteck final {\n"
+      "  float links;\n"
+      "  float oben;\n"
+      "  float rechts;\n"
+      "  float unten;\n"
+      "};\n"
+      "\n"
+      "constexpr float kToleranz_px = %.1ff;\n"
+      "\n",
+      quelle, kToleranz_px);
+
+  fprintf(fd, "constexpr Rechteck kVorderseite ");
+  SchreibeRechteck(fd, atlas.vorderseite);
+  fprintf(fd, ";  // ganze Tafel\nconstexpr Rechteck kRueckseite ");
+  SchreibeRechteck(fd, atlas.rueckseite);
+  fprintf(fd, ";  // ganze Tafel\nconstexpr Rechteck kMast ");
+  SchreibeRechteck(fd, atlas.mast);
+  fprintf(fd, ";\n\n// Ziffern 0 bis 8, die 9 ist die gedrehte 6. Hoehe = Hoehe der Ziffernreihe.\nconstexpr Rechteck kZiffern[%zu] = {\n",
+      atlas.ziffern.size());
+  for (const auto& ziffer : atlas.ziffern) {
+    fprintf(fd, "  ");
+    SchreibeRechteck(fd, ziffer);
+    fprintf(fd, ",\n");
+  }
+  fprintf(fd,
+      "};\n"
+      "\n"
+      "}  // namespace textur_atlas\n"
+      "\n"
+      "#endif  // TEXTUR_ATLAS_HPP_\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr,
+        "Aufruf: %s <ziel.hpp> <atlas.dds> [<variante.dds> ...]\n"
+        "\n"
+        "Vermisst Tafeln, Mast und Ziffern im Texturatlas und schreibt sie als constexpr-Tabellen.\n"
+        "Weitere Varianten der Textur muessen denselben Aufbau haben.\n",
+        argv[0]);
+    return 1;
+  }
+
+  Atlas atlas {};
+  for (int i = 2; i < argc; ++i) {
+    FILE* fd = fopen(argv[i], "rb");
+    if (fd == nullptr) {
+      fprintf(stderr, "%s: kann nicht geoeffnet werden\n", argv[i]);
+      return 1;
+    }
+    Bild bild;
+    std::string fehler;
+    const bool ok = LiesDds(fd, &bild, &fehler);
+    fclose(fd);
+
+    Atlas vermessen {};
+    if (!ok || !Vermesse(bild, &vermessen, &fehler)) {
+      fprintf(stderr, "%s: %s\n", argv[i], fehler.c_str());
+      return 1;
+    }
+    if (i == 2) {
+      atlas = vermessen;
+    } else if (!Nahe(atlas, vermessen)) {
+      fprintf(stderr, "%s: Aufbau weicht von %s ab\n", argv[i], argv[2]);
+      return 1;
+    }
+  }
+
+  FILE* fd = fopen(argv[1], "w");
+  if (fd == nullptr) {
+    fprintf(stderr, "%s: kann nicht geschrieben werden\n", argv[1]);
+    return 1;
+  }
+  const char* quelle = strrchr(argv[2], '/');
+  SchreibeKopfdatei(fd, quelle != nullptr ? quelle + 1 : argv[2], atlas);
+  return fclose(fd) == 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+// Copyright 2026 Zusitools
+
+#include "ausgabe.hpp"
+
+#include <cstdarg>
+#include <vector>
+
+void Ausgabe::SchreibeFormatiert(const char* format, ...) {
+  char puffer[1024];
+  std::va_list args;
+  va_start(args, format);
+  std::va_list args_kopie;
+  va_copy(args_kopie, args);
+  const int laenge = vsnprintf(puffer, sizeof(puffer), format, args);
+  va_end(args);
+
+  if (laenge < 0) {
+    va_end(args_kopie);
+    return;
+  }
+
+  if (static_cast<size_t>(laenge) < sizeof(puffer)) {
+    Schreibe(puffer, laenge);
+  } else {
+    std::vector<char> gross(laenge + 1);
+    vsnprintf(gross.data(), gross.size(), format, args_kopie);
+    Schreibe(gross.data(), laenge);
+  }
+  va_end(args_kopie);
+}
+
+void DateiAusgabe::Schreibe(const char* daten, size_t laenge) {
+  fwrite(daten, 1, laenge, fd_);
+}
+
+void PufferAusgabe::Schreibe(const char* daten, size_t laenge) {
+  puffer_.append(daten, laenge);
+}
@@ -0,0 +1,65 @@
+// Copyright 2026 Zusitools
+
+#ifndef AUSGABE_HPP_
+#define AUSGABE_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+/**
+ * Ziel, in das eine erzeugte Datei geschrieben wird.
+ */
+class Ausgabe {
+ public:
+  virtual ~Ausgabe() = default;
+
+  virtual void Schreibe(const char* daten, size_t laenge) = 0;
+
+  void Schreibe(const std::string& text) {
+    Schreibe(text.data(), text.size());
+  }
+
+  template <size_t N>
+  void SchreibeLiteral(const char (&text)[N]) {
+    Schreibe(text, N - 1);
+  }
+
+  // Schreibt den mittels printf-Formatstring formatierten Text.
+  void SchreibeFormatiert(const char* format, ...)
+#ifdef __GNUC__
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+};
+
+// Schreibt in eine per fopen geoeffnete Datei.
+class DateiAusgabe final : public Ausgabe {
+ public:
+  explicit DateiAusgabe(FILE* fd) : fd_(fd) { }
+  void Schreibe(const char* daten, size_t laenge) override;
+  using Ausgabe::Schreibe;
+
+ private:
+  FILE* fd_;
+};
+
+// Sammelt die Ausgabe im Speicher.
+class PufferAusgabe final : public Ausgabe {
+ public:
+  PufferAusgabe() = default;
+  // Verwendet den Speicher von `puffer` weiter; der bisherige Inhalt wird verworfen.
+  explicit PufferAusgabe(std::string puffer) : puffer_(std::move(puffer)) { puffer_.clear(); }
+
+  void Schreibe(const char* daten, size_t laenge) override;
+  using Ausgabe::Schreibe;
+
+  const std::string& Inhalt() const { return puffer_; }
+  std::string& Inhalt() { return puffer_; }
+
+ private:
+  std::string puffer_;
+};
+
+#endif  // AUSGABE_HPP_
@@ -0,0 +1,191 @@
+// Copyright 2026 Zusitools
+
+#include "ausgabe_pruefung.hpp"
+
+#include "zahlenformat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct GelesenerVertex final {
+  std::array<double, 3> position {};  ///< in Metern
+  std::array<double, 3> normale {};
+  std::array<double, 4> texturkoordinaten {};  ///< U, V, U2, V2
+};
+
+// Wert des Attributs `name_gleich` (z.B. ` X="`) in `attribute` oder 0, wie in Zusi, falls es fehlt.
+bool LiesAttribut(std::string_view attribute, std::string_view name_gleich, double* result) {
+  const auto pos = attribute.find(name_gleich);
+  if (pos == std::string_view::npos) {
+    *result = 0;
+    return true;
+  }
+  const auto wert = attribute.substr(pos + name_gleich.size());
+  const auto ende = wert.find('"');
+  char puffer[64];
+  if (ende == std::string_view::npos || ende == 0 || ende >= sizeof(puffer)) {
+    return false;
+  }
+  std::memcpy(puffer, wert.data(), ende);
+  puffer[ende] = '\0';
+  char* gelesen_bis;
+  *result = strtod(puffer, &gelesen_bis);
+  return gelesen_bis == puffer + ende && std::isfinite(*result);
+}
+
+// Liest das naechste Tag ab `*pos` und setzt `*pos` dahinter. `attribute` ist alles nach dem Namen.
+bool NaechstesTag(std::string_view text, size_t* pos, std::string_view* name, std::string_view* attribute) {
+  const auto anfang = text.find('<', *pos);
+  if (anfang == std::string_view::npos) {
+    return false;
+  }
+  const auto ende = text.find('>', anfang);
+  if (ende == std::string_view::npos) {
+    return false;
+  }
+  const auto tag = text.substr(anfang + 1, ende - anfang - 1);
+  const auto name_ende = std::min(tag.find_first_of(" /"), tag.size());
+  *name = tag.substr(0, name_ende);
+  *attribute = tag.substr(name_ende);
+  *pos = ende + 1;
+  return true;
+}
+
+std::array<double, 3> Kreuzprodukt(const std::array<double, 3>& a, const std::array<double, 3>& b) {
+  return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+// Normale (nicht normiert) des Dreiecks aus drei Positionen.
+std::array<double, 3> Flaechennormale(const std::array<double, 3>& p1, const std::array<double, 3>& p2,
+    const std::array<double, 3>& p3) {
+  return Kreuzprodukt({ p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] }, { p3[0] - p1[0], p3[1] - p1[1], p3[2] - p1[2] });
+}
+
+double Skalarprodukt(const std::array<double, 3>& a, const std::array<double, 3>& b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+std::array<double, 3> PositionInMeter(const Vertex& vertex) {
+  return {
+    static_cast<double>(vertex.pos_x) / kKoordinateProMeter,
+    static_cast<double>(vertex.pos_y) / kKoordinateProMeter,
+    static_cast<double>(vertex.pos_z) / kKoordinateProMeter,
+  };
+}
+
+}  // namespace
+
+Abweichung Toleranz(Genauigkeit genauigkeit) {
+  // Zuschlag fuer die float-Darstellung der berechneten Werte
+  constexpr double kFloatZuschlag = 1e-7;
+  if (genauigkeit == Genauigkeit::kQuantisiert) {
+    const double schritt = 0.5 / kQuantisierungsSchritte + 0.5e-4 + kFloatZuschlag;
+    return { 0.5 + 1e-9, schritt, schritt };
+  }
+  return { 1e-9, 0.5e-6 + kFloatZuschlag, 0.5e-6 + kFloatZuschlag };
+}
+
+bool PruefeAusgabe(const Mesh& mesh, std::string_view inhalt, Genauigkeit genauigkeit, Abweichung* abweichung,
+    std::string* fehler) {
+  std::vector<GelesenerVertex> vertices;
+  std::vector<std::array<size_t, 3>> faces;
+
+  size_t pos = 0;
+  std::string_view name;
+  std::string_view attribute;
+  while (NaechstesTag(inhalt, &pos, &name, &attribute)) {
+    bool ok = true;
+    if (name == "Vertex") {
+      auto& v = vertices.emplace_back();
+      ok = LiesAttribut(attribute, " U=\"", &v.texturkoordinaten[0]) && LiesAttribut(attribute, " V=\"", &v.texturkoordinaten[1])
+        && LiesAttribut(attribute, " U2=\"", &v.texturkoordinaten[2]) && LiesAttribut(attribute, " V2=\"", &v.texturkoordinaten[3]);
+    } else if (name == "p" || name == "n") {
+      if (vertices.empty()) {
+        *fehler = "<" + std::string(name) + "> ausserhalb eines Vertex";
+        return false;
+      }
+      auto& werte = name == "p" ? vertices.back().position : vertices.back().normale;
+      ok = LiesAttribut(attribute, " X=\"", &werte[0]) && LiesAttribut(attribute, " Y=\"", &werte[1])
+        && LiesAttribut(attribute, " Z=\"", &werte[2]);
+    } else if (name == "Face") {
+      std::array<size_t, 3> indizes;
+      const auto anfang = attribute.find(" i=\"");
+      ok = anfang != std::string_view::npos && sscanf(std::string(attribute.substr(anfang)).c_str(), " i=\"%zu;%zu;%zu\"",
+          &indizes[0], &indizes[1], &indizes[2]) == 3;
+      faces.push_back(indizes);
+    }
+    if (!ok) {
+      *fehler = "ungueltiges Tag <" + std::string(name) + std::string(attribute) + ">";
+      return false;
+    }
+  }
+
+  if (vertices.size() != mesh.vertices.size() || faces.size() != mesh.faces.size()) {
+    *fehler = std::to_string(vertices.size()) + " Vertices und " + std::to_string(faces.size()) + " Faces gelesen, erwartet "
+      + std::to_string(mesh.vertices.size()) + " und " + std::to_string(mesh.faces.size());
+    return false;
+  }
+
+  const auto toleranz = Toleranz(genauigkeit);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    const auto& gelesen = vertices[i];
+    const auto& vertex = mesh.vertices[i];
+    const auto position = PositionInMeter(vertex);
+    const std::array<double, 3> normale { vertex.nor_x, vertex.nor_y, vertex.nor_z };
+    const std::array<double, 4> texturkoordinaten { vertex.u1, vertex.v1, vertex.u2, vertex.v2 };
+
+    Abweichung vertex_abweichung;
+    for (size_t k = 0; k < 3; ++k) {
+      vertex_abweichung.position_mm = std::max(vertex_abweichung.position_mm, 1000 * std::fabs(gelesen.position[k] - position[k]));
+      vertex_abweichung.normale = std::max(vertex_abweichung.normale, std::fabs(gelesen.normale[k] - normale[k]));
+    }
+    for (size_t k = 0; k < 4; ++k) {
+      vertex_abweichung.texturkoordinate = std::max(vertex_abweichung.texturkoordinate,
+          std::fabs(gelesen.texturkoordinaten[k] - texturkoordinaten[k]));
+    }
+
+    abweichung->position_mm = std::max(abweichung->position_mm, vertex_abweichung.position_mm);
+    abweichung->texturkoordinate = std::max(abweichung->texturkoordinate, vertex_abweichung.texturkoordinate);
+    abweichung->normale = std::max(abweichung->normale, vertex_abweichung.normale);
+
+    if (vertex_abweichung.position_mm > toleranz.position_mm || vertex_abweichung.texturkoordinate > toleranz.texturkoordinate
+        || vertex_abweichung.normale > toleranz.normale) {
+      *fehler = "Vertex " + std::to_string(i) + " weicht zu stark ab";
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < faces.size(); ++i) {
+    const auto& face = mesh.faces[i];
+    const auto& gelesen = faces[i];
+    if (gelesen[0] != face.i1 || gelesen[1] != face.i2 || gelesen[2] != face.i3) {
+      *fehler = "Face " + std::to_string(i) + " hat andere Indizes";
+      return false;
+    }
+    if (std::max({ gelesen[0], gelesen[1], gelesen[2] }) >= vertices.size()) {
+      *fehler = "Face " + std::to_string(i) + " verweist auf einen nicht vorhandenen Vertex";
+      return false;
+    }
+
+    // Bereits berechnete entartete Dreiecke (z.B. aus der Faecher-Triangulierung) bleiben unsichtbar.
+    const auto normale = Flaechennormale(PositionInMeter(mesh.vertices[face.i1]),
+        PositionInMeter(mesh.vertices[face.i2]), PositionInMeter(mesh.vertices[face.i3]));
+    if (Skalarprodukt(normale, normale) == 0) {
+      continue;
+    }
+    const auto normale_gelesen = Flaechennormale(vertices[gelesen[0]].position, vertices[gelesen[1]].position,
+        vertices[gelesen[2]].position);
+    if (!(Skalarprodukt(normale, normale_gelesen) > 0)) {
+      *fehler = "Face " + std::to_string(i) + " ist entartet oder hat den Umlaufsinn gewechselt";
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,39 @@
+// Copyright 2026 Zusitools
+
+#ifndef AUSGABE_PRUEFUNG_HPP_
+#define AUSGABE_PRUEFUNG_HPP_
+
+#include "hekto_builder.hpp"
+#include "mesh.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * Prueft, dass die Ausgabe eines Subsets so dargestellt wird wie das berechnete Mesh: Die Vertices
+ * werden aus dem Text zurueckgelesen, wie Zusi sie liest (fehlende Attribute sind 0), und mit dem
+ * Mesh verglichen. Damit laesst sich belegen, dass eine geringere Genauigkeit die Darstellung nicht aendert.
+ */
+
+// Groesste Abweichung zwischen gelesenen und berechneten Werten.
+struct Abweichung final {
+  double position_mm = 0;
+  double texturkoordinate = 0;
+  double normale = 0;
+};
+
+// Zulaessige Abweichung je Genauigkeit: halber Rundungsschritt zuzueglich der Rundung der Textdarstellung.
+// Bei Genauigkeit::kQuantisiert hoechstens 0.5 mm und 1/16 Pixel eines 256 Pixel breiten Atlas.
+Abweichung Toleranz(Genauigkeit genauigkeit);
+
+/**
+ * Liest Vertices und Faces aus `inhalt` (Ausgabe von SubsetBuilder::WriteInhalt) und vergleicht sie mit `mesh`.
+ * Schlaegt fehl, wenn Anzahl oder Indizes nicht stimmen, eine Abweichung die Toleranz ueberschreitet oder
+ * ein Dreieck durch die Rundung entartet oder seinen Umlaufsinn aendert. Die groesste Abweichung wird in
+ * `abweichung` eingetragen, sofern sie dort groesser ist.
+ */
+bool PruefeAusgabe(const Mesh& mesh, std::string_view inhalt, Genauigkeit genauigkeit, Abweichung* abweichung,
+    std::string* fehler);
+
+#endif  // AUSGABE_PRUEFUNG_HPP_
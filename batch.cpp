@@ -0,0 +1,426 @@
+// Copyright 2026 Zusitools
+
+#include "batch.hpp"
+
+#include "ausgabe.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+std::string Dateiname(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
+  char result[256];
+  snprintf(result, sizeof(result),
+      "Hekto%s%s%s%s_%s%d_%d%s.ls3",
+      (bauparameter.mast == Mast::kMitMast ? "_Mast" : ""),
+      (bauparameter.beidseitig == Beidseitig::kBeidseitig ? "_beids" : ""),
+      (bauparameter.groesse == Groesse::kKlein ? "_klein" : ""),
+      (bauparameter.rueckstrahlend == Rueckstrahlend::kYes ? "_rueckstrahlend" : ""),
+      (kilometrierung.istNegativ() ? "-" : ""),
+      std::abs(kilometrierung.km),
+      std::abs(kilometrierung.hm),
+      (ueberlaenge_hm.has_value() ? (std::string("_") + std::to_string(*ueberlaenge_hm)).c_str() : ""));
+  return result;
+}
+
+std::string DetailstufenDateiname(const std::string& dateiname, Detailstufe detailstufe) {
+  const auto punkt = dateiname.rfind('.');
+  return dateiname.substr(0, punkt) + "_LOD" + std::to_string(static_cast<int>(detailstufe))
+    + (punkt == std::string::npos ? "" : dateiname.substr(punkt));
+}
+
+StandardDateiSchreiber::StandardDateiSchreiber(std::string zielverzeichnis) : zielverzeichnis_(std::move(zielverzeichnis)) { }
+
+bool StandardDateiSchreiber::SchreibeDatei(const std::string& pfad, const std::string& inhalt) {
+  const auto voller_pfad = std::filesystem::path(zielverzeichnis_) / pfad;
+
+  std::error_code ec;
+  std::filesystem::remove(voller_pfad, ec);
+  FILE* fd = fopen(voller_pfad.string().c_str(), "wb");
+  if (fd == nullptr) {
+    // Verzeichnis erst bei Bedarf anlegen, der Normalfall kommt ohne stat() aus.
+    std::filesystem::create_directories(voller_pfad.parent_path(), ec);
+    fd = fopen(voller_pfad.string().c_str(), "wb");
+    if (fd == nullptr) {
+      return false;
+    }
+  }
+
+  const bool ok = fwrite(inhalt.data(), 1, inhalt.size(), fd) == inhalt.size();
+  return (fclose(fd) == 0) && ok;
+}
+
+// Zwei 64-Bit-Hashes nach dem FNV-1a-Schema mit verschiedenen Startwerten und Multiplikatoren.
+std::pair<uint64_t, uint64_t> InhaltsHash(std::string_view inhalt) {
+  uint64_t h1 = 0xcbf29ce484222325ull;
+  uint64_t h2 = 0x84222325cbf29ce4ull;
+  for (const char c : inhalt) {
+    h1 = (h1 ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    h2 = (h2 ^ static_cast<unsigned char>(c)) * 0x100000000000067ull;
+  }
+  return { h1, h2 ^ inhalt.size() };
+}
+
+DeduplizierenderDateiSchreiber::DeduplizierenderDateiSchreiber(std::string zielverzeichnis, DateiSchreiber* basis,
+    HardlinkRueckfall rueckfall)
+  : zielverzeichnis_(std::move(zielverzeichnis)), basis_(basis), rueckfall_(rueckfall) { }
+
+bool DeduplizierenderDateiSchreiber::SchreibeDatei(const std::string& pfad, const std::string& inhalt) {
+  const auto hash = InhaltsHash(inhalt);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto [it, neu] = originale_.try_emplace(hash, pfad);
+    if (!neu) {
+      if (it->second != pfad) {
+        verknuepfungen_.push_back({ it->second, pfad, inhalt.size() });
+        ++anzahl_verknuepft_;
+        eingesparte_bytes_ += inhalt.size();
+      }
+      return true;
+    }
+  }
+
+  // Der Basis-Schreiber ersetzt eine vorhandene Datei, statt sie an Ort und Stelle zu ueberschreiben.
+  return basis_->SchreibeDatei(pfad, inhalt);
+}
+
+bool DeduplizierenderDateiSchreiber::Verknuepfe(const Verknuepfung& verknuepfung) {
+  const auto ziel = std::filesystem::path(zielverzeichnis_);
+  const auto original = ziel / verknuepfung.original;
+  const auto pfad = ziel / verknuepfung.pfad;
+
+  // Wie beim Schreiben wird eine vorhandene Datei ersetzt.
+  std::error_code ec;
+  std::filesystem::remove(pfad, ec);
+  std::filesystem::create_hard_link(original, pfad, ec);
+  if (ec == std::errc::no_such_file_or_directory) {
+    std::filesystem::create_directories(pfad.parent_path(), ec);
+    std::filesystem::create_hard_link(original, pfad, ec);
+  }
+  if (!ec) {
+    return true;
+  }
+  if (rueckfall_ == HardlinkRueckfall::kKopieren) {
+    return std::filesystem::copy_file(original, pfad, std::filesystem::copy_options::overwrite_existing, ec) && !ec;
+  }
+  return false;
+}
+
+bool DeduplizierenderDateiSchreiber::Abschliessen() {
+  const bool ok = basis_->Abschliessen();
+
+  // Ein nachtraeglich fehlgeschlagenes Original kann unvollstaendig auf der Platte liegen
+  std::unordered_set<std::string> fehlerhafte_originale;
+  for (auto& fehler : basis_->NachtraeglicheFehler()) {
+    fehlerhafte_originale.insert(std::move(fehler.pfad));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& verknuepfung : verknuepfungen_) {
+    if (fehlerhafte_originale.count(verknuepfung.original) != 0 || !Verknuepfe(verknuepfung)) {
+      fehlgeschlagen_.push_back({ verknuepfung.pfad, verknuepfung.groesse });
+    }
+  }
+  verknuepfungen_.clear();
+  return ok;
+}
+
+std::vector<SchreibFehler> DeduplizierenderDateiSchreiber::NachtraeglicheFehler() const {
+  auto result = basis_->NachtraeglicheFehler();
+  std::lock_guard<std::mutex> lock(mutex_);
+  result.insert(result.end(), fehlgeschlagen_.begin(), fehlgeschlagen_.end());
+  return result;
+}
+
+void ErfasseNachtraeglicheFehler(const DateiSchreiber& schreiber, BatchStatistik* statistik) {
+  for (const auto& fehler : schreiber.NachtraeglicheFehler()) {
+    fprintf(stderr, "%s: Schreiben fehlgeschlagen\n", fehler.pfad.c_str());
+    ++statistik->anzahl_fehler;
+    --statistik->anzahl_dateien;
+    statistik->anzahl_bytes -= fehler.groesse;
+  }
+}
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+// Wiederverwendbare Ausgabepuffer, damit im eingeschwungenen Zustand keine Allokationen noetig sind.
+class PufferPool final {
+ public:
+  std::string Hole() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frei_.empty()) {
+      return {};
+    }
+    auto result = std::move(frei_.back());
+    frei_.pop_back();
+    return result;
+  }
+
+  void GibZurueck(std::string puffer) {
+    puffer.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    frei_.push_back(std::move(puffer));
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> frei_;
+};
+
+struct SchreibAuftrag final {
+  const std::string* pfad;
+  std::string inhalt;
+};
+
+// Begrenzte Warteschlange zwischen Erzeugern und Schreibern.
+// Ist sie voll, warten die Erzeuger (Gegendruck), ist sie leer, die Schreiber.
+class Warteschlange final {
+ public:
+  explicit Warteschlange(size_t kapazitaet) : kapazitaet_(std::max<size_t>(kapazitaet, 1)) { }
+
+  void Push(SchreibAuftrag auftrag) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (eintraege_.size() >= kapazitaet_) {
+      ++anzahl_gestaut_;
+      TraceBereich bereich("Warten (Warteschlange voll)");
+      const auto start = Uhr::now();
+      nicht_voll_.wait(lock, [this]() { return eintraege_.size() < kapazitaet_; });
+      wartezeit_erzeuger_ += Uhr::now() - start;
+    }
+    eintraege_.push_back(std::move(auftrag));
+    summe_tiefe_ += eintraege_.size();
+    ++anzahl_push_;
+    max_tiefe_ = std::max(max_tiefe_, eintraege_.size());
+    lock.unlock();
+    nicht_leer_.notify_one();
+  }
+
+  // Gibt false zurueck, wenn die Warteschlange geschlossen und leer ist.
+  bool Pop(SchreibAuftrag* auftrag) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (eintraege_.empty() && !geschlossen_) {
+      TraceBereich bereich("Warten (Warteschlange leer)");
+      const auto start = Uhr::now();
+      nicht_leer_.wait(lock, [this]() { return !eintraege_.empty() || geschlossen_; });
+      wartezeit_schreiber_ += Uhr::now() - start;
+    }
+    if (eintraege_.empty()) {
+      return false;
+    }
+    *auftrag = std::move(eintraege_.front());
+    eintraege_.pop_front();
+    lock.unlock();
+    nicht_voll_.notify_one();
+    return true;
+  }
+
+  void Schliesse() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      geschlossen_ = true;
+    }
+    nicht_leer_.notify_all();
+  }
+
+  void TrageStatistikEin(BatchStatistik* statistik) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistik->max_warteschlange_tiefe = max_tiefe_;
+    statistik->mittlere_warteschlange_tiefe = anzahl_push_ == 0 ? 0 : static_cast<double>(summe_tiefe_) / anzahl_push_;
+    statistik->anzahl_gestaute_erzeuger = anzahl_gestaut_;
+    statistik->wartezeit_erzeuger = wartezeit_erzeuger_;
+    statistik->wartezeit_schreiber = wartezeit_schreiber_;
+  }
+
+ private:
+  const size_t kapazitaet_;
+  std::mutex mutex_;
+  std::condition_variable nicht_voll_;
+  std::condition_variable nicht_leer_;
+  std::deque<SchreibAuftrag> eintraege_;
+  bool geschlossen_ = false;
+
+  size_t max_tiefe_ = 0;
+  uint64_t summe_tiefe_ = 0;
+  uint64_t anzahl_push_ = 0;
+  size_t anzahl_gestaut_ = 0;
+  std::chrono::nanoseconds wartezeit_erzeuger_ {};
+  std::chrono::nanoseconds wartezeit_schreiber_ {};
+};
+
+// Auftragsliste eines Erzeugers. Der Besitzer arbeitet von vorne ab (aufeinanderfolgende
+// Kilometerwerte profitieren vom Ziffern-Cache), andere Erzeuger stehlen von hinten.
+class AuftragsDeque final {
+ public:
+  void Fuelle(size_t von, size_t bis) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = von; i < bis; ++i) {
+      indizes_.push_back(i);
+    }
+  }
+
+  std::optional<size_t> NimmVorne() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indizes_.empty()) {
+      return std::nullopt;
+    }
+    const auto result = indizes_.front();
+    indizes_.pop_front();
+    return result;
+  }
+
+  std::optional<size_t> StiehlHinten() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indizes_.empty()) {
+      return std::nullopt;
+    }
+    const auto result = indizes_.back();
+    indizes_.pop_back();
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<size_t> indizes_;
+};
+
+}  // namespace
+
+BatchStatistik FuehreBatchAus(const std::vector<BatchAuftrag>& auftraege, DateiSchreiber* schreiber, const BatchOptionen& optionen) {
+  const auto start = Uhr::now();
+
+  const size_t anzahl_erzeuger = std::max<size_t>(1,
+      optionen.anzahl_erzeuger != 0 ? optionen.anzahl_erzeuger : std::thread::hardware_concurrency());
+  const size_t anzahl_schreiber = std::max<size_t>(1, optionen.anzahl_schreiber);
+
+  PufferPool pool;
+  Warteschlange warteschlange(optionen.warteschlange_kapazitaet);
+
+  std::vector<AuftragsDeque> deques(anzahl_erzeuger);
+  for (size_t i = 0; i < anzahl_erzeuger; ++i) {
+    deques[i].Fuelle(auftraege.size() * i / anzahl_erzeuger, auftraege.size() * (i + 1) / anzahl_erzeuger);
+  }
+
+  std::atomic<size_t> anzahl_gestohlen { 0 };
+  std::atomic<size_t> anzahl_dateien { 0 };
+  std::atomic<size_t> anzahl_fehler { 0 };
+  std::atomic<uint64_t> anzahl_bytes { 0 };
+
+  auto Erzeuger = [&](size_t nr) {
+    BenenneTraceThread(("Erzeuger " + std::to_string(nr + 1)).c_str());
+    std::vector<PufferAusgabe> ausgaben;
+    std::vector<TexturVariante> varianten;
+    std::vector<MeshFehler> mesh_fehler;
+
+    auto NaechsterAuftrag = [&]() -> std::optional<size_t> {
+      if (auto result = deques[nr].NimmVorne()) {
+        return result;
+      }
+      for (size_t j = 1; j < anzahl_erzeuger; ++j) {
+        if (auto result = deques[(nr + j) % anzahl_erzeuger].StiehlHinten()) {
+          ++anzahl_gestohlen;
+          return result;
+        }
+      }
+      return std::nullopt;
+    };
+
+    while (const auto idx = NaechsterAuftrag()) {
+      const auto& auftrag = auftraege[*idx];
+      TraceBereich bereich("Tafel", auftrag.ziele.empty() ? nullptr : auftrag.ziele.front().pfad.c_str());
+
+      ausgaben.clear();
+      for (size_t i = 0; i < auftrag.ziele.size(); ++i) {
+        ausgaben.emplace_back(pool.Hole());
+      }
+      varianten.clear();
+      for (size_t i = 0; i < auftrag.ziele.size(); ++i) {
+        varianten.push_back({ auftrag.ziele[i].textur, auftrag.ziele[i].rueckstrahlend, &ausgaben[i] });
+      }
+
+      if (auftrag.detailstufen.empty()) {
+        HektoBuilder::BuildVarianten(varianten, auftrag.bauparameter, auftrag.kilometrierung, auftrag.ueberlaenge_hm,
+            optionen.geometrie_pruefen ? &mesh_fehler : nullptr);
+        if (!mesh_fehler.empty()) {
+          fprintf(stderr, "%s: %s (%zu Fehler)\n", auftrag.ziele.empty() ? "" : auftrag.ziele.front().pfad.c_str(),
+              Beschreibung(mesh_fehler.front()).c_str(), mesh_fehler.size());
+          anzahl_fehler += auftrag.ziele.size();
+          for (auto& ausgabe : ausgaben) {
+            pool.GibZurueck(std::move(ausgabe.Inhalt()));
+          }
+          continue;
+        }
+      } else {
+        for (auto& ausgabe : ausgaben) {
+          HektoBuilder::BuildVerknuepfung(&ausgabe, auftrag.bauparameter, auftrag.detailstufen);
+        }
+      }
+
+      for (size_t i = 0; i < auftrag.ziele.size(); ++i) {
+        warteschlange.Push({ &auftrag.ziele[i].pfad, std::move(ausgaben[i].Inhalt()) });
+      }
+    }
+  };
+
+  auto Schreiber = [&](size_t nr) {
+    BenenneTraceThread(("Schreiber " + std::to_string(nr + 1)).c_str());
+    SchreibAuftrag auftrag;
+    while (warteschlange.Pop(&auftrag)) {
+      TraceBereich bereich("Schreiben", auftrag.pfad->c_str());
+      if (schreiber->SchreibeDatei(*auftrag.pfad, auftrag.inhalt)) {
+        ++anzahl_dateien;
+        anzahl_bytes += auftrag.inhalt.size();
+      } else {
+        fprintf(stderr, "%s: Schreiben fehlgeschlagen\n", auftrag.pfad->c_str());
+        ++anzahl_fehler;
+      }
+      pool.GibZurueck(std::move(auftrag.inhalt));
+    }
+  };
+
+  std::vector<std::thread> schreiber_threads;
+  for (size_t i = 0; i < anzahl_schreiber; ++i) {
+    schreiber_threads.emplace_back(Schreiber, i);
+  }
+
+  std::vector<std::thread> erzeuger_threads;
+  for (size_t i = 0; i < anzahl_erzeuger; ++i) {
+    erzeuger_threads.emplace_back(Erzeuger, i);
+  }
+  for (auto& thread : erzeuger_threads) {
+    thread.join();
+  }
+
+  warteschlange.Schliesse();
+  for (auto& thread : schreiber_threads) {
+    thread.join();
+  }
+
+  BenenneTraceThread("Hauptthread");
+  TraceBereich abschliessen_bereich("Abschliessen");
+  if (!schreiber->Abschliessen()) {
+    ++anzahl_fehler;
+  }
+  abschliessen_bereich.Beende();
+
+  BatchStatistik result;
+  warteschlange.TrageStatistikEin(&result);
+  result.anzahl_dateien = anzahl_dateien;
+  result.anzahl_fehler = anzahl_fehler;
+  result.anzahl_bytes = anzahl_bytes;
+  result.anzahl_gestohlene_auftraege = anzahl_gestohlen;
+  ErfasseNachtraeglicheFehler(*schreiber, &result);
+  result.gesamtdauer = Uhr::now() - start;
+  return result;
+}
@@ -0,0 +1,180 @@
+// Copyright 2026 Zusitools
+
+#ifndef BATCH_HPP_
+#define BATCH_HPP_
+
+#include "hekto_builder.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Dateiname (ohne Verzeichnis) einer Tafel, wie ihn auch die DLL vergibt.
+ */
+std::string Dateiname(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm);
+
+/**
+ * Dateiname der Geometrie einer Detailstufe zu `dateiname` (Endung .ls3), z.B. Hekto_1_2_LOD1.ls3.
+ */
+std::string DetailstufenDateiname(const std::string& dateiname, Detailstufe detailstufe);
+
+/**
+ * 128-Bit-Hash eines Dateiinhalts zum Erkennen identischer Dateien (kein kryptographischer Hash).
+ */
+std::pair<uint64_t, uint64_t> InhaltsHash(std::string_view inhalt);
+
+/**
+ * Eine der Dateien, die fuer einen Batch-Auftrag geschrieben werden.
+ */
+struct BatchZiel final {
+  TexturDatei textur;
+  Rueckstrahlend rueckstrahlend;
+  std::string pfad;  ///< relativ zum Zielverzeichnis des DateiSchreibers
+};
+
+/**
+ * Eine Tafel, die in eine oder mehrere Textur-Varianten geschrieben wird.
+ */
+struct BatchAuftrag final {
+  BauParameter bauparameter;  ///< textur und rueckstrahlend werden durch die Ziele festgelegt
+  Kilometrierung kilometrierung;
+  std::optional<int> ueberlaenge_hm;
+  std::vector<BatchZiel> ziele;
+  // Falls nicht leer, wird statt der Geometrie eine Verknuepfungsdatei auf diese Detailstufen geschrieben,
+  // siehe HektoBuilder::BuildVerknuepfung. Die Dateinamen gelten fuer alle Ziele.
+  std::vector<DetailstufenDatei> detailstufen;
+};
+
+/**
+ * Eine Datei, deren Schreiben erst fehlgeschlagen ist, nachdem SchreibeDatei() true geliefert hatte.
+ */
+struct SchreibFehler final {
+  std::string pfad;  ///< wie an SchreibeDatei() uebergeben
+  size_t groesse;
+};
+
+/**
+ * Schreibstufe der Batch-Pipeline. Implementierungen muessen threadsicher sein,
+ * wenn mehrere Schreiber-Threads verwendet werden.
+ */
+class DateiSchreiber {
+ public:
+  virtual ~DateiSchreiber() = default;
+
+  // Schreibt `inhalt` in die Datei `pfad`. Gibt false zurueck, falls das fehlschlaegt.
+  // Eine vorhandene Datei wird ersetzt, nicht an Ort und Stelle ueberschrieben: Sie kann aus einem
+  // frueheren Lauf mit --hardlinks noch mit anderen Dateien verknuepft sein.
+  virtual bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) = 0;
+
+  // Wird aufgerufen, nachdem alle Dateien uebergeben wurden.
+  // Implementierungen, die Schreibvorgaenge sammeln, muessen diese hier abschliessen.
+  virtual bool Abschliessen() { return true; }
+
+  // Dateien sammelnder Schreiber, die nach der Rueckkehr von SchreibeDatei() fehlgeschlagen sind.
+  // Vollstaendig erst nach Abschliessen(); jede Datei zaehlt als eigener Fehler.
+  virtual std::vector<SchreibFehler> NachtraeglicheFehler() const { return {}; }
+};
+
+/**
+ * Schreibt jede Datei per fopen/fwrite/fclose unterhalb eines Zielverzeichnisses,
+ * nachdem eine vorhandene Datei entfernt wurde. Fehlende Verzeichnisse werden angelegt.
+ */
+class StandardDateiSchreiber final : public DateiSchreiber {
+ public:
+  explicit StandardDateiSchreiber(std::string zielverzeichnis);
+  bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) override;
+
+ private:
+  std::string zielverzeichnis_;
+};
+
+enum class HardlinkRueckfall {
+  kKopieren,  ///< Datei kopieren, falls das Dateisystem keine Hardlinks unterstuetzt
+  kKeiner,  ///< als Fehler melden
+};
+
+/**
+ * Schreibt jeden Inhalt nur einmal ueber `basis`. Weitere Dateien mit identischem Inhalt
+ * werden in Abschliessen() als Hardlinks auf die erste Datei angelegt, damit das Original
+ * auch bei sammelnden Schreibern sicher schon existiert.
+ * Inhalte werden ueber einen 128-Bit-Hash verglichen.
+ */
+class DeduplizierenderDateiSchreiber final : public DateiSchreiber {
+ public:
+  DeduplizierenderDateiSchreiber(std::string zielverzeichnis, DateiSchreiber* basis, HardlinkRueckfall rueckfall);
+
+  bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) override;
+  bool Abschliessen() override;
+  std::vector<SchreibFehler> NachtraeglicheFehler() const override;
+
+  size_t AnzahlVerknuepft() const { return anzahl_verknuepft_; }
+  uint64_t EingesparteBytes() const { return eingesparte_bytes_; }
+
+ private:
+  struct Hash final {
+    size_t operator()(const std::pair<uint64_t, uint64_t>& h) const { return static_cast<size_t>(h.first); }
+  };
+
+  struct Verknuepfung final {
+    std::string original;  ///< relativ zum Zielverzeichnis
+    std::string pfad;
+    size_t groesse;
+  };
+
+  bool Verknuepfe(const Verknuepfung& verknuepfung);
+
+  const std::string zielverzeichnis_;
+  DateiSchreiber* const basis_;
+  const HardlinkRueckfall rueckfall_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::pair<uint64_t, uint64_t>, std::string, Hash> originale_;
+  std::vector<Verknuepfung> verknuepfungen_;
+  std::vector<SchreibFehler> fehlgeschlagen_;  ///< nicht angelegte Verknuepfungen
+  size_t anzahl_verknuepft_ = 0;
+  uint64_t eingesparte_bytes_ = 0;
+};
+
+struct BatchOptionen final {
+  size_t anzahl_erzeuger = 0;  ///< Threads, die Tafeln erzeugen; 0 = Anzahl Prozessorkerne
+  size_t anzahl_schreiber = 1;  ///< Threads, die Dateien schreiben
+  size_t warteschlange_kapazitaet = 256;  ///< Maximale Anzahl fertiger, noch nicht geschriebener Dateien
+  bool geometrie_pruefen = false;  ///< Geometrie jeder Tafel mit ValidateMesh() pruefen, fehlerhafte nicht schreiben
+};
+
+struct BatchStatistik final {
+  size_t anzahl_dateien = 0;
+  size_t anzahl_fehler = 0;
+  uint64_t anzahl_bytes = 0;
+
+  size_t max_warteschlange_tiefe = 0;
+  double mittlere_warteschlange_tiefe = 0;  ///< gemittelt ueber alle Einfuegevorgaenge
+
+  size_t anzahl_gestaute_erzeuger = 0;  ///< Wie oft ein Erzeuger auf eine volle Warteschlange warten musste
+  std::chrono::nanoseconds wartezeit_erzeuger {};  ///< Summe ueber alle Erzeuger
+  std::chrono::nanoseconds wartezeit_schreiber {};  ///< Summe ueber alle Schreiber (leere Warteschlange)
+  size_t anzahl_gestohlene_auftraege = 0;
+
+  std::chrono::nanoseconds gesamtdauer {};
+};
+
+// Nach schreiber->Abschliessen(): meldet jede nachtraeglich fehlgeschlagene Datei auf stderr und
+// zaehlt sie in `statistik` als Fehler statt als geschriebene Datei.
+void ErfasseNachtraeglicheFehler(const DateiSchreiber& schreiber, BatchStatistik* statistik);
+
+/**
+ * Erzeugt alle Auftraege in einer Pipeline: Erzeuger-Threads mit Work-Stealing bauen und
+ * serialisieren Tafeln in wiederverwendete Puffer, Schreiber-Threads leeren eine begrenzte
+ * Warteschlange in den DateiSchreiber. So ueberlappen Rechenzeit und Dateisystem-Latenz.
+ */
+BatchStatistik FuehreBatchAus(const std::vector<BatchAuftrag>& auftraege, DateiSchreiber* schreiber, const BatchOptionen& optionen);
+
+#endif  // BATCH_HPP_
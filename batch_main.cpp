@@ -0,0 +1,685 @@
+// Copyright 2026 Zusitools
+
+#include "batch.hpp"
+#include "hekto_builder.hpp"
+#include "sammeldatei.hpp"
+#include "shard.hpp"
+#include "strecke.hpp"
+#include "tafel_index.hpp"
+#include "trace.hpp"
+#include "vertex_cache.hpp"
+#ifdef HEKTO_IO_URING
+#include "io_uring_schreiber.hpp"
+#endif
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+void Hilfe(const char* programm) {
+  fprintf(stderr,
+      "Aufruf: %s [Optionen] <zielverzeichnis>\n"
+      "\n"
+      "Erzeugt Hektometertafeln fuer einen Bereich von Kilometrierungswerten.\n"
+      "\n"
+      "Bereich:\n"
+      "  --von <m>                 erster Kilometrierungswert in Metern (Standard: 0)\n"
+      "  --bis <m>                 letzter Kilometrierungswert in Metern, inklusive (Standard: 10000)\n"
+      "                            (--von und --bis hoechstens +/-999949, d.h. km 999,9)\n"
+      "  --abstand <m>             Abstand der Tafeln in Metern (Standard: 100, mit --strecke 200)\n"
+      "  --ueberlaenge <km>,<hm>   Ueberlaengen-Modus mit der angegebenen Basis-Kilometrierung\n"
+      "  --platzierung <datei>     statt eines Bereichs platzierte Tafeln lesen und pro Streckenabschnitt\n"
+      "                            in einer Sammeldatei zusammenfassen. Eine Tafel pro Zeile:\n"
+      "                            <abschnitt> <x> <y> <z> <richtung> <kilometrierung>\n"
+      "                            (Meter relativ zum Ursprung des Abschnitts, Richtung im Bogenmass)\n"
+      "  --strecke <datei.st3>     Standorte aus einer Zusi-Streckendatei bestimmen und pro Kachel von\n"
+      "                            2 km Kantenlaenge in einer Sammeldatei Kachel_<x>_<y>.ls3 zusammenfassen\n"
+      "  --seitenabstand <m>       Abstand von der Gleismitte, positiv rechts in Normrichtung (Standard: 3)\n"
+      "  --verknuepft              mit --platzierung oder --strecke: statt Sammeldateien die Einzeldateien\n"
+      "                            der Tafeln erzeugen und pro Abschnitt eine Platzierungsdatei, die sie\n"
+      "                            an ihrer Position verknuepft\n"
+      "\n"
+      "Bauparameter:\n"
+      "  --klein --mast --beidseitig --niedrig --rueckstrahlend\n"
+      "  --ankerpunkt              Ankerpunkte in die Tafeldateien schreiben (nicht in Sammeldateien)\n"
+      "  --triangulierung-minimal  Vorderseite mit minimaler Anzahl Dreiecke triangulieren\n"
+      "  --vertex-cache            Faces und Vertices fuer den Vertex-Cache umordnen\n"
+      "  --kompakt                 Vertex-Attribute mit dem Wert 0 weglassen und Nullen am Ende der\n"
+      "                            Nachkommastellen kuerzen (etwa ein Viertel kleinere Dateien)\n"
+      "  --quantisiert             Positionen auf Millimeter, Texturkoordinaten und Normalen auf 1/4096 runden\n"
+      "  --texturen <liste>        kommagetrennt aus standard,tunnel,verwittert_1,verwittert_2.\n"
+      "                            Bei mehreren Texturen je ein Unterverzeichnis pro Textur.\n"
+      "  --lod                     zusaetzlich grobe Detailstufen erzeugen; die Tafeldatei verknuepft dann\n"
+      "                            die Dateien der Detailstufen (_LOD0, _LOD1, mit Mast auch _LOD2)\n"
+      "  --lod-pfad <zusi-pfad>    Zusi-Pfad des Zielverzeichnisses fuer die Verknuepfungen der Detailstufen\n"
+      "                            und der Platzierungsdateien\n"
+      "                            (Standard: Dateiname relativ zur verknuepfenden Datei)\n"
+      "\n"
+      "Pipeline:\n"
+      "  --erzeuger <n>            Threads zum Erzeugen (Standard: Anzahl Prozessorkerne)\n"
+      "  --schreiber <n>           Threads zum Schreiben (Standard: 1)\n"
+      "  --warteschlange <n>       Maximale Anzahl ungeschriebener Dateien (Standard: 256)\n"
+      "  --hardlinks               Dateien mit identischem Inhalt nur einmal schreiben, sonst Hardlinks anlegen\n"
+      "  --hardlink-rueckfall <r>  kopieren (Standard) oder keiner, falls keine Hardlinks moeglich sind\n"
+      "  --index                   Index der erzeugten Einzeldateien (hekto_index.bin im Zielverzeichnis) nutzen:\n"
+      "                            laut Index unveraenderte Dateien ueberspringen, neue Dateien eintragen\n"
+      "  --pruefen                 Geometrie jeder Einzeldatei pruefen (endliche Werte, Indizes, Texturkoordinaten,\n"
+      "                            Umlaufsinn) und fehlerhafte Tafeln als Fehler melden statt sie zu schreiben\n"
+      "  --trace <datei>           Zeitleiste aller Threads und Stufen als Chrome-Trace-JSON schreiben\n"
+#ifdef HEKTO_IO_URING
+      "  --io-uring                Dateien stapelweise per io_uring schreiben\n"
+#endif
+      "\n"
+      "Verteilung auf mehrere Prozesse oder Rechner:\n"
+      "  --shard <i>/<n>           nur den i-ten von n Teilen erzeugen (Tafeln bzw. mit --platzierung/--strecke Abschnitte)\n"
+      "  --shard-modus <m>         bereich (Standard, zusammenhaengende Teile) oder hash (nach Dateiname bzw. Abschnitt)\n"
+      "  --manifest <datei>        Pfad, Groesse und Hash aller geschriebenen Dateien in ein Manifest schreiben\n"
+      "  --buendel <datei>         Dateien statt ins Zielverzeichnis in eine Buendeldatei schreiben (erfordert --manifest)\n"
+      "  --zusammenfuehren <ziel> <manifest>...\n"
+      "                            Manifeste aller Shards pruefen und die Dateien im Zielverzeichnis zusammenfuehren;\n"
+      "                            mit --manifest wird das Gesamtmanifest geschrieben\n"
+      ,
+      programm);
+}
+
+struct TexturName final {
+  TexturDatei textur;
+  const char* name;
+};
+
+constexpr TexturName kTexturNamen[] = {
+  { TexturDatei::kStandard, "standard" },
+  { TexturDatei::kTunnel, "tunnel" },
+  { TexturDatei::kVerwittert1, "verwittert_1" },
+  { TexturDatei::kVerwittert2, "verwittert_2" },
+};
+
+bool ParseTexturen(const char* liste, std::vector<TexturName>* result) {
+  std::string rest(liste);
+  while (!rest.empty()) {
+    const auto komma = rest.find(',');
+    const auto name = rest.substr(0, komma);
+    rest = (komma == std::string::npos) ? "" : rest.substr(komma + 1);
+
+    bool gefunden = false;
+    for (const auto& textur_name : kTexturNamen) {
+      if (name == textur_name.name) {
+        result->push_back(textur_name);
+        gefunden = true;
+      }
+    }
+    if (!gefunden) {
+      fprintf(stderr, "Unbekannte Textur: %s\n", name.c_str());
+      return false;
+    }
+  }
+  return !result->empty();
+}
+
+bool SchreibeManifestDatei(const char* pfad, const Manifest& manifest) {
+  FILE* fd = fopen(pfad, "w");
+  if (fd == nullptr) {
+    fprintf(stderr, "Kann %s nicht schreiben\n", pfad);
+    return false;
+  }
+  const bool ok = SchreibeManifest(fd, manifest);
+  if (fclose(fd) != 0 || !ok) {
+    fprintf(stderr, "Fehler beim Schreiben von %s\n", pfad);
+    return false;
+  }
+  return true;
+}
+
+int FuehreZusammen(const char* zielverzeichnis, const std::vector<std::string>& manifeste, const char* manifest_datei) {
+  StandardDateiSchreiber schreiber(zielverzeichnis);
+  Manifest gesamt;
+  BatchStatistik statistik;
+  std::string fehler;
+  if (!FuehreManifesteZusammen(manifeste, zielverzeichnis, &schreiber, &gesamt, &statistik, &fehler)) {
+    fprintf(stderr, "%s\n", fehler.c_str());
+    return 1;
+  }
+  if (manifest_datei != nullptr && !SchreibeManifestDatei(manifest_datei, gesamt)) {
+    return 1;
+  }
+  fprintf(stderr, "%zu Shards mit %zu Dateien zusammengefuehrt, davon %zu Dateien (%llu Bytes) in %.3f s geschrieben, %zu Fehler\n",
+      manifeste.size(), gesamt.eintraege.size(), statistik.anzahl_dateien, static_cast<unsigned long long>(statistik.anzahl_bytes),
+      std::chrono::duration<double>(statistik.gesamtdauer).count(), statistik.anzahl_fehler);
+  return statistik.anzahl_fehler == 0 ? 0 : 1;
+}
+
+// Liest eine ganze Zahl; anders als atoi() ohne Ueberlauf und nur, wenn der ganze Text eine Zahl ist.
+bool LiesGanzzahl(const char* text, int* result) {
+  const char* ende = text + strlen(text);
+  const auto [zeiger, fehler] = std::from_chars(text, ende, *result);
+  return fehler == std::errc() && zeiger == ende && zeiger != text;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int von_m = 0;
+  int bis_m = 10000;
+  std::optional<int> abstand_m;
+  std::optional<Kilometrierung> ueberlaenge_basis;
+  BauParameter bauparameter {
+    Hoehe::kHoch,
+    Mast::kOhneMast,
+    Beidseitig::kEinseitig,
+    Groesse::kGross,
+    Rueckstrahlend::kNo,
+    Ankerpunkt::kNo,
+    TexturDatei::kStandard,
+    Triangulierung::kFaecher,
+    IndexReihenfolge::kUnveraendert,
+    Detailstufe::kVoll,
+    Attributausgabe::kVollstaendig,
+    Genauigkeit::kVoll,
+  };
+  std::vector<TexturName> texturen;
+  BatchOptionen optionen;
+  const char* zielverzeichnis = nullptr;
+  bool io_uring = false;
+  const char* trace_datei = nullptr;
+  bool hardlinks = false;
+  HardlinkRueckfall hardlink_rueckfall = HardlinkRueckfall::kKopieren;
+  bool lod = false;
+  const char* platzierung_datei = nullptr;
+  const char* strecke_datei = nullptr;
+  StreckenOptionen strecken_optionen;
+  std::string lod_pfad;
+  bool verknuepft = false;
+  Shard shard;
+  const char* manifest_datei = nullptr;
+  const char* buendel_datei = nullptr;
+  bool zusammenfuehren = false;
+  bool index = false;
+  std::vector<std::string> manifeste;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hat_wert = i + 1 < argc;
+    if (!strcmp(arg, "--von") && hat_wert) {
+      if (!LiesGanzzahl(argv[++i], &von_m)) {
+        Hilfe(argv[0]);
+        return 1;
+      }
+    } else if (!strcmp(arg, "--bis") && hat_wert) {
+      if (!LiesGanzzahl(argv[++i], &bis_m)) {
+        Hilfe(argv[0]);
+        return 1;
+      }
+    } else if (!strcmp(arg, "--abstand") && hat_wert) {
+      int wert = 0;
+      if (!LiesGanzzahl(argv[++i], &wert)) {
+        Hilfe(argv[0]);
+        return 1;
+      }
+      abstand_m = wert;
+    } else if (!strcmp(arg, "--ueberlaenge") && hat_wert) {
+      int km = 0;
+      int hm = 0;
+      if (sscanf(argv[++i], "%d,%d", &km, &hm) != 2 || hm < -9 || hm > 9) {
+        Hilfe(argv[0]);
+        return 1;
+      }
+      ueberlaenge_basis.emplace(Kilometrierung { km, hm });
+    } else if (!strcmp(arg, "--platzierung") && hat_wert) {
+      platzierung_datei = argv[++i];
+    } else if (!strcmp(arg, "--strecke") && hat_wert) {
+      strecke_datei = argv[++i];
+    } else if (!strcmp(arg, "--seitenabstand") && hat_wert) {
+      strecken_optionen.seitenabstand_m = atof(argv[++i]);
+    } else if (!strcmp(arg, "--klein")) {
+      bauparameter.groesse = Groesse::kKlein;
+    } else if (!strcmp(arg, "--mast")) {
+      bauparameter.mast = Mast::kMitMast;
+    } else if (!strcmp(arg, "--beidseitig")) {
+      bauparameter.beidseitig = Beidseitig::kBeidseitig;
+    } else if (!strcmp(arg, "--niedrig")) {
+      bauparameter.hoehe = Hoehe::kNiedrig;
+    } else if (!strcmp(arg, "--rueckstrahlend")) {
+      bauparameter.rueckstrahlend = Rueckstrahlend::kYes;
+    } else if (!strcmp(arg, "--ankerpunkt")) {
+      bauparameter.ankerpunkt = Ankerpunkt::kYes;
+    } else if (!strcmp(arg, "--triangulierung-minimal")) {
+      bauparameter.triangulierung = Triangulierung::kMinimal;
+    } else if (!strcmp(arg, "--vertex-cache")) {
+      bauparameter.index_reihenfolge = IndexReihenfolge::kVertexCache;
+    } else if (!strcmp(arg, "--kompakt")) {
+      bauparameter.attributausgabe = Attributausgabe::kKompakt;
+    } else if (!strcmp(arg, "--quantisiert")) {
+      bauparameter.genauigkeit = Genauigkeit::kQuantisiert;
+    } else if (!strcmp(arg, "--texturen") && hat_wert) {
+      if (!ParseTexturen(argv[++i], &texturen)) {
+        return 1;
+      }
+    } else if (!strcmp(arg, "--verknuepft")) {
+      verknuepft = true;
+    } else if (!strcmp(arg, "--lod")) {
+      lod = true;
+    } else if (!strcmp(arg, "--lod-pfad") && hat_wert) {
+      lod_pfad = argv[++i];
+      if (!lod_pfad.empty() && lod_pfad.back() != '\\') {
+        lod_pfad += '\\';
+      }
+    } else if (!strcmp(arg, "--erzeuger") && hat_wert) {
+      optionen.anzahl_erzeuger = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--schreiber") && hat_wert) {
+      optionen.anzahl_schreiber = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--warteschlange") && hat_wert) {
+      optionen.warteschlange_kapazitaet = atoi(argv[++i]);
+#ifdef HEKTO_IO_URING
+    } else if (!strcmp(arg, "--io-uring")) {
+      io_uring = true;
+#endif
+    } else if (!strcmp(arg, "--pruefen")) {
+      optionen.geometrie_pruefen = true;
+    } else if (!strcmp(arg, "--hardlinks")) {
+      hardlinks = true;
+    } else if (!strcmp(arg, "--hardlink-rueckfall") && hat_wert) {
+      const char* wert = argv[++i];
+      if (!strcmp(wert, "kopieren")) {
+        hardlink_rueckfall = HardlinkRueckfall::kKopieren;
+      } else if (!strcmp(wert, "keiner")) {
+        hardlink_rueckfall = HardlinkRueckfall::kKeiner;
+      } else {
+        Hilfe(argv[0]);
+        return 1;
+      }
+    } else if (!strcmp(arg, "--index")) {
+      index = true;
+    } else if (!strcmp(arg, "--trace") && hat_wert) {
+      trace_datei = argv[++i];
+    } else if (!strcmp(arg, "--shard") && hat_wert) {
+      if (!LiesShard(argv[++i], &shard)) {
+        Hilfe(argv[0]);
+        return 1;
+      }
+    } else if (!strcmp(arg, "--shard-modus") && hat_wert) {
+      const char* wert = argv[++i];
+      if (!strcmp(wert, "bereich")) {
+        shard.modus = ShardModus::kBereich;
+      } else if (!strcmp(wert, "hash")) {
+        shard.modus = ShardModus::kHash;
+      } else {
+        Hilfe(argv[0]);
+        return 1;
+      }
+    } else if (!strcmp(arg, "--manifest") && hat_wert) {
+      manifest_datei = argv[++i];
+    } else if (!strcmp(arg, "--buendel") && hat_wert) {
+      buendel_datei = argv[++i];
+    } else if (!strcmp(arg, "--zusammenfuehren")) {
+      zusammenfuehren = true;
+    } else if (arg[0] != '-' && zielverzeichnis == nullptr) {
+      zielverzeichnis = arg;
+    } else if (arg[0] != '-' && zusammenfuehren) {
+      manifeste.push_back(arg);
+    } else {
+      Hilfe(argv[0]);
+      return 1;
+    }
+  }
+
+  if (zusammenfuehren) {
+    if (zielverzeichnis == nullptr || manifeste.empty()) {
+      Hilfe(argv[0]);
+      return 1;
+    }
+    return FuehreZusammen(zielverzeichnis, manifeste, manifest_datei);
+  }
+
+  if (buendel_datei != nullptr && zielverzeichnis == nullptr) {
+    zielverzeichnis = ".";  // wird mit Buendeldatei nicht beschrieben
+  }
+  if ((buendel_datei != nullptr && (manifest_datei == nullptr || hardlinks || index)) || !manifeste.empty()) {
+    Hilfe(argv[0]);
+    return 1;
+  }
+  if (zielverzeichnis == nullptr || (abstand_m.has_value() && *abstand_m <= 0) || (platzierung_datei != nullptr && strecke_datei != nullptr)
+      || (verknuepft && platzierung_datei == nullptr && strecke_datei == nullptr)) {
+    Hilfe(argv[0]);
+    return 1;
+  }
+  if (von_m < -kMaxWert_m || von_m > kMaxWert_m || bis_m < -kMaxWert_m || bis_m > kMaxWert_m
+      || (ueberlaenge_basis.has_value() && !ueberlaenge_basis->istDarstellbar())) {
+    fprintf(stderr, "--von, --bis und --ueberlaenge muessen zwischen -%d,9 und %d,9 km liegen\n", kMaxKm, kMaxKm);
+    return 1;
+  }
+  if (bauparameter.ankerpunkt == Ankerpunkt::kYes && (platzierung_datei != nullptr || strecke_datei != nullptr) && !verknuepft) {
+    fprintf(stderr, "--ankerpunkt ist mit Sammeldateien nicht moeglich (nur mit --verknuepft)\n");
+    return 1;
+  }
+  if (!abstand_m.has_value()) {
+    abstand_m = (strecke_datei != nullptr) ? static_cast<int>(kAbstandTafeln_m) : 100;
+  }
+  strecken_optionen.abstand_m = *abstand_m;
+  const bool sammeln = platzierung_datei != nullptr || strecke_datei != nullptr;
+
+  if (texturen.empty()) {
+    texturen.push_back(kTexturNamen[0]);
+  }
+
+  std::vector<Streckenabschnitt> abschnitte;
+  if (platzierung_datei != nullptr) {
+    FILE* fd = fopen(platzierung_datei, "r");
+    if (fd == nullptr) {
+      fprintf(stderr, "Kann %s nicht lesen\n", platzierung_datei);
+      return 1;
+    }
+    std::string fehler;
+    const bool ok = LiesPlatzierungen(fd, ueberlaenge_basis, &abschnitte, &fehler);
+    fclose(fd);
+    if (!ok) {
+      fprintf(stderr, "%s: %s\n", platzierung_datei, fehler.c_str());
+      return 1;
+    }
+  }
+
+  StreckenStatistik strecken_statistik;
+  if (strecke_datei != nullptr) {
+    FILE* fd = fopen(strecke_datei, "rb");
+    if (fd == nullptr) {
+      fprintf(stderr, "Kann %s nicht lesen\n", strecke_datei);
+      return 1;
+    }
+    std::string fehler;
+    const bool ok = LiesStreckenabschnitte(fd, strecken_optionen, ueberlaenge_basis, &abschnitte, &strecken_statistik, &fehler);
+    fclose(fd);
+    if (!ok) {
+      fprintf(stderr, "%s: %s\n", strecke_datei, fehler.c_str());
+      return 1;
+    }
+  }
+
+  // Mit --platzierung/--strecke werden ganze Abschnitte verteilt, damit jede Sammel- bzw.
+  // Platzierungsdatei von genau einem Shard geschrieben wird.
+  if (sammeln && shard.anzahl > 1) {
+    std::vector<Streckenabschnitt> eigene_abschnitte;
+    for (size_t i = 0; i < abschnitte.size(); ++i) {
+      if (GehoertZuShard(shard, i, abschnitte.size(), abschnitte[i].name)) {
+        eigene_abschnitte.push_back(std::move(abschnitte[i]));
+      }
+    }
+    abschnitte = std::move(eigene_abschnitte);
+  }
+
+  auto ZielPfad = [&texturen](const TexturName& textur, const std::string& name) {
+    return texturen.size() > 1 ? std::string(textur.name) + "/" + name : name;
+  };
+
+  // Auftraege fuer die Einzeldatei einer Tafel, ggf. mit Detailstufen
+  std::vector<BatchAuftrag> auftraege;
+  auto FuegeTafelHinzu = [&](Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm, const std::string& dateiname) {
+    auto NeuerAuftrag = [&](const BauParameter& auftrag_bauparameter, const std::string& name) {
+      BatchAuftrag auftrag { auftrag_bauparameter, kilometrierung, ueberlaenge_hm, {}, {} };
+      for (const auto& textur : texturen) {
+        auftrag.ziele.push_back({ textur.textur, bauparameter.rueckstrahlend, ZielPfad(textur, name) });
+      }
+      return auftrag;
+    };
+
+    if (!lod) {
+      auftraege.push_back(NeuerAuftrag(bauparameter, dateiname));
+      return;
+    }
+
+    // Die Dateien der Detailstufen enthalten keine Ankerpunkte, diese stehen in der verknuepfenden Datei.
+    std::vector<DetailstufenDatei> detailstufen;
+    for (const auto detailstufe : { Detailstufe::kVoll, Detailstufe::kGrob, Detailstufe::kFern }) {
+      if (detailstufe == Detailstufe::kFern && bauparameter.mast == Mast::kOhneMast) {
+        continue;
+      }
+      auto detailstufe_bauparameter = bauparameter;
+      detailstufe_bauparameter.ankerpunkt = Ankerpunkt::kNo;
+      detailstufe_bauparameter.detailstufe = detailstufe;
+      const auto name = DetailstufenDateiname(dateiname, detailstufe);
+      auftraege.push_back(NeuerAuftrag(detailstufe_bauparameter, name));
+      detailstufen.push_back({ detailstufe, name });
+    }
+
+    auto verknuepfung = NeuerAuftrag(bauparameter, dateiname);
+    if (lod_pfad.empty()) {
+      verknuepfung.detailstufen = std::move(detailstufen);
+      auftraege.push_back(std::move(verknuepfung));
+      return;
+    }
+
+    // Mit Zusi-Pfad unterscheiden sich die Verknuepfungen der Textur-Unterverzeichnisse
+    for (size_t i = 0; i < texturen.size(); ++i) {
+      BatchAuftrag auftrag { bauparameter, kilometrierung, ueberlaenge_hm, { verknuepfung.ziele[i] }, detailstufen };
+      for (auto& datei : auftrag.detailstufen) {
+        datei.dateiname = lod_pfad + (texturen.size() > 1 ? std::string(texturen[i].name) + "\\" : "") + datei.dateiname;
+      }
+      auftraege.push_back(std::move(auftrag));
+    }
+  };
+
+  if (!sammeln) {
+    struct Tafel final {
+      Kilometrierung kilometrierung;
+      std::optional<int> ueberlaenge_hm;
+      std::string dateiname;
+    };
+    std::vector<Tafel> tafeln;
+    std::string letzter_dateiname;
+    // 64 Bit, damit der letzte Schritt nicht ueberlaeuft
+    for (int64_t wert = von_m; wert <= bis_m; wert += *abstand_m) {
+      const int wert_m = static_cast<int>(wert);
+      const auto kilometrierung = ueberlaenge_basis.value_or(Kilometrierung::fromMeter(wert_m));
+      const auto ueberlaenge_hm = ueberlaenge_basis.has_value() ?
+        std::optional { Kilometrierung::fromMeter(wert_m).toHektometer() - ueberlaenge_basis->toHektometer() } : std::nullopt;
+      if (ueberlaenge_hm.has_value() && ((ueberlaenge_hm < 0) || (ueberlaenge_hm > kMaxUeberlaenge))) {
+        continue;
+      }
+
+      // Bei Abstaenden unter 100m koennen mehrere Werte auf denselben Hektometer fallen
+      auto dateiname = Dateiname(bauparameter, kilometrierung, ueberlaenge_hm);
+      if (dateiname == letzter_dateiname) {
+        continue;
+      }
+      letzter_dateiname = dateiname;
+      tafeln.push_back({ kilometrierung, ueberlaenge_hm, std::move(dateiname) });
+    }
+
+    for (size_t i = 0; i < tafeln.size(); ++i) {
+      if (GehoertZuShard(shard, i, tafeln.size(), tafeln[i].dateiname)) {
+        FuegeTafelHinzu(tafeln[i].kilometrierung, tafeln[i].ueberlaenge_hm, tafeln[i].dateiname);
+      }
+    }
+  } else if (verknuepft) {
+    // Jede Tafel wird nur einmal erzeugt, auch wenn sie in mehreren Abschnitten platziert ist
+    std::unordered_set<std::string> dateinamen;
+    for (const auto& abschnitt : abschnitte) {
+      for (const auto& tafel : abschnitt.tafeln) {
+        auto dateiname = Dateiname(bauparameter, tafel.kilometrierung, tafel.ueberlaenge_hm);
+        if (dateinamen.insert(dateiname).second) {
+          FuegeTafelHinzu(tafel.kilometrierung, tafel.ueberlaenge_hm, dateiname);
+        }
+      }
+    }
+  }
+
+  // Dateien, die laut Index mit gleichen Parametern erzeugt wurden und noch vorhanden sind, entfallen.
+  const auto index_pfad = (std::filesystem::path(zielverzeichnis) / kIndexDateiname).string();
+  std::unordered_map<std::string, uint64_t> index_schluessel;
+  size_t anzahl_aktuell = 0;
+  if (index) {
+    const TafelIndex vorhanden(index_pfad);
+    std::vector<BatchAuftrag> offene_auftraege;
+    for (auto& auftrag : auftraege) {
+      std::vector<BatchZiel> offene_ziele;
+      for (auto& ziel : auftrag.ziele) {
+        const auto schluessel = TafelSchluessel(auftrag, ziel);
+        const auto eintrag = vorhanden.Suche(schluessel);
+        std::error_code ec;
+        if (eintrag.has_value() && eintrag->pfad == ziel.pfad
+            && std::filesystem::file_size(std::filesystem::path(zielverzeichnis) / ziel.pfad, ec) == eintrag->groesse && !ec) {
+          ++anzahl_aktuell;
+          continue;
+        }
+        index_schluessel.emplace(ziel.pfad, schluessel);
+        offene_ziele.push_back(std::move(ziel));
+      }
+      if (!offene_ziele.empty()) {
+        auftrag.ziele = std::move(offene_ziele);
+        offene_auftraege.push_back(std::move(auftrag));
+      }
+    }
+    auftraege = std::move(offene_auftraege);
+  }
+
+  std::unique_ptr<DateiSchreiber> schreiber;
+#ifdef HEKTO_IO_URING
+  if (io_uring) {
+    auto io_uring_schreiber = std::make_unique<IoUringDateiSchreiber>(zielverzeichnis);
+    if (!io_uring_schreiber->NutztIoUring()) {
+      fprintf(stderr, "io_uring nicht verfuegbar, schreibe mit open/write/close\n");
+    }
+    schreiber = std::move(io_uring_schreiber);
+  }
+#endif
+  if (schreiber == nullptr) {
+    schreiber = std::make_unique<StandardDateiSchreiber>(zielverzeichnis);
+  }
+  std::unique_ptr<DeduplizierenderDateiSchreiber> deduplizierer;
+  if (hardlinks) {
+    deduplizierer = std::make_unique<DeduplizierenderDateiSchreiber>(zielverzeichnis, schreiber.get(), hardlink_rueckfall);
+  }
+
+  if (trace_datei != nullptr) {
+    StarteTrace();
+  }
+  auto* ziel_schreiber = deduplizierer != nullptr ? static_cast<DateiSchreiber*>(deduplizierer.get()) : schreiber.get();
+
+  std::unique_ptr<IndexDateiSchreiber> index_schreiber;
+  if (index) {
+    index_schreiber = std::make_unique<IndexDateiSchreiber>(index_pfad, std::move(index_schluessel), ziel_schreiber);
+    ziel_schreiber = index_schreiber.get();
+  }
+
+  FILE* buendel = nullptr;
+  std::unique_ptr<ManifestDateiSchreiber> manifest_schreiber;
+  if (buendel_datei != nullptr) {
+    buendel = fopen(buendel_datei, "wb");
+    if (buendel == nullptr) {
+      fprintf(stderr, "Kann %s nicht schreiben\n", buendel_datei);
+      return 1;
+    }
+    manifest_schreiber = std::make_unique<ManifestDateiSchreiber>(buendel);
+  } else if (manifest_datei != nullptr) {
+    manifest_schreiber = std::make_unique<ManifestDateiSchreiber>(ziel_schreiber);
+  }
+  if (manifest_schreiber != nullptr) {
+    ziel_schreiber = manifest_schreiber.get();
+  }
+
+  BatchStatistik statistik;
+  if (verknuepft) {
+    std::vector<PlatzierungsZiel> ziele;
+    for (const auto& textur : texturen) {
+      const std::string verzeichnis = texturen.size() > 1 ? std::string(textur.name) + "/" : "";
+      ziele.push_back({ verzeichnis,
+          lod_pfad.empty() ? "" : lod_pfad + (texturen.size() > 1 ? std::string(textur.name) + "\\" : "") });
+    }
+    statistik = FuehreBatchAus(auftraege, ziel_schreiber, optionen);
+    const auto platzierung_statistik = FuehrePlatzierungsBatchAus(abschnitte, bauparameter, ziele, ziel_schreiber, optionen);
+    statistik.anzahl_dateien += platzierung_statistik.anzahl_dateien;
+    statistik.anzahl_fehler += platzierung_statistik.anzahl_fehler;
+    statistik.anzahl_bytes += platzierung_statistik.anzahl_bytes;
+    statistik.gesamtdauer += platzierung_statistik.gesamtdauer;
+  } else if (sammeln) {
+    std::vector<std::pair<TexturDatei, std::string>> sammel_texturen;
+    for (const auto& textur : texturen) {
+      sammel_texturen.emplace_back(textur.textur, texturen.size() > 1 ? std::string(textur.name) + "/" : "");
+    }
+    statistik = FuehreSammelBatchAus(abschnitte, bauparameter, sammel_texturen, ziel_schreiber, optionen);
+  } else {
+    statistik = FuehreBatchAus(auftraege, ziel_schreiber, optionen);
+  }
+  if (trace_datei != nullptr) {
+    FILE* fd = fopen(trace_datei, "wb");
+    if (fd == nullptr) {
+      fprintf(stderr, "Kann %s nicht schreiben\n", trace_datei);
+      return 1;
+    }
+    DateiAusgabe ausgabe(fd);
+    SchreibeTrace(&ausgabe);
+    fclose(fd);
+  }
+
+  if (buendel != nullptr && fclose(buendel) != 0) {
+    fprintf(stderr, "Fehler beim Schreiben von %s\n", buendel_datei);
+    ++statistik.anzahl_fehler;
+  }
+  if (manifest_schreiber != nullptr) {
+    Manifest manifest { shard, {}, {}, manifest_schreiber->Eintraege() };
+    if (buendel_datei != nullptr) {
+      const auto manifest_verzeichnis = std::filesystem::absolute(manifest_datei).parent_path();
+      manifest.buendel = std::filesystem::relative(std::filesystem::absolute(buendel_datei), manifest_verzeichnis).generic_string();
+    } else {
+      manifest.verzeichnis = std::filesystem::absolute(zielverzeichnis).string();
+    }
+    if (!SchreibeManifestDatei(manifest_datei, manifest)) {
+      ++statistik.anzahl_fehler;
+    }
+  }
+
+  fprintf(stderr, "%zu Dateien (%llu Bytes) in %.3f s geschrieben, %zu Fehler\n",
+      statistik.anzahl_dateien, static_cast<unsigned long long>(statistik.anzahl_bytes),
+      std::chrono::duration<double>(statistik.gesamtdauer).count(), statistik.anzahl_fehler);
+  if (strecke_datei != nullptr) {
+    fprintf(stderr, "Strecke: %zu Elemente (%zu ohne Kilometrierung, %zu ausserhalb von +/-%d,9 km), %zu Standorte, %.1f MB gelesen\n",
+        strecken_statistik.anzahl_elemente, strecken_statistik.anzahl_ohne_kilometrierung, strecken_statistik.anzahl_ausserhalb,
+        kMaxKm, strecken_statistik.anzahl_standorte,
+        strecken_statistik.gelesene_bytes / 1e6);
+  }
+  if (index) {
+    fprintf(stderr, "Index: %zu Dateien unveraendert uebersprungen\n", anzahl_aktuell);
+    if (!index_schreiber->Fehler().empty()) {
+      fprintf(stderr, "%s\n", index_schreiber->Fehler().c_str());
+    }
+  }
+  if (shard.anzahl > 1) {
+    fprintf(stderr, "Shard %zu/%zu (%s)\n", shard.nummer, shard.anzahl, shard.modus == ShardModus::kHash ? "hash" : "bereich");
+  }
+  if (sammeln) {
+    size_t anzahl_tafeln = 0;
+    for (const auto& abschnitt : abschnitte) {
+      anzahl_tafeln += abschnitt.tafeln.size();
+    }
+    fprintf(stderr, "%zu Tafeln in %zu Streckenabschnitten\n", anzahl_tafeln, abschnitte.size());
+  } else {
+    fprintf(stderr,
+        "Warteschlange: max. Tiefe %zu, mittlere Tiefe %.1f\n"
+        "Gegendruck: %zu-mal gestaut, Wartezeit Erzeuger %.3f s, Wartezeit Schreiber %.3f s\n"
+        "Gestohlene Auftraege: %zu\n",
+        statistik.max_warteschlange_tiefe, statistik.mittlere_warteschlange_tiefe,
+        statistik.anzahl_gestaute_erzeuger,
+        std::chrono::duration<double>(statistik.wartezeit_erzeuger).count(),
+        std::chrono::duration<double>(statistik.wartezeit_schreiber).count(),
+        statistik.anzahl_gestohlene_auftraege);
+  }
+  if (bauparameter.index_reihenfolge == IndexReihenfolge::kVertexCache) {
+    const auto vertex_cache = HoleVertexCacheStatistik();
+    fprintf(stderr, "Vertex-Cache (FIFO, %zu Eintraege): ACMR %.3f vorher, %.3f nachher, Minimum %.3f\n",
+        kVertexCacheGroesse, vertex_cache.AcmrVorher(), vertex_cache.AcmrNachher(), vertex_cache.AcmrMinimum());
+  }
+  if (deduplizierer != nullptr) {
+    fprintf(stderr, "Hardlinks: %zu (%llu Bytes eingespart)\n",
+        deduplizierer->AnzahlVerknuepft(), static_cast<unsigned long long>(deduplizierer->EingesparteBytes()));
+  }
+
+  return statistik.anzahl_fehler == 0 ? 0 : 1;
+}
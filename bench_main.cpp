@@ -0,0 +1,353 @@
+// Copyright 2026 Zusitools
+
+#include "allokationen.hpp"
+#include "ausgabe.hpp"
+#include "ausgabe_pruefung.hpp"
+#include "hekto_builder.hpp"
+#include "vertex_cache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+// Hoechstens so viele Heap-Allokationen darf das Erzeugen einer Tafel im eingeschwungenen Zustand kosten
+// (Caches fuer Rueckseite und Mast gefuellt, Ziffern und Vorderseite neu), gemittelt ueber den gemessenen Bereich.
+// Am meisten brauchen dreistellige negative Werte (derzeit 97.5). Bei Verbesserungen absenken.
+constexpr double kMaxAllokationenProTafel = 100;
+
+void Hilfe(const char* programm) {
+  fprintf(stderr,
+      "Aufruf: %s [Optionen]\n"
+      "\n"
+      "Erzeugt alle Tafeln eines Kilometrierungsbereichs im Speicher und vergleicht die Triangulierungen,\n"
+      "die Vertex-Cache-Trefferquote vor und nach der Optimierung, die Detailstufen und die Ausgabeformate.\n"
+      "Fuer jedes Ausgabeformat wird die Ausgabe zurueckgelesen und mit der berechneten Geometrie verglichen;\n"
+      "liegt eine Abweichung ausserhalb der Toleranz, endet das Programm mit Fehlercode 1.\n"
+      "Ausserdem wird die Dauer der Geometriepruefung (ValidateMesh) gemessen; meldet sie Fehler, endet das\n"
+      "Programm ebenfalls mit Fehlercode 1.\n"
+      "Zuletzt werden die Heap-Allokationen pro Tafel nach Bereichen gezaehlt; liegen sie im eingeschwungenen\n"
+      "Zustand ueber dem eingecheckten Grenzwert, endet das Programm ebenfalls mit Fehlercode 1.\n"
+      "\n"
+      "  --von <hm>                erster Wert in Hektometern (Standard: -9999)\n"
+      "  --bis <hm>                letzter Wert in Hektometern, inklusive (Standard: 9999)\n",
+      programm);
+}
+
+size_t Zaehle(const std::string& text, const char* muster) {
+  size_t result = 0;
+  const size_t laenge = strlen(muster);
+  for (auto pos = text.find(muster); pos != std::string::npos; pos = text.find(muster, pos + laenge)) {
+    ++result;
+  }
+  return result;
+}
+
+// Bauparameter der Messungen: hoch, beidseitig, rueckstrahlend, Standardtextur, ohne Ankerpunkt,
+// Faecher-Triangulierung, volle Detailstufe.
+BauParameter MessParameter(Groesse groesse, Mast mast, Ausgabeformat format = {}) {
+  return BauParameter {
+    Hoehe::kHoch,
+    mast,
+    Beidseitig::kBeidseitig,
+    groesse,
+    Rueckstrahlend::kYes,
+    Ankerpunkt::kNo,
+    TexturDatei::kStandard,
+    Triangulierung::kFaecher,
+    IndexReihenfolge::kUnveraendert,
+    Detailstufe::kVoll,
+    format.attributausgabe,
+    format.genauigkeit,
+  };
+}
+
+struct Zaehler final {
+  size_t anzahl_tafeln = 0;
+  size_t anzahl_dreiecke = 0;
+  size_t anzahl_vertices = 0;
+  size_t min_dreiecke = SIZE_MAX;
+  size_t max_dreiecke = 0;
+  std::chrono::nanoseconds dauer {};
+
+  void Erfasse(const std::string& inhalt) {
+    const size_t dreiecke = Zaehle(inhalt, "<Face ");
+    ++anzahl_tafeln;
+    anzahl_dreiecke += dreiecke;
+    anzahl_vertices += Zaehle(inhalt, "<Vertex ");
+    min_dreiecke = std::min(min_dreiecke, dreiecke);
+    max_dreiecke = std::max(max_dreiecke, dreiecke);
+  }
+};
+
+Zaehler Miss(Groesse groesse, Triangulierung triangulierung, IndexReihenfolge index_reihenfolge, int von_hm, int bis_hm,
+    Mast mast = Mast::kOhneMast, Detailstufe detailstufe = Detailstufe::kVoll) {
+  auto bauparameter = MessParameter(groesse, mast);
+  bauparameter.beidseitig = Beidseitig::kEinseitig;
+  bauparameter.rueckstrahlend = Rueckstrahlend::kNo;
+  bauparameter.triangulierung = triangulierung;
+  bauparameter.index_reihenfolge = index_reihenfolge;
+  bauparameter.detailstufe = detailstufe;
+
+  Zaehler result;
+  PufferAusgabe ausgabe;
+  for (int wert_hm = von_hm; wert_hm <= bis_hm; ++wert_hm) {
+    const auto kilometrierung = Kilometrierung::fromMeter(100 * wert_hm);
+    ausgabe.Inhalt().clear();
+
+    const auto start = Uhr::now();
+    HektoBuilder::Build(&ausgabe, bauparameter, kilometrierung, std::nullopt);
+    result.dauer += Uhr::now() - start;
+
+    result.Erfasse(ausgabe.Inhalt());
+  }
+  return result;
+}
+
+struct FormatZaehler final {
+  size_t anzahl_tafeln = 0;
+  uint64_t anzahl_bytes = 0;
+  Abweichung abweichung;
+  std::chrono::nanoseconds dauer {};
+  std::string fehler;
+};
+
+// Schreibt die Subsets aller Tafeln im angegebenen Format und prueft die Ausgabe mit PruefeAusgabe().
+FormatZaehler MissFormat(Groesse groesse, Ausgabeformat format, int von_hm, int bis_hm) {
+  const auto bauparameter = MessParameter(groesse, Mast::kMitMast, format);
+
+  FormatZaehler result;
+  PufferAusgabe ausgabe;
+  for (int wert_hm = von_hm; wert_hm <= bis_hm; ++wert_hm) {
+    const auto meshes = HektoBuilder::BuildMeshes(bauparameter, Kilometrierung::fromMeter(100 * wert_hm), std::nullopt);
+    ++result.anzahl_tafeln;
+    for (const auto* mesh : { &meshes.beleuchtet, &meshes.unbeleuchtet }) {
+      SubsetBuilder subset(0, 0, 0, format);
+      subset.AddMesh(*mesh);
+      ausgabe.Inhalt().clear();
+
+      const auto start = Uhr::now();
+      subset.WriteInhalt(&ausgabe);
+      result.dauer += Uhr::now() - start;
+
+      result.anzahl_bytes += ausgabe.Inhalt().size();
+      std::string fehler;
+      if (result.fehler.empty() && !PruefeAusgabe(*mesh, ausgabe.Inhalt(), format.genauigkeit, &result.abweichung, &fehler)) {
+        result.fehler = std::to_string(wert_hm) + " hm: " + fehler;
+      }
+    }
+  }
+  return result;
+}
+
+enum class Messart { kDauer, kDauerMitPruefung, kAllokationen };
+
+struct Messung final {
+  size_t anzahl_tafeln = 0;
+  std::chrono::nanoseconds dauer {};
+  std::string fehler;  // erster Fehler der Geometriepruefung, nur mit Messart::kDauerMitPruefung
+  std::vector<AllokationsZaehler> bereiche;  // nur mit Messart::kAllokationen
+};
+
+// Erzeugt die Tafeln von_hm + 1 bis bis_hm mit HektoBuilder::BuildVarianten(), mit Messart::kDauerMitPruefung
+// einschliesslich Geometriepruefung. Die erste Tafel fuellt die Caches fuer den statischen Teil und wird nur
+// geprueft, nicht mitgemessen. Ist die Allokationszaehlung nicht verfuegbar, wird nichts gemessen.
+Messung MissErzeugung(const BauParameter& bauparameter, Messart messart, int von_hm, int bis_hm) {
+  Messung result;
+  PufferAusgabe ausgabe;
+  const std::vector<TexturVariante> varianten { { bauparameter.textur, bauparameter.rueckstrahlend, &ausgabe } };
+  std::vector<MeshFehler> mesh_fehler;
+  auto* pruefung = messart == Messart::kDauerMitPruefung ? &mesh_fehler : nullptr;
+  HektoBuilder::BuildVarianten(varianten, bauparameter, Kilometrierung::fromMeter(100 * von_hm), std::nullopt, pruefung);
+  if (!mesh_fehler.empty()) {
+    result.fehler = std::to_string(von_hm) + " hm: " + Beschreibung(mesh_fehler.front());
+  }
+  if (messart == Messart::kAllokationen && !StarteAllokationsZaehlung()) {
+    return result;
+  }
+  for (int wert_hm = von_hm + 1; wert_hm <= bis_hm; ++wert_hm) {
+    const auto kilometrierung = Kilometrierung::fromMeter(100 * wert_hm);
+    ++result.anzahl_tafeln;
+
+    ausgabe.Inhalt().clear();
+    const auto start = Uhr::now();
+    HektoBuilder::BuildVarianten(varianten, bauparameter, kilometrierung, std::nullopt, pruefung);
+    result.dauer += Uhr::now() - start;
+
+    if (result.fehler.empty() && !mesh_fehler.empty()) {
+      result.fehler = std::to_string(wert_hm) + " hm: " + Beschreibung(mesh_fehler.front());
+    }
+  }
+  if (messart == Messart::kAllokationen) {
+    result.bereiche = BeendeAllokationsZaehlung();
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int von_hm = -9999;
+  int bis_hm = 9999;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hat_wert = i + 1 < argc;
+    if (!strcmp(arg, "--von") && hat_wert) {
+      von_hm = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--bis") && hat_wert) {
+      bis_hm = atoi(argv[++i]);
+    } else {
+      Hilfe(argv[0]);
+      return 1;
+    }
+  }
+
+  if (von_hm > bis_hm || von_hm < -9999 || bis_hm > 9999) {
+    Hilfe(argv[0]);
+    return 1;
+  }
+
+  bool ok = true;
+
+  // Vor den uebrigen Messungen, damit Ziffern und Vorderseite wie beim Erzeugen einer Strecke noch nicht in den Caches liegen
+  printf("Allokationen (mit Mast, beidseitig), pro Tafel nach Bereichen, Grenzwert %.0f\n\n", kMaxAllokationenProTafel);
+  printf("%-7s %-16s %12s %12s\n", "Groesse", "Bereich", "Anzahl", "Bytes");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    if (von_hm == bis_hm) {
+      break;
+    }
+    const auto messung = MissErzeugung(MessParameter(groesse, Mast::kMitMast), Messart::kAllokationen, von_hm, bis_hm);
+    if (messung.anzahl_tafeln == 0) {
+      printf("(nicht verfuegbar, operator new ist nicht ersetzt)\n");
+      break;
+    }
+    const char* name_groesse = groesse == Groesse::kGross ? "gross" : "klein";
+    uint64_t anzahl = 0;
+    uint64_t bytes = 0;
+    for (const auto& bereich : messung.bereiche) {
+      printf("%-7s %-16s %12.1f %12.0f\n", name_groesse, bereich.bereich == nullptr ? "(ausserhalb)" : bereich.bereich,
+          static_cast<double>(bereich.anzahl) / messung.anzahl_tafeln, static_cast<double>(bereich.bytes) / messung.anzahl_tafeln);
+      anzahl += bereich.anzahl;
+      bytes += bereich.bytes;
+    }
+    const double anzahl_pro_tafel = static_cast<double>(anzahl) / messung.anzahl_tafeln;
+    printf("%-7s %-16s %12.1f %12.0f\n", name_groesse, "Summe", anzahl_pro_tafel, static_cast<double>(bytes) / messung.anzahl_tafeln);
+    if (anzahl_pro_tafel > kMaxAllokationenProTafel) {
+      fprintf(stderr, "Zu viele Allokationen (%s): %.1f pro Tafel, erlaubt sind %.0f\n", name_groesse, anzahl_pro_tafel,
+          kMaxAllokationenProTafel);
+      ok = false;
+    }
+  }
+
+  printf("\nTriangulierung der Vorderseite, %d Tafeln je Groesse (ohne Mast, einseitig)\n\n", bis_hm - von_hm + 1);
+  printf("%-7s %-9s %12s %12s %9s %9s %12s\n", "Groesse", "Verfahren", "Dreiecke", "Vertices", "min/Tafel", "max/Tafel", "us/Tafel");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    size_t dreiecke_faecher = 0;
+    for (const auto triangulierung : { Triangulierung::kFaecher, Triangulierung::kMinimal }) {
+      const auto zaehler = Miss(groesse, triangulierung, IndexReihenfolge::kUnveraendert, von_hm, bis_hm);
+      printf("%-7s %-9s %12zu %12zu %9zu %9zu %12.2f\n",
+          groesse == Groesse::kGross ? "gross" : "klein",
+          triangulierung == Triangulierung::kFaecher ? "Faecher" : "Minimal",
+          zaehler.anzahl_dreiecke, zaehler.anzahl_vertices, zaehler.min_dreiecke, zaehler.max_dreiecke,
+          std::chrono::duration<double, std::micro>(zaehler.dauer).count() / zaehler.anzahl_tafeln);
+
+      if (triangulierung == Triangulierung::kFaecher) {
+        dreiecke_faecher = zaehler.anzahl_dreiecke;
+      } else if (dreiecke_faecher != 0) {
+        printf("%-7s %-9s %11.1f%%\n", "", "Ersparnis",
+            100.0 * (static_cast<double>(dreiecke_faecher) - zaehler.anzahl_dreiecke) / dreiecke_faecher);
+      }
+    }
+  }
+
+  printf("\nVertex-Cache-Optimierung, ACMR bei FIFO-Cache mit %zu Eintraegen\n\n", kVertexCacheGroesse);
+  printf("%-7s %-9s %9s %9s %9s %12s\n", "Groesse", "Verfahren", "vorher", "nachher", "Minimum", "us/Tafel");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    for (const auto triangulierung : { Triangulierung::kFaecher, Triangulierung::kMinimal }) {
+      SetzeVertexCacheStatistikZurueck();
+      const auto zaehler = Miss(groesse, triangulierung, IndexReihenfolge::kVertexCache, von_hm, bis_hm);
+      const auto statistik = HoleVertexCacheStatistik();
+      printf("%-7s %-9s %9.3f %9.3f %9.3f %12.2f\n",
+          groesse == Groesse::kGross ? "gross" : "klein",
+          triangulierung == Triangulierung::kFaecher ? "Faecher" : "Minimal",
+          statistik.AcmrVorher(), statistik.AcmrNachher(), statistik.AcmrMinimum(),
+          std::chrono::duration<double, std::micro>(zaehler.dauer).count() / zaehler.anzahl_tafeln);
+    }
+  }
+
+  printf("\nDetailstufen (mit Mast, einseitig), Mittelwerte pro Tafel\n\n");
+  printf("%-7s %-9s %12s %12s %12s\n", "Groesse", "Stufe", "Dreiecke", "Vertices", "us/Tafel");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    for (const auto detailstufe : { Detailstufe::kVoll, Detailstufe::kGrob, Detailstufe::kFern }) {
+      const auto zaehler = Miss(groesse, Triangulierung::kFaecher, IndexReihenfolge::kUnveraendert, von_hm, bis_hm,
+          Mast::kMitMast, detailstufe);
+      printf("%-7s %-9s %12.1f %12.1f %12.2f\n",
+          groesse == Groesse::kGross ? "gross" : "klein",
+          detailstufe == Detailstufe::kVoll ? "Voll" : (detailstufe == Detailstufe::kGrob ? "Grob" : "Fern"),
+          static_cast<double>(zaehler.anzahl_dreiecke) / zaehler.anzahl_tafeln,
+          static_cast<double>(zaehler.anzahl_vertices) / zaehler.anzahl_tafeln,
+          std::chrono::duration<double, std::micro>(zaehler.dauer).count() / zaehler.anzahl_tafeln);
+    }
+  }
+
+  printf("\nAusgabeformate (mit Mast, beidseitig), Subset-Inhalt ohne Kopf, Abweichung nach dem Zuruecklesen\n\n");
+  printf("%-7s %-10s %-11s %12s %9s %12s %12s %12s\n", "Groesse", "Attribute", "Genauigkeit", "Bytes/Tafel", "Anteil",
+      "Position mm", "Texturkoord.", "us/Tafel");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    uint64_t bytes_vollstaendig = 0;
+    for (const auto genauigkeit : { Genauigkeit::kVoll, Genauigkeit::kQuantisiert }) {
+      for (const auto attributausgabe : { Attributausgabe::kVollstaendig, Attributausgabe::kKompakt }) {
+        const auto zaehler = MissFormat(groesse, { attributausgabe, genauigkeit }, von_hm, bis_hm);
+        if (bytes_vollstaendig == 0) {
+          bytes_vollstaendig = zaehler.anzahl_bytes;
+        }
+        printf("%-7s %-10s %-11s %12.0f %8.1f%% %12.6f %12.6f %12.2f\n",
+            groesse == Groesse::kGross ? "gross" : "klein",
+            attributausgabe == Attributausgabe::kKompakt ? "kompakt" : "alle",
+            genauigkeit == Genauigkeit::kQuantisiert ? "quantisiert" : "voll",
+            static_cast<double>(zaehler.anzahl_bytes) / zaehler.anzahl_tafeln,
+            100.0 * zaehler.anzahl_bytes / bytes_vollstaendig,
+            zaehler.abweichung.position_mm, zaehler.abweichung.texturkoordinate,
+            std::chrono::duration<double, std::micro>(zaehler.dauer).count() / zaehler.anzahl_tafeln);
+        if (!zaehler.fehler.empty()) {
+          fprintf(stderr, "Ausgabe weicht ab: %s\n", zaehler.fehler.c_str());
+          ok = false;
+        }
+      }
+    }
+  }
+
+  printf("\nGeometriepruefung (mit Mast, beidseitig), Erzeugung und Ausgabe einer Tafel ohne und mit ValidateMesh()\n\n");
+  printf("%-7s %12s %12s %9s\n", "Groesse", "us ohne", "us mit", "Aufschlag");
+
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    if (von_hm == bis_hm) {
+      break;
+    }
+    const auto bauparameter = MessParameter(groesse, Mast::kMitMast);
+    const auto messung_ohne = MissErzeugung(bauparameter, Messart::kDauer, von_hm, bis_hm);
+    const auto messung_mit = MissErzeugung(bauparameter, Messart::kDauerMitPruefung, von_hm, bis_hm);
+    const double ohne = std::chrono::duration<double, std::micro>(messung_ohne.dauer).count() / messung_ohne.anzahl_tafeln;
+    const double mit = std::chrono::duration<double, std::micro>(messung_mit.dauer).count() / messung_mit.anzahl_tafeln;
+    printf("%-7s %12.2f %12.2f %8.1f%%\n", groesse == Groesse::kGross ? "gross" : "klein", ohne, mit, 100 * (mit - ohne) / ohne);
+    if (!messung_mit.fehler.empty()) {
+      fprintf(stderr, "Geometriepruefung meldet Fehler: %s\n", messung_mit.fehler.c_str());
+      ok = false;
+    }
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Copyright 2026 Zusitools
+
+#include "bild.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+bool LiesPam(FILE* fd, Bild* result, std::string* fehler) {
+  char zeile[256];
+  if (fgets(zeile, sizeof(zeile), fd) == nullptr || strncmp(zeile, "P7", 2) != 0) {
+    *fehler = "keine PAM-Datei (P7)";
+    return false;
+  }
+
+  int breite = 0;
+  int hoehe = 0;
+  int tiefe = 0;
+  int maxval = 0;
+  bool ende = false;
+  while (!ende && fgets(zeile, sizeof(zeile), fd) != nullptr) {
+    char tupltype[64];
+    if (zeile[0] == '#' || zeile[0] == '\n') {
+      continue;
+    } else if (sscanf(zeile, "WIDTH %d", &breite) == 1 || sscanf(zeile, "HEIGHT %d", &hoehe) == 1
+        || sscanf(zeile, "DEPTH %d", &tiefe) == 1 || sscanf(zeile, "MAXVAL %d", &maxval) == 1
+        || sscanf(zeile, "TUPLTYPE %63s", tupltype) == 1) {
+      continue;
+    } else if (strncmp(zeile, "ENDHDR", 6) == 0) {
+      ende = true;
+    } else {
+      *fehler = std::string("unbekannte Kopfzeile: ") + zeile;
+      return false;
+    }
+  }
+
+  if (!ende) {
+    *fehler = "unvollstaendiger Kopf";
+    return false;
+  }
+  if (breite <= 0 || hoehe <= 0 || breite > 16384 || hoehe > 16384) {
+    *fehler = "ungueltige Bildgroesse";
+    return false;
+  }
+  if ((tiefe != 3 && tiefe != 4) || maxval != 255) {
+    *fehler = "nur RGB oder RGB_ALPHA mit 8 Bit pro Kanal werden unterstuetzt";
+    return false;
+  }
+
+  Bild bild(breite, hoehe);
+  std::vector<uint8_t> zeilenpuffer(static_cast<size_t>(breite) * tiefe);
+  for (int y = 0; y < hoehe; ++y) {
+    if (fread(zeilenpuffer.data(), 1, zeilenpuffer.size(), fd) != zeilenpuffer.size()) {
+      *fehler = "Bilddaten unvollstaendig";
+      return false;
+    }
+    for (int x = 0; x < breite; ++x) {
+      const uint8_t* quelle = &zeilenpuffer[static_cast<size_t>(x) * tiefe];
+      uint8_t* ziel = bild.Pixel(x, y);
+      ziel[0] = quelle[0];
+      ziel[1] = quelle[1];
+      ziel[2] = quelle[2];
+      ziel[3] = (tiefe == 4) ? quelle[3] : 255;
+    }
+  }
+
+  *result = std::move(bild);
+  return true;
+}
+
+Bild Verkleinere(const Bild& bild) {
+  Bild result(std::max(1, bild.breite / 2), std::max(1, bild.hoehe / 2));
+  const int schritt_x = bild.breite > 1 ? 2 : 1;
+  const int schritt_y = bild.hoehe > 1 ? 2 : 1;
+
+  for (int y = 0; y < result.hoehe; ++y) {
+    for (int x = 0; x < result.breite; ++x) {
+      uint32_t summe_rgb[3] = { 0, 0, 0 };
+      uint32_t summe_rgb_gewichtet[3] = { 0, 0, 0 };
+      uint32_t summe_alpha = 0;
+      int anzahl = 0;
+      for (int dy = 0; dy < schritt_y; ++dy) {
+        for (int dx = 0; dx < schritt_x; ++dx) {
+          const uint8_t* quelle = bild.Pixel(schritt_x * x + dx, schritt_y * y + dy);
+          for (int k = 0; k < 3; ++k) {
+            summe_rgb[k] += quelle[k];
+            summe_rgb_gewichtet[k] += quelle[k] * quelle[3];
+          }
+          summe_alpha += quelle[3];
+          ++anzahl;
+        }
+      }
+
+      uint8_t* ziel = result.Pixel(x, y);
+      for (int k = 0; k < 3; ++k) {
+        ziel[k] = static_cast<uint8_t>(summe_alpha == 0 ?
+            (summe_rgb[k] + anzahl / 2) / anzahl : (summe_rgb_gewichtet[k] + summe_alpha / 2) / summe_alpha);
+      }
+      ziel[3] = static_cast<uint8_t>((summe_alpha + anzahl / 2) / anzahl);
+    }
+  }
+  return result;
+}
+
+void SkaliereHelligkeit(double faktor, Bild* bild) {
+  uint8_t tabelle[256];
+  for (int i = 0; i < 256; ++i) {
+    tabelle[i] = static_cast<uint8_t>(std::clamp<long>(std::lround(i * faktor), 0, 255));
+  }
+  for (size_t i = 0; i < bild->rgba.size(); i += 4) {
+    for (size_t k = 0; k < 3; ++k) {
+      bild->rgba[i + k] = tabelle[bild->rgba[i + k]];
+    }
+  }
+}
+
+void FaerbeUm(const BildBereich& bereich, uint8_t r, uint8_t g, uint8_t b, Bild* bild) {
+  const uint8_t zielfarbe[3] = { r, g, b };
+  uint8_t tabelle[3][256];
+  for (int k = 0; k < 3; ++k) {
+    for (int i = 0; i < 256; ++i) {
+      tabelle[k][i] = static_cast<uint8_t>((zielfarbe[k] * 255 + i * (255 - zielfarbe[k]) + 127) / 255);
+    }
+  }
+
+  for (int y = 0; y < bild->hoehe; ++y) {
+    const double mitte_y = (y + 0.5) / bild->hoehe;
+    if (mitte_y < bereich.oben || mitte_y >= bereich.unten) {
+      continue;
+    }
+    for (int x = 0; x < bild->breite; ++x) {
+      const double mitte_x = (x + 0.5) / bild->breite;
+      if (mitte_x < bereich.links || mitte_x >= bereich.rechts) {
+        continue;
+      }
+      uint8_t* pixel = bild->Pixel(x, y);
+      for (int k = 0; k < 3; ++k) {
+        pixel[k] = tabelle[k][pixel[k]];
+      }
+    }
+  }
+}
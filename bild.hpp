@@ -0,0 +1,58 @@
+// Copyright 2026 Zusitools
+
+#ifndef BILD_HPP_
+#define BILD_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * RGBA-Bild mit 8 Bit pro Kanal, zeilenweise von oben nach unten gespeichert.
+ */
+struct Bild final {
+  int breite = 0;
+  int hoehe = 0;
+  std::vector<uint8_t> rgba;
+
+  Bild() = default;
+  Bild(int breite, int hoehe) : breite(breite), hoehe(hoehe), rgba(4 * static_cast<size_t>(breite) * hoehe) { }
+
+  uint8_t* Pixel(int x, int y) { return &rgba[4 * (static_cast<size_t>(y) * breite + x)]; }
+  const uint8_t* Pixel(int x, int y) const { return &rgba[4 * (static_cast<size_t>(y) * breite + x)]; }
+};
+
+/**
+ * Liest ein Bild im Netpbm-Format PAM (P7, TUPLTYPE RGB_ALPHA oder RGB, MAXVAL 255),
+ * wie es z.B. `pngtopam -alphapam` erzeugt. Ohne Alphakanal sind alle Pixel deckend.
+ */
+bool LiesPam(FILE* fd, Bild* result, std::string* fehler);
+
+/**
+ * Halbiert Breite und Hoehe (jeweils mindestens 1 Pixel) per 2x2-Mittelwert.
+ * Die Farbe wird mit dem Alphawert gewichtet, damit transparente Pixel nicht abfaerben.
+ */
+Bild Verkleinere(const Bild& bild);
+
+// Multipliziert die Farbkanaele mit `faktor`, der Alphakanal bleibt unveraendert.
+void SkaliereHelligkeit(double faktor, Bild* bild);
+
+/**
+ * Rechteck relativ zur Bildgroesse (0..1), Koordinatensystem wie in Gimp.
+ */
+struct BildBereich final {
+  double links;
+  double oben;
+  double rechts;
+  double unten;
+};
+
+/**
+ * Faerbt alle Pixel, deren Mittelpunkt in `bereich` liegt, linear um: Schwarz wird zu
+ * `r, g, b`, Weiss bleibt Weiss. Fuer schwarze Schrift auf transparentem Grund entspricht das
+ * dem Einfaerben der Schrift, Kantenglaettung bleibt erhalten.
+ */
+void FaerbeUm(const BildBereich& bereich, uint8_t r, uint8_t g, uint8_t b, Bild* bild);
+
+#endif  // BILD_HPP_
@@ -0,0 +1,453 @@
+// Copyright 2026 Zusitools
+
+#include "dds.hpp"
+
+#ifdef HEKTO_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+struct Farbe final {
+  int r;
+  int g;
+  int b;
+};
+
+using Palette = std::array<Farbe, 4>;
+
+uint16_t Nach565(double r, double g, double b) {
+  auto Quantisiere = [](double wert, int max) {
+    return static_cast<uint16_t>(std::clamp<long>(std::lround(wert * max / 255.0), 0, max));
+  };
+  return static_cast<uint16_t>((Quantisiere(r, 31) << 11) | (Quantisiere(g, 63) << 5) | Quantisiere(b, 31));
+}
+
+Farbe Von565(uint16_t farbe) {
+  const int r = farbe >> 11;
+  const int g = (farbe >> 5) & 63;
+  const int b = farbe & 31;
+  return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+}
+
+// Vierfarbenmodus, wie ihn DXT3 unabhaengig von der Reihenfolge der Endpunkte verwendet.
+Palette Baue4FarbPalette(uint16_t c0, uint16_t c1) {
+  const Farbe a = Von565(c0);
+  const Farbe b = Von565(c1);
+  return {{
+    a,
+    b,
+    { (2 * a.r + b.r) / 3, (2 * a.g + b.g) / 3, (2 * a.b + b.b) / 3 },
+    { (a.r + 2 * b.r) / 3, (a.g + 2 * b.g) / 3, (a.b + 2 * b.b) / 3 },
+  }};
+}
+
+// Waehlt fuer jedes Pixel den naechsten Palettenwert (bei Gleichstand den kleineren Index)
+// und gibt die Summe der quadrierten Abstaende zurueck.
+uint32_t SucheIndizesSkalar(const uint8_t* rgba, const Palette& palette, uint8_t* indizes) {
+  uint32_t fehler = 0;
+  for (int i = 0; i < 16; ++i) {
+    const uint8_t* pixel = &rgba[4 * i];
+    int32_t bester_abstand = INT32_MAX;
+    for (int k = 0; k < 4; ++k) {
+      const int32_t dr = pixel[0] - palette[k].r;
+      const int32_t dg = pixel[1] - palette[k].g;
+      const int32_t db = pixel[2] - palette[k].b;
+      const int32_t abstand = dr * dr + dg * dg + db * db;
+      if (abstand < bester_abstand) {
+        bester_abstand = abstand;
+        indizes[i] = static_cast<uint8_t>(k);
+      }
+    }
+    fehler += static_cast<uint32_t>(bester_abstand);
+  }
+  return fehler;
+}
+
+#ifdef HEKTO_SSE2
+// Wie SucheIndizesSkalar, aber vier Pixel gleichzeitig.
+uint32_t SucheIndizesSse2(const uint8_t* rgba, const Palette& palette, uint8_t* indizes) {
+  const __m128i null = _mm_setzero_si128();
+  const __m128i ohne_alpha = _mm_set1_epi32(0x00FFFFFF);
+
+  __m128i palettenwerte[4];
+  for (int k = 0; k < 4; ++k) {
+    const auto& f = palette[k];
+    palettenwerte[k] = _mm_setr_epi16(
+        static_cast<int16_t>(f.r), static_cast<int16_t>(f.g), static_cast<int16_t>(f.b), 0,
+        static_cast<int16_t>(f.r), static_cast<int16_t>(f.g), static_cast<int16_t>(f.b), 0);
+  }
+
+  __m128i fehler = null;
+  for (int i = 0; i < 16; i += 4) {
+    const __m128i pixel = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&rgba[4 * i])), ohne_alpha);
+    const __m128i pixel01 = _mm_unpacklo_epi8(pixel, null);  // r g b 0 r g b 0 als int16
+    const __m128i pixel23 = _mm_unpackhi_epi8(pixel, null);
+
+    __m128i bester_abstand = _mm_set1_epi32(INT32_MAX);
+    __m128i bester_index = null;
+    for (int k = 0; k < 4; ++k) {
+      const __m128i d01 = _mm_sub_epi16(pixel01, palettenwerte[k]);
+      const __m128i d23 = _mm_sub_epi16(pixel23, palettenwerte[k]);
+      // [dr^2 + dg^2, db^2] je Pixel
+      const __m128i q01 = _mm_madd_epi16(d01, d01);
+      const __m128i q23 = _mm_madd_epi16(d23, d23);
+      const __m128i abstand = _mm_add_epi32(
+          _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(q01), _mm_castsi128_ps(q23), _MM_SHUFFLE(2, 0, 2, 0))),
+          _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(q01), _mm_castsi128_ps(q23), _MM_SHUFFLE(3, 1, 3, 1))));
+
+      const __m128i kleiner = _mm_cmplt_epi32(abstand, bester_abstand);
+      bester_abstand = _mm_or_si128(_mm_and_si128(kleiner, abstand), _mm_andnot_si128(kleiner, bester_abstand));
+      bester_index = _mm_or_si128(_mm_and_si128(kleiner, _mm_set1_epi32(k)), _mm_andnot_si128(kleiner, bester_index));
+    }
+
+    fehler = _mm_add_epi32(fehler, bester_abstand);
+    alignas(16) int32_t index[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(index), bester_index);
+    for (int j = 0; j < 4; ++j) {
+      indizes[i + j] = static_cast<uint8_t>(index[j]);
+    }
+  }
+
+  alignas(16) uint32_t summe[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(summe), fehler);
+  return summe[0] + summe[1] + summe[2] + summe[3];
+}
+#endif
+
+struct Kandidat final {
+  uint16_t c0 = 0;
+  uint16_t c1 = 0;
+  uint8_t indizes[16] = {};
+  uint32_t fehler = UINT32_MAX;
+};
+
+void Bewerte(const uint8_t* rgba, BlockKodierer kodierer, uint16_t c0, uint16_t c1, Kandidat* bester) {
+  Kandidat kandidat;
+  kandidat.c0 = c0;
+  kandidat.c1 = c1;
+  const auto palette = Baue4FarbPalette(c0, c1);
+#ifdef HEKTO_SSE2
+  kandidat.fehler = (kodierer == BlockKodierer::kSimd) ?
+    SucheIndizesSse2(rgba, palette, kandidat.indizes) : SucheIndizesSkalar(rgba, palette, kandidat.indizes);
+#else
+  (void)kodierer;
+  kandidat.fehler = SucheIndizesSkalar(rgba, palette, kandidat.indizes);
+#endif
+  if (kandidat.fehler < bester->fehler) {
+    *bester = kandidat;
+  }
+}
+
+// Endpunkte, die bei festen Indizes den quadratischen Fehler minimieren.
+bool KleinsteQuadrate(const uint8_t* rgba, const uint8_t* indizes, uint16_t* c0, uint16_t* c1) {
+  // Gewichte der Endpunkte pro Index, mit 3 multipliziert
+  static constexpr int kGewicht0[4] = { 3, 0, 2, 1 };
+  static constexpr int kGewicht1[4] = { 0, 3, 1, 2 };
+
+  int64_t aa = 0;
+  int64_t bb = 0;
+  int64_t ab = 0;
+  int64_t ax[3] = { 0, 0, 0 };
+  int64_t bx[3] = { 0, 0, 0 };
+  for (int i = 0; i < 16; ++i) {
+    const int a = kGewicht0[indizes[i]];
+    const int b = kGewicht1[indizes[i]];
+    aa += a * a;
+    bb += b * b;
+    ab += a * b;
+    for (int k = 0; k < 3; ++k) {
+      ax[k] += a * rgba[4 * i + k];
+      bx[k] += b * rgba[4 * i + k];
+    }
+  }
+
+  const int64_t det = aa * bb - ab * ab;
+  if (det == 0) {
+    return false;
+  }
+  double e0[3];
+  double e1[3];
+  for (int k = 0; k < 3; ++k) {
+    e0[k] = 3.0 * static_cast<double>(ax[k] * bb - bx[k] * ab) / det;
+    e1[k] = 3.0 * static_cast<double>(bx[k] * aa - ax[k] * ab) / det;
+  }
+  *c0 = Nach565(e0[0], e0[1], e0[2]);
+  *c1 = Nach565(e1[0], e1[1], e1[2]);
+  return true;
+}
+
+Kandidat KodiereFarbe(const uint8_t* rgba, BlockKodierer kodierer) {
+  Kandidat bester;
+
+  bool einfarbig = true;
+  int64_t summe[3] = { 0, 0, 0 };
+  int min[3] = { 255, 255, 255 };
+  int max[3] = { 0, 0, 0 };
+  for (int i = 0; i < 16; ++i) {
+    for (int k = 0; k < 3; ++k) {
+      const int wert = rgba[4 * i + k];
+      summe[k] += wert;
+      min[k] = std::min(min[k], wert);
+      max[k] = std::max(max[k], wert);
+      einfarbig = einfarbig && (wert == rgba[k]);
+    }
+  }
+
+  if (einfarbig) {
+    const uint16_t c = Nach565(rgba[0], rgba[1], rgba[2]);
+    Bewerte(rgba, kodierer, c, c, &bester);
+    return bester;
+  }
+
+  // Hauptachse der Farbverteilung per Potenzmethode, ausgehend von der Diagonale der Bounding Box
+  double kovarianz[3][3] = {};
+  for (int i = 0; i < 16; ++i) {
+    double d[3];
+    for (int k = 0; k < 3; ++k) {
+      d[k] = 16 * rgba[4 * i + k] - summe[k];
+    }
+    for (int k = 0; k < 3; ++k) {
+      for (int l = 0; l < 3; ++l) {
+        kovarianz[k][l] += d[k] * d[l];
+      }
+    }
+  }
+
+  double achse[3] = { static_cast<double>(max[0] - min[0]),
+    static_cast<double>(max[1] - min[1]), static_cast<double>(max[2] - min[2]) };
+  for (int iteration = 0; iteration < 4; ++iteration) {
+    double neu[3];
+    for (int k = 0; k < 3; ++k) {
+      neu[k] = kovarianz[k][0] * achse[0] + kovarianz[k][1] * achse[1] + kovarianz[k][2] * achse[2];
+    }
+    const double laenge = std::max({ std::abs(neu[0]), std::abs(neu[1]), std::abs(neu[2]) });
+    if (laenge == 0) {
+      break;
+    }
+    for (int k = 0; k < 3; ++k) {
+      achse[k] = neu[k] / laenge;
+    }
+  }
+
+  int min_pixel = 0;
+  int max_pixel = 0;
+  double min_projektion = INFINITY;
+  double max_projektion = -INFINITY;
+  for (int i = 0; i < 16; ++i) {
+    const double projektion = rgba[4 * i] * achse[0] + rgba[4 * i + 1] * achse[1] + rgba[4 * i + 2] * achse[2];
+    if (projektion < min_projektion) {
+      min_projektion = projektion;
+      min_pixel = i;
+    }
+    if (projektion > max_projektion) {
+      max_projektion = projektion;
+      max_pixel = i;
+    }
+  }
+
+  const uint8_t* hell = &rgba[4 * max_pixel];
+  const uint8_t* dunkel = &rgba[4 * min_pixel];
+  Bewerte(rgba, kodierer, Nach565(hell[0], hell[1], hell[2]), Nach565(dunkel[0], dunkel[1], dunkel[2]), &bester);
+
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    uint16_t c0;
+    uint16_t c1;
+    if (!KleinsteQuadrate(rgba, bester.indizes, &c0, &c1) || (c0 == bester.c0 && c1 == bester.c1)) {
+      break;
+    }
+    Bewerte(rgba, kodierer, c0, c1, &bester);
+  }
+  return bester;
+}
+
+void SchreibeLe(uint64_t wert, size_t anzahl_bytes, uint8_t* ziel) {
+  for (size_t i = 0; i < anzahl_bytes; ++i) {
+    ziel[i] = static_cast<uint8_t>(wert >> (8 * i));
+  }
+}
+
+uint64_t LiesLe(const uint8_t* quelle, size_t anzahl_bytes) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < anzahl_bytes; ++i) {
+    result |= static_cast<uint64_t>(quelle[i]) << (8 * i);
+  }
+  return result;
+}
+
+void SchreibeLe32(uint32_t wert, std::vector<uint8_t>* ziel) {
+  ziel->resize(ziel->size() + 4);
+  SchreibeLe(wert, 4, &(*ziel)[ziel->size() - 4]);
+}
+
+}  // namespace
+
+bool SimdVerfuegbar() {
+#ifdef HEKTO_SSE2
+  return true;
+#else
+  return false;
+#endif
+}
+
+void KodiereDxt3Block(const uint8_t* rgba, BlockKodierer kodierer, uint8_t* ziel) {
+  uint64_t alpha = 0;
+  for (int i = 0; i < 16; ++i) {
+    alpha |= static_cast<uint64_t>((rgba[4 * i + 3] * 15 + 127) / 255) << (4 * i);
+  }
+
+  auto farbe = KodiereFarbe(rgba, kodierer);
+  // Manche Decoder interpretieren c0 <= c1 auch bei DXT3 als Dreifarbenmodus
+  if (farbe.c0 < farbe.c1) {
+    std::swap(farbe.c0, farbe.c1);
+    for (auto& index : farbe.indizes) {
+      index ^= 1;
+    }
+  } else if (farbe.c0 == farbe.c1) {
+    std::fill(std::begin(farbe.indizes), std::end(farbe.indizes), 0);
+  }
+
+  uint32_t indizes = 0;
+  for (int i = 0; i < 16; ++i) {
+    indizes |= static_cast<uint32_t>(farbe.indizes[i]) << (2 * i);
+  }
+
+  SchreibeLe(alpha, 8, &ziel[0]);
+  SchreibeLe(farbe.c0, 2, &ziel[8]);
+  SchreibeLe(farbe.c1, 2, &ziel[10]);
+  SchreibeLe(indizes, 4, &ziel[12]);
+}
+
+std::vector<uint8_t> KodiereDxt3(const Bild& bild, BlockKodierer kodierer) {
+  const int bloecke_x = (bild.breite + 3) / 4;
+  const int bloecke_y = (bild.hoehe + 3) / 4;
+  std::vector<uint8_t> result(static_cast<size_t>(bloecke_x) * bloecke_y * kDxt3BlockGroesse);
+
+  uint8_t block[16 * 4];
+  uint8_t* ziel = result.data();
+  for (int by = 0; by < bloecke_y; ++by) {
+    for (int bx = 0; bx < bloecke_x; ++bx) {
+      for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+          const uint8_t* pixel = bild.Pixel(std::min(4 * bx + x, bild.breite - 1), std::min(4 * by + y, bild.hoehe - 1));
+          std::copy(pixel, pixel + 4, &block[4 * (4 * y + x)]);
+        }
+      }
+      KodiereDxt3Block(block, kodierer, ziel);
+      ziel += kDxt3BlockGroesse;
+    }
+  }
+  return result;
+}
+
+bool SchreibeDds(FILE* fd, int breite, int hoehe, const std::vector<std::vector<uint8_t>>& stufen) {
+  constexpr uint32_t kDdsdCaps = 0x1;
+  constexpr uint32_t kDdsdHeight = 0x2;
+  constexpr uint32_t kDdsdWidth = 0x4;
+  constexpr uint32_t kDdsdPixelFormat = 0x1000;
+  constexpr uint32_t kDdsdMipMapCount = 0x20000;
+  constexpr uint32_t kDdsdLinearSize = 0x80000;
+  constexpr uint32_t kDdpfFourCC = 0x4;
+  constexpr uint32_t kDdsCapsComplex = 0x8;
+  constexpr uint32_t kDdsCapsTexture = 0x1000;
+  constexpr uint32_t kDdsCapsMipMap = 0x400000;
+
+  const bool mipmaps = stufen.size() > 1;
+  std::vector<uint8_t> kopf { 'D', 'D', 'S', ' ' };
+  SchreibeLe32(124, &kopf);
+  SchreibeLe32(kDdsdCaps | kDdsdHeight | kDdsdWidth | kDdsdPixelFormat | kDdsdLinearSize | (mipmaps ? kDdsdMipMapCount : 0), &kopf);
+  SchreibeLe32(static_cast<uint32_t>(hoehe), &kopf);
+  SchreibeLe32(static_cast<uint32_t>(breite), &kopf);
+  SchreibeLe32(static_cast<uint32_t>(stufen.empty() ? 0 : stufen[0].size()), &kopf);
+  SchreibeLe32(0, &kopf);  // Tiefe
+  SchreibeLe32(static_cast<uint32_t>(stufen.size()), &kopf);
+  for (int i = 0; i < 11; ++i) {
+    SchreibeLe32(0, &kopf);
+  }
+
+  // DDS_PIXELFORMAT
+  SchreibeLe32(32, &kopf);
+  SchreibeLe32(kDdpfFourCC, &kopf);
+  kopf.insert(kopf.end(), { 'D', 'X', 'T', '3' });
+  for (int i = 0; i < 5; ++i) {
+    SchreibeLe32(0, &kopf);
+  }
+
+  SchreibeLe32(kDdsCapsTexture | (mipmaps ? kDdsCapsComplex | kDdsCapsMipMap : 0), &kopf);
+  for (int i = 0; i < 4; ++i) {
+    SchreibeLe32(0, &kopf);
+  }
+
+  if (fwrite(kopf.data(), 1, kopf.size(), fd) != kopf.size()) {
+    return false;
+  }
+  for (const auto& stufe : stufen) {
+    if (fwrite(stufe.data(), 1, stufe.size(), fd) != stufe.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Bild DekodiereDxt3(const uint8_t* daten, int breite, int hoehe) {
+  Bild result(breite, hoehe);
+  const int bloecke_x = (breite + 3) / 4;
+  const int bloecke_y = (hoehe + 3) / 4;
+  for (int by = 0; by < bloecke_y; ++by) {
+    for (int bx = 0; bx < bloecke_x; ++bx) {
+      const uint8_t* block = &daten[(static_cast<size_t>(by) * bloecke_x + bx) * kDxt3BlockGroesse];
+      const uint64_t alpha = LiesLe(&block[0], 8);
+      const auto palette = Baue4FarbPalette(static_cast<uint16_t>(LiesLe(&block[8], 2)), static_cast<uint16_t>(LiesLe(&block[10], 2)));
+      const uint32_t indizes = static_cast<uint32_t>(LiesLe(&block[12], 4));
+
+      for (int i = 0; i < 16; ++i) {
+        const int x = 4 * bx + i % 4;
+        const int y = 4 * by + i / 4;
+        if (x >= breite || y >= hoehe) {
+          continue;
+        }
+        const auto& farbe = palette[(indizes >> (2 * i)) & 3];
+        uint8_t* pixel = result.Pixel(x, y);
+        pixel[0] = static_cast<uint8_t>(farbe.r);
+        pixel[1] = static_cast<uint8_t>(farbe.g);
+        pixel[2] = static_cast<uint8_t>(farbe.b);
+        pixel[3] = static_cast<uint8_t>(((alpha >> (4 * i)) & 15) * 17);
+      }
+    }
+  }
+  return result;
+}
+
+bool LiesDds(FILE* fd, Bild* result, std::string* fehler) {
+  uint8_t kopf[128];
+  if (fread(kopf, 1, sizeof(kopf), fd) != sizeof(kopf) || memcmp(kopf, "DDS ", 4) != 0 || LiesLe(&kopf[4], 4) != 124) {
+    *fehler = "keine DDS-Datei";
+    return false;
+  }
+  if (memcmp(&kopf[84], "DXT3", 4) != 0) {
+    *fehler = "nur DXT3 wird unterstuetzt";
+    return false;
+  }
+
+  const auto hoehe = static_cast<int>(LiesLe(&kopf[12], 4));
+  const auto breite = static_cast<int>(LiesLe(&kopf[16], 4));
+  if (breite <= 0 || hoehe <= 0 || breite > 16384 || hoehe > 16384) {
+    *fehler = "ungueltige Bildgroesse";
+    return false;
+  }
+
+  std::vector<uint8_t> daten(static_cast<size_t>((breite + 3) / 4) * ((hoehe + 3) / 4) * kDxt3BlockGroesse);
+  if (fread(daten.data(), 1, daten.size(), fd) != daten.size()) {
+    *fehler = "Bilddaten unvollstaendig";
+    return false;
+  }
+  *result = DekodiereDxt3(daten.data(), breite, hoehe);
+  return true;
+}
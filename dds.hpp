@@ -0,0 +1,50 @@
+// Copyright 2026 Zusitools
+
+#ifndef DDS_HPP_
+#define DDS_HPP_
+
+#include "bild.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEKTO_SSE2
+#endif
+
+constexpr size_t kDxt3BlockGroesse = 16;  ///< Bytes pro 4x4-Block
+
+enum class BlockKodierer {
+  kSimd,  ///< SSE2, falls beim Kompilieren verfuegbar, sonst wie kSkalar
+  kSkalar,
+};
+
+// true, falls kSimd tatsaechlich SSE2 verwendet.
+bool SimdVerfuegbar();
+
+/**
+ * Kodiert einen 4x4-Block (16 RGBA-Pixel, zeilenweise) als DXT3: 4 Bit Alpha pro Pixel,
+ * Farbe mit zwei 565-Endpunkten entlang der Hauptachse, die per kleinster Quadrate nachgebessert werden.
+ * Beide Kodierer liefern bitidentische Ergebnisse.
+ */
+void KodiereDxt3Block(const uint8_t* rgba, BlockKodierer kodierer, uint8_t* ziel);
+
+// Kodiert ein Bild blockweise; Randbloecke werden mit den Randpixeln aufgefuellt.
+std::vector<uint8_t> KodiereDxt3(const Bild& bild, BlockKodierer kodierer);
+
+/**
+ * Schreibt eine DDS-Datei (DXT3) mit den bereits kodierten Mip-Stufen,
+ * beginnend mit der groessten (`breite` x `hoehe`).
+ */
+bool SchreibeDds(FILE* fd, int breite, int hoehe, const std::vector<std::vector<uint8_t>>& stufen);
+
+// Dekodiert ein DXT3-kodiertes Bild, Gegenstueck zu KodiereDxt3.
+Bild DekodiereDxt3(const uint8_t* daten, int breite, int hoehe);
+
+// Liest die groesste Mip-Stufe einer DXT3-kodierten DDS-Datei.
+bool LiesDds(FILE* fd, Bild* result, std::string* fehler);
+
+#endif  // DDS_HPP_
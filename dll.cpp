@@ -2,15 +2,18 @@
 
 #include "dll.hpp"
 
+#include "batch.hpp"
 #include "config.hpp"
 #include "gui.hpp"
 #include "hekto_builder.hpp"
+#include "strecke.hpp"
 
 #include <shlwapi.h>
 #include <windows.h>
 
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
@@ -141,12 +144,12 @@ DLL_EXPORT const char* Bezeichnung() {
 }
 
 DLL_EXPORT float AbstandTafeln() {
-  return 200.0;
+  return static_cast<float>(kAbstandTafeln_m);
 }
 
 DLL_EXPORT float AbstandGleis(uint8_t modus) {
   if (static_cast<Standort>(modus) == Standort::kEigenerStandort) {
-    return 3.0;
+    return static_cast<float>(kAbstandGleis_m);
   } else {
     return 4.0;
   }
@@ -162,15 +165,7 @@ DLL_EXPORT void Config(HWND appHandle) {
 
 const char* GetDateiname(const BauParameter& bau_parameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
   snprintf(g_outDatei, sizeof(g_outDatei)/sizeof(g_outDatei[0]),
-      "%s\\Hekto%s%s%s%s_%s%d_%d%s.ls3", g_zielverzeichnis,
-      (bau_parameter.mast == Mast::kMitMast ? "_Mast" : ""),
-      (bau_parameter.beidseitig == Beidseitig::kBeidseitig ? "_beids" : ""),
-      (bau_parameter.groesse == Groesse::kKlein ? "_klein" : ""),
-      (bau_parameter.rueckstrahlend == Rueckstrahlend::kYes ? "_rueckstrahlend" : ""),
-      (kilometrierung.istNegativ() ? "-" : ""),
-      std::abs(kilometrierung.km),
-      std::abs(kilometrierung.hm),
-      (ueberlaenge_hm.has_value() ? (std::string("_") + std::to_string(*ueberlaenge_hm)).c_str() : ""));
+      "%s\\%s", g_zielverzeichnis, Dateiname(bau_parameter, kilometrierung, ueberlaenge_hm).c_str());
 
   return g_outDatei;
 }
@@ -196,6 +191,11 @@ bool CreateDirectoryWithParents(std::string name) {
 DLL_EXPORT uint8_t Erzeugen(float wert_m, uint8_t modus, const char** datei) {
   *datei = nullptr;
 
+  if (!(std::fabs(wert_m) <= kMaxWert_m) || (g_config.hat_ueberlaenge && std::abs(g_config.basis_km) > kMaxKm)) {
+    Fehlermeldung("Kilometrierung ausserhalb von +/-%d km\n", kMaxKm);
+    return 0;
+  }
+
   Kilometrierung km_basis = g_config.hat_ueberlaenge ?
     Kilometrierung { g_config.basis_km, g_config.basis_hm } : Kilometrierung::fromMeter(wert_m);
   const auto ueberlaenge_hm = g_config.hat_ueberlaenge ?
@@ -214,7 +214,12 @@ DLL_EXPORT uint8_t Erzeugen(float wert_m, uint8_t modus, const char** datei) {
     g_config.groesse,
     g_config.rueckstrahlend,
     g_config.ankerpunkt,
-    g_config.textur
+    g_config.textur,
+    Triangulierung::kFaecher,
+    IndexReihenfolge::kUnveraendert,
+    Detailstufe::kVoll,
+    Attributausgabe::kVollstaendig,
+    Genauigkeit::kVoll,
   };
 
   *datei = GetDateiname(bauparameter, km_basis, ueberlaenge_hm) + g_zusi_datenpfad_laenge;
@@ -223,7 +228,8 @@ DLL_EXPORT uint8_t Erzeugen(float wert_m, uint8_t modus, const char** datei) {
     return 0;
   }
 
-  FILE* fd = fopen(g_outDatei, "w");
+  // Binaer, damit die Datei byte-genau der Ausgabe von hekto_batch entspricht
+  FILE* fd = fopen(g_outDatei, "wb");
   assert(fd != nullptr);
   HektoBuilder::Build(fd, bauparameter, km_basis, ueberlaenge_hm);
   fclose(fd);
@@ -2,125 +2,237 @@
 
 #include "hekto_builder.hpp"
 
+#include "lru_cache.hpp"
 #include "textur.hpp"
+#include "trace.hpp"
+#include "vertex_cache.hpp"
+#include "zahlenformat.hpp"
+#ifdef HEKTO_TEXTUR_ATLAS
+#include "textur_atlas.hpp"
+#endif
 
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
+SubsetBuilder::SubsetBuilder(uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx, Ausgabeformat format)
+    : tagfarbe_(tagfarbe), nachtfarbe_(nachtfarbe), textur_idx_(textur_idx), format_(format) { }
 
-/* Koordinatensystem:
- *  y
- *  ^
- *  |
- *  +-> x
- */
+void SubsetBuilder::AddMesh(const Mesh& mesh) {
+  MeshOps::append(&m_mesh, mesh);
+}
 
-struct TafelParameter final {
-  int breite_mm;
-  int hoehe_mm;
+void SubsetBuilder::AddMesh(std::shared_ptr<const VorformatierterMesh> mesh) {
+  if (mesh->format == format_) {
+    m_vorformatiert.emplace_back(m_mesh.vertices.size(), mesh);
+  }
+  AddMesh(mesh->mesh);
+}
 
-  int ziffernhoehe_mm;
-  int def_ziffernabstand_mm;
-  int max_ziffernabstand_mm;
+namespace {
 
-  int zifferndicke_mm;
+// Puffergroesse fuer einen formatierten Vertex.
+constexpr size_t kMaxVertexLaenge = 1024;
 
-  const Textur& tex_tafel_vorderseite;
-  const Textur& tex_tafel_rueckseite;
-  const std::array<Textur, 11>& tex_ziffern;
-  const Textur& tex_mast;
-  const Textur& tex_transparent;
+template <size_t N>
+char* Literal(char* out, const char (&text)[N]) {
+  std::memcpy(out, text, N - 1);
+  return out + N - 1;
+}
 
-  inline int XLinks() const {
-    return -breite_mm / 2;
+// Zahlenformate je Genauigkeit, `kompakt` ohne Nullen am Ende der Nachkommastellen.
+template <Genauigkeit G, bool kompakt>
+char* FormatPosition(char* out, Koordinate wert) {
+  if constexpr (G == Genauigkeit::kQuantisiert) {
+    return FormatKoordinateMm(out, wert);
+  } else if constexpr (kompakt) {
+    return FormatKoordinateKompakt(out, wert);
+  } else {
+    return FormatKoordinate(out, wert);
   }
+}
 
-  inline int XRechts() const {
-    return -breite_mm / 2 + breite_mm;
+template <Genauigkeit G, bool kompakt>
+char* FormatAttributwert(char* out, float wert) {
+  if constexpr (G == Genauigkeit::kQuantisiert) {
+    return FormatFloatQuantisiert(out, wert);
+  } else if constexpr (kompakt) {
+    return FormatFloatKompakt(out, wert);
+  } else {
+    return FormatFloat(out, wert);
   }
+}
+
+// Schreibt den Vertex im Ausgabeformat nach `puffer` und gibt die Laenge zurueck.
+// Nicht endliche Werte werden nicht abgefangen, siehe ValidateMesh().
+template <Genauigkeit G>
+size_t FormatVertexVollstaendig(char (&puffer)[kMaxVertexLaenge], const Vertex& vertex) {
+  static_assert(kMaxVertexLaenge >= 100 + 7 * kMaxFloatLaenge + 3 * 20, "Puffer zu klein");
+
+  char* p = puffer;
+  p = Literal(p, "<Vertex U=\"");
+  p = FormatAttributwert<G, false>(p, vertex.u1);
+  p = Literal(p, "\" V=\"");
+  p = FormatAttributwert<G, false>(p, vertex.v1);
+  p = Literal(p, "\" U2=\"");
+  p = FormatAttributwert<G, false>(p, vertex.u2);
+  p = Literal(p, "\" V2=\"");
+  p = FormatAttributwert<G, false>(p, vertex.v2);
+  p = Literal(p, "\">\n<p X=\"");
+  p = FormatPosition<G, false>(p, vertex.pos_x);
+  p = Literal(p, "\" Y=\"");
+  p = FormatPosition<G, false>(p, vertex.pos_y);
+  p = Literal(p, "\" Z=\"");
+  p = FormatPosition<G, false>(p, vertex.pos_z);
+  p = Literal(p, "\"/>\n<n X=\"");
+  p = FormatAttributwert<G, false>(p, vertex.nor_x);
+  p = Literal(p, "\" Y=\"");
+  p = FormatAttributwert<G, false>(p, vertex.nor_y);
+  p = Literal(p, "\" Z=\"");
+  p = FormatAttributwert<G, false>(p, vertex.nor_z);
+  p = Literal(p, "\"/>\n</Vertex>\n");
+  return static_cast<size_t>(p - puffer);
+}
 
-  inline int YUnten() const {
-    return -hoehe_mm / 2;
+// Haengt `name_gleich` (z.B. ` X="`), den mit `Format` gekuerzten Wert und das Anfuehrungszeichen an.
+// Ist der Wert 0 und damit Zusis Standardwert, wird nichts angehaengt.
+template <auto Format, size_t N, typename T>
+char* AttributKompakt(char* out, const char (&name_gleich)[N], T wert) {
+  char* const zahl = out + N - 1;
+  char* const ende = Format(zahl, wert);
+  if (ende - zahl == 1 && *zahl == '0') {
+    return out;
   }
+  std::memcpy(out, name_gleich, N - 1);
+  *ende = '"';
+  return ende + 1;
+}
+
+// Wie FormatVertexVollstaendig, aber ohne Attribute mit dem Wert 0 und ohne Nullen am Ende der Nachkommastellen.
+template <Genauigkeit G>
+size_t FormatVertexKompakt(char (&puffer)[kMaxVertexLaenge], const Vertex& vertex) {
+  constexpr auto Wert = FormatAttributwert<G, true>;
+  constexpr auto Position = FormatPosition<G, true>;
+
+  char* p = puffer;
+  p = Literal(p, "<Vertex");
+  p = AttributKompakt<Wert>(p, " U=\"", vertex.u1);
+  p = AttributKompakt<Wert>(p, " V=\"", vertex.v1);
+  p = AttributKompakt<Wert>(p, " U2=\"", vertex.u2);
+  p = AttributKompakt<Wert>(p, " V2=\"", vertex.v2);
+  p = Literal(p, ">\n<p");
+  p = AttributKompakt<Position>(p, " X=\"", vertex.pos_x);
+  p = AttributKompakt<Position>(p, " Y=\"", vertex.pos_y);
+  p = AttributKompakt<Position>(p, " Z=\"", vertex.pos_z);
+  p = Literal(p, "/>\n<n");
+  p = AttributKompakt<Wert>(p, " X=\"", vertex.nor_x);
+  p = AttributKompakt<Wert>(p, " Y=\"", vertex.nor_y);
+  p = AttributKompakt<Wert>(p, " Z=\"", vertex.nor_z);
+  p = Literal(p, "/>\n</Vertex>\n");
+  return static_cast<size_t>(p - puffer);
+}
 
-  inline int YOben() const {
-    return -hoehe_mm / 2 + hoehe_mm;
+size_t FormatVertex(char (&puffer)[kMaxVertexLaenge], const Vertex& vertex, Ausgabeformat format) {
+  const bool kompakt = format.attributausgabe == Attributausgabe::kKompakt;
+  if (format.genauigkeit == Genauigkeit::kQuantisiert) {
+    return kompakt ? FormatVertexKompakt<Genauigkeit::kQuantisiert>(puffer, vertex)
+      : FormatVertexVollstaendig<Genauigkeit::kQuantisiert>(puffer, vertex);
   }
-};
+  return kompakt ? FormatVertexKompakt<Genauigkeit::kVoll>(puffer, vertex)
+    : FormatVertexVollstaendig<Genauigkeit::kVoll>(puffer, vertex);
+}
 
-SubsetBuilder::SubsetBuilder(uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx)
-    : tagfarbe_(tagfarbe), nachtfarbe_(nachtfarbe), textur_idx_(textur_idx) { }
+// Schreibt das Face im Ausgabeformat nach `puffer` und gibt die Laenge zurueck.
+size_t FormatFace(char (&puffer)[kMaxVertexLaenge], const Face& face) {
+  char* p = puffer;
+  p = Literal(p, "<Face i=\"");
+  p = FormatGanzzahl(p, face.i1);
+  *p++ = ';';
+  p = FormatGanzzahl(p, face.i2);
+  *p++ = ';';
+  p = FormatGanzzahl(p, face.i3);
+  p = Literal(p, "\"/>\n");
+  return static_cast<size_t>(p - puffer);
+}
 
-void SubsetBuilder::AddMesh(const Mesh& mesh) {
-  VertexIndex indexOffset = m_mesh.vertices.size();
+}  // namespace
+
+VorformatierterMesh SubsetBuilder::Vorformatieren(Mesh mesh, Ausgabeformat format) {
+  std::string vertices;
+  char puffer[kMaxVertexLaenge];
+  for (const auto& vertex : mesh.vertices) {
+    vertices.append(puffer, FormatVertex(puffer, vertex, format));
+  }
+  return { std::move(mesh), std::move(vertices), format };
+}
+
+void SubsetBuilder::OptimiereVertexCache() {
+  ::OptimiereVertexCache(&m_mesh);
+  m_vorformatiert.clear();
+}
 
-  std::copy(std::begin(mesh.vertices), std::end(mesh.vertices), std::back_inserter(m_mesh.vertices));
-  std::transform(std::begin(mesh.faces), std::end(mesh.faces), std::back_inserter(m_mesh.faces),
-      [indexOffset](const auto& face) -> Face {
-        return { indexOffset + face.i1, indexOffset + face.i2, indexOffset + face.i3 };
-      });
+bool SubsetBuilder::IsEmpty() const {
+  return m_mesh.vertices.size() == 0 || m_mesh.faces.size() == 0;
 }
 
-void SubsetBuilder::Write(FILE* fd) {
-  if (m_mesh.vertices.size() == 0 || m_mesh.faces.size() == 0) {
+void SubsetBuilder::Write(Ausgabe* ausgabe) const {
+  if (IsEmpty()) {
     return;
   }
 
+  WriteKopf(ausgabe, tagfarbe_, nachtfarbe_, textur_idx_);
+  WriteInhalt(ausgabe);
+}
+
+void SubsetBuilder::WriteKopf(Ausgabe* ausgabe, uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx) {
   static const std::array textur_suffixe {
     "",
     "_tunnel",
     "_verwittert_1",
     "_verwittert_2",
   };
-  const auto textur_suffix_idx = std::clamp(textur_idx_, static_cast<size_t>(0), textur_suffixe.size());
+  const auto textur_suffix_idx = std::clamp(textur_idx, static_cast<size_t>(0), textur_suffixe.size());
 
-  fprintf(fd,
+  ausgabe->SchreibeFormatiert(
       "<SubSet Cd=\"%08X\" Ce=\"%08X\">\n"
       "<RenderFlags TexVoreinstellung=\"3\"/>\n"
       "<Textur><Datei Dateiname=\"_Setup\\lib\\milepost\\hektometertafeln_DB_v2\\hektometertafel%s.dds\"/></Textur>\n"
       "<Textur><Datei Dateiname=\"_Setup\\lib\\milepost\\hektometertafeln_DB_v2\\hektometertafel%s.dds\"/></Textur>\n",
-      tagfarbe_, nachtfarbe_, textur_suffixe[textur_suffix_idx], textur_suffixe[textur_suffix_idx]);
-
-  for (const auto& vertex : m_mesh.vertices) {
-    assert(std::isfinite(vertex.pos_x));
-    assert(std::isfinite(vertex.pos_y));
-    assert(std::isfinite(vertex.pos_z));
-    assert(std::isfinite(vertex.nor_x));
-    assert(std::isfinite(vertex.nor_y));
-    assert(std::isfinite(vertex.nor_z));
-    assert(std::isfinite(vertex.u1));
-    assert(std::isfinite(vertex.v1));
-    assert(std::isfinite(vertex.u2));
-    assert(std::isfinite(vertex.v2));
-    fprintf(fd,
-        "<Vertex U=\"%f\" V=\"%f\" U2=\"%f\" V2=\"%f\">\n"
-        "<p X=\"%f\" Y=\"%f\" Z=\"%f\"/>\n"
-        "<n X=\"%f\" Y=\"%f\" Z=\"%f\"/>\n"
-        "</Vertex>\n",
-        vertex.u1, vertex.v1,
-        vertex.u2, vertex.v2,
-        vertex.pos_x, vertex.pos_y, vertex.pos_z,
-        vertex.nor_x, vertex.nor_y, vertex.nor_z);
+      tagfarbe, nachtfarbe, textur_suffixe[textur_suffix_idx], textur_suffixe[textur_suffix_idx]);
+}
+
+void SubsetBuilder::WriteInhalt(Ausgabe* ausgabe) const {
+  auto vorformatiert_it = std::cbegin(m_vorformatiert);
+  for (VertexIndex i = 0; i < m_mesh.vertices.size(); ) {
+    if (vorformatiert_it != std::cend(m_vorformatiert) && vorformatiert_it->first == i) {
+      const auto& vorformatiert = *vorformatiert_it->second;
+      ausgabe->Schreibe(vorformatiert.vertices);
+      i += vorformatiert.mesh.vertices.size();
+      ++vorformatiert_it;
+    } else {
+      char puffer[kMaxVertexLaenge];
+      ausgabe->Schreibe(puffer, FormatVertex(puffer, m_mesh.vertices[i], format_));
+      ++i;
+    }
   }
 
   for (const auto& face : m_mesh.faces) {
-    fprintf(fd,
-        "<Face i=\"%zu;%zu;%zu\"/>\n",
-        face.i1, face.i2, face.i3);
+    char puffer[kMaxVertexLaenge];
+    ausgabe->Schreibe(puffer, FormatFace(puffer, face));
   }
 
-  fprintf(fd, "</SubSet>\n");
+  ausgabe->SchreibeLiteral("</SubSet>\n");
 }
 
-
 namespace {
 
 /* Abgerundete Ecken. Jede Ecke (lo, lu, ro, ru) besteht aus 2 Vertices,
@@ -149,21 +261,21 @@ struct TafelEcken final {
 
 constexpr static int kEckenRadius_mm = 20;
 
+// Zusaetzlicher Vertex im Abstand kEckenOffset_mm von der Ecke,
+// sodass jede abgerundete Ecke aus 3 Vertices gebildet wird.
+constexpr static float kEckenOffset_mm = 5.86;
+
 TafelEcken BaueTafelEcken(Mesh* mesh, const TafelParameter& tp, const Textur& textur) {
   TafelEcken result;
 
   auto MakeVertex = [&](int x, int y) -> VertexIndex {
     return mesh->EmplaceVertex(
-        0, -x / 1000.0, y / 1000.0,
+        0, -Millimeter(x), Millimeter(y),
         -1, 0, 0,
         textur.GetU(x), textur.GetV(y),
         tp.tex_transparent.u_links, tp.tex_transparent.v_unten);
   };
 
-  // Fuege einen zusaetzlichen Vertex im Abstand kEckenOffset_mm von der Ecke ein,
-  // sodass jede abgerundete Ecke aus 3 Vertices gebildet wird.
-  constexpr static float kEckenOffset_mm = 5.86;
-
   result.v_lo_unten = MakeVertex(tp.XLinks(),                    tp.YOben() - kEckenRadius_mm);
   const auto v_lo   = MakeVertex(tp.XLinks() + kEckenOffset_mm,  tp.YOben() - kEckenOffset_mm);
   result.v_lo_oben  = MakeVertex(tp.XLinks() + kEckenRadius_mm,  tp.YOben());
@@ -239,10 +351,10 @@ void MakeQuad(Mesh* mesh, VertexIndex v1, VertexIndex v2, VertexIndex v3,
     auto last_vertex_idx = cur_vertex_idx;
 
     auto cur_vertex = v3_vertex;
-    cur_vertex.pos_y = -*it / 1000.0;
+    cur_vertex.pos_y = -Millimeter(*it);
 
     // Berechne t mit v4 = v3 + t(v4-v3)
-    const float t = (cur_vertex.pos_y - v3_vertex.pos_y) / (v4_vertex.pos_y - v3_vertex.pos_y);
+    const float t = static_cast<float>(cur_vertex.pos_y - v3_vertex.pos_y) / (v4_vertex.pos_y - v3_vertex.pos_y);
     assert(std::isfinite(t));
     cur_vertex.u1 += t * (v4_vertex.u1 - v3_vertex.u1);
     cur_vertex.u2 += t * (v4_vertex.u2 - v3_vertex.u2);
@@ -304,25 +416,304 @@ Mesh TafelRueckseiteBuilder::Build(const TafelParameter& tp) {
   return result;
 }
 
+Mesh TafelRueckseiteBuilder::BuildGrob(const TafelParameter& tp) {
+  Mesh result;
+
+  auto MakeVertex = [&](int x, int y) -> VertexIndex {
+    return result.EmplaceVertex(
+        0, -Millimeter(x), Millimeter(y),
+        -1, 0, 0,
+        tp.tex_tafel_rueckseite.GetU(x), tp.tex_tafel_rueckseite.GetV(y),
+        tp.tex_transparent.u_links, tp.tex_transparent.v_unten);
+  };
+
+  const auto v_lu = MakeVertex(tp.XLinks(), tp.YUnten());
+  const auto v_lo = MakeVertex(tp.XLinks(), tp.YOben());
+  const auto v_ro = MakeVertex(tp.XRechts(), tp.YOben());
+  const auto v_ru = MakeVertex(tp.XRechts(), tp.YUnten());
+  result.faces.emplace_back(v_lu, v_lo, v_ro);
+  result.faces.emplace_back(v_ro, v_ru, v_lu);
+
+  return result;
+}
+
 
 namespace {
   constexpr int kYTafelMitte_mm = 20;  // hier beruehren sich die Meshes von unterer und oberer Zahl
 
   // Default-Beschnittzugabe der Ziffern nach oben und unten
   constexpr int kYAbstandZiffern_mm = 25;
+
+  // Plus- und Minuszeichen liegen 1 cm vor der Tafel
+  constexpr Koordinate kXPlusMinus = -Millimeter(10);
+}  // namespace
+
+namespace {
+
+struct Punkt final {
+  int x;
+  int y;
+
+  bool operator==(const Punkt& other) const { return x == other.x && y == other.y; }
+  bool operator!=(const Punkt& other) const { return !(*this == other); }
+};
+
+// Doppelte vorzeichenbehaftete Flaeche des Dreiecks a-b-c (> 0: gegen den Uhrzeigersinn)
+int64_t Kreuzprodukt(const Punkt& a, const Punkt& b, const Punkt& c) {
+  return static_cast<int64_t>(b.x - a.x) * (c.y - a.y) - static_cast<int64_t>(b.y - a.y) * (c.x - a.x);
+}
+
+// 4 Ecken mit je 3 Vertices plus 2 Stuetzpunkte pro Ziffer in beiden Zeilen
+using Polygon = InlineVector<Punkt, 12 + 4 * 2 * kMaxZiffern>;
+
+// Entfernt doppelte Punkte und Spitzen (Kanten, die auf sich selbst zuruecklaufen).
+// Das entsteht, wenn die Ziffern an den Tafelrand stossen.
+void Bereinige(Polygon* polygon) {
+  bool geaendert = true;
+  while (geaendert && polygon->size() >= 3) {
+    geaendert = false;
+    for (size_t i = 0; i < polygon->size(); ++i) {
+      const auto& vorher = (*polygon)[(i + polygon->size() - 1) % polygon->size()];
+      const auto& punkt = (*polygon)[i];
+      const auto& nachher = (*polygon)[(i + 1) % polygon->size()];
+      const bool spitze = Kreuzprodukt(vorher, punkt, nachher) == 0
+        && static_cast<int64_t>(punkt.x - vorher.x) * (nachher.x - punkt.x) + static_cast<int64_t>(punkt.y - vorher.y) * (nachher.y - punkt.y) < 0;
+      if (punkt == vorher || spitze) {
+        polygon->erase_at(i);
+        geaendert = true;
+        break;
+      }
+    }
+  }
+}
+
+// Ear Clipping eines einfachen Polygons gegen den Uhrzeigersinn. Erzeugt n-2 Dreiecke ohne degenerierte
+// Dreiecke; kollineare Punkte auf dem Rand bleiben als Vertices erhalten (keine T-Kreuzungen).
+// Unter den moeglichen Ohren wird jeweils das mit der besten Form abgeschnitten.
+template <typename Fn>
+void TrianguliereEarClipping(Polygon polygon, Fn&& make_face) {
+  Bereinige(&polygon);
+
+  while (polygon.size() >= 3) {
+    const size_t n = polygon.size();
+    size_t bestes_ohr = n;
+    double beste_form = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const auto& a = polygon[(i + n - 1) % n];
+      const auto& b = polygon[i];
+      const auto& c = polygon[(i + 1) % n];
+      const int64_t flaeche = Kreuzprodukt(a, b, c);
+      if (flaeche <= 0) {
+        continue;
+      }
+
+      // Nur nicht-konvexe Punkte koennen im Ohr liegen
+      bool frei = true;
+      for (size_t j = 0; j < n && frei; ++j) {
+        const auto& p = polygon[j];
+        if (p == a || p == b || p == c || Kreuzprodukt(polygon[(j + n - 1) % n], p, polygon[(j + 1) % n]) > 0) {
+          continue;
+        }
+        // Auch Punkte auf dem Rand des Ohrs schliessen es aus
+        frei = !(Kreuzprodukt(a, b, p) >= 0 && Kreuzprodukt(b, c, p) >= 0 && Kreuzprodukt(c, a, p) >= 0);
+      }
+      if (!frei) {
+        continue;
+      }
+
+      auto Laenge2 = [](const Punkt& p, const Punkt& q) {
+        return static_cast<double>(p.x - q.x) * (p.x - q.x) + static_cast<double>(p.y - q.y) * (p.y - q.y);
+      };
+      const double form = flaeche / std::max({ Laenge2(a, b), Laenge2(b, c), Laenge2(c, a) });
+      if (form > beste_form) {
+        beste_form = form;
+        bestes_ohr = i;
+      }
+    }
+
+    if (bestes_ohr == n) {
+      // Nur noch kollineare Punkte (Flaeche 0)
+      assert(n == 3 || std::all_of(std::begin(polygon), std::end(polygon),
+            [&](const Punkt& p) { return Kreuzprodukt(polygon[0], polygon[1], p) == 0; }));
+      return;
+    }
+
+    make_face(polygon[(bestes_ohr + n - 1) % n], polygon[bestes_ohr], polygon[(bestes_ohr + 1) % n]);
+    polygon.erase_at(bestes_ohr);
+    Bereinige(&polygon);
+  }
+}
+
 }  // namespace
 
-Mesh TafelVorderseiteBuilder::Build(const TafelParameter& tp, const std::vector<int>& stuetzpunkte_oben, const std::vector<int>& stuetzpunkte_unten) {
+Mesh TafelVorderseiteBuilder::BuildMinimal(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten) {
+  Mesh result;
+
+  InlineVector<std::pair<Punkt, VertexIndex>, Polygon::capacity()> vertices;
+  auto GetVertex = [&](const Punkt& p) -> VertexIndex {
+    for (const auto& [punkt, idx] : vertices) {
+      if (punkt == p) {
+        return idx;
+      }
+    }
+    const auto idx = result.EmplaceVertex(
+        0, -Millimeter(p.x), Millimeter(p.y),
+        -1, 0, 0,
+        tp.tex_tafel_vorderseite.GetU(p.x), tp.tex_tafel_vorderseite.GetV(p.y),
+        tp.tex_transparent.u_links, tp.tex_transparent.v_unten);
+    vertices.emplace_back(p, idx);
+    return idx;
+  };
+
+  // Wie in BaueTafelEcken werden die Eckpunkte auf ganze Millimeter abgeschnitten.
+  auto P = [](int x, int y) { return Punkt { x, y }; };
+
+  const int y_ziffern_oben = tp.YOben() - kEckenRadius_mm;
+  const int y_ziffern_unten = kYTafelMitte_mm - tp.ziffernhoehe_mm - 2 * kYAbstandZiffern_mm;
+
+  const Punkt lo_unten = P(tp.XLinks(),                    tp.YOben() - kEckenRadius_mm);
+  const Punkt lo       = P(tp.XLinks() + kEckenOffset_mm,  tp.YOben() - kEckenOffset_mm);
+  const Punkt lo_oben  = P(tp.XLinks() + kEckenRadius_mm,  tp.YOben());
+  const Punkt ro_oben  = P(tp.XRechts() - kEckenRadius_mm, tp.YOben());
+  const Punkt ro       = P(tp.XRechts() - kEckenOffset_mm, tp.YOben() - kEckenOffset_mm);
+  const Punkt ro_unten = P(tp.XRechts(),                   tp.YOben() - kEckenRadius_mm);
+  const Punkt ru_oben  = P(tp.XRechts(),                   tp.YUnten() + kEckenRadius_mm);
+  const Punkt ru       = P(tp.XRechts() - kEckenOffset_mm, tp.YUnten() + kEckenOffset_mm);
+  const Punkt ru_unten = P(tp.XRechts() - kEckenRadius_mm, tp.YUnten());
+  const Punkt lu_unten = P(tp.XLinks() + kEckenRadius_mm,  tp.YUnten());
+  const Punkt lu       = P(tp.XLinks() + kEckenOffset_mm,  tp.YUnten() + kEckenOffset_mm);
+  const Punkt lu_oben  = P(tp.XLinks(),                    tp.YUnten() + kEckenRadius_mm);
+
+  // Stuetzpunkte beider Zeilen auf der Tafelmitte, die echt zwischen x1 und x2 liegen, in Laufrichtung
+  auto AddMitte = [&](Polygon* polygon, int x1, int x2) {
+    InlineVector<int, 4 * kMaxZiffern> xs;
+    for (const auto* stuetzpunkte : { &stuetzpunkte_oben, &stuetzpunkte_unten }) {
+      for (const auto x : *stuetzpunkte) {
+        if (x > std::min(x1, x2) && x < std::max(x1, x2)) {
+          xs.push_back(x);
+        }
+      }
+    }
+    if (x1 < x2) {
+      std::sort(std::begin(xs), std::end(xs));
+    } else {
+      std::sort(std::begin(xs), std::end(xs), std::greater<int>());
+    }
+    for (const auto x : xs) {
+      polygon->push_back(P(x, kYTafelMitte_mm));
+    }
+  };
+
+  auto MakeFace = [&](const Punkt& a, const Punkt& b, const Punkt& c) {
+    // Die Faces der Tafel sind im Uhrzeigersinn orientiert
+    result.faces.emplace_back(GetVertex(a), GetVertex(c), GetVertex(b));
+  };
+
+  // Die Flaeche um die Ziffern wird in vier einfache Polygone zerlegt, jeweils gegen den Uhrzeigersinn.
+
+  // Oben: von der Oberkante der oberen Ziffern bis zum Tafelrand
+  Polygon oben { lo_unten };
+  for (const auto x : stuetzpunkte_oben) {
+    oben.push_back(P(x, y_ziffern_oben));
+  }
+  for (const auto& p : { ro_unten, ro, ro_oben, lo_oben, lo }) {
+    oben.push_back(p);
+  }
+  TrianguliereEarClipping(oben, MakeFace);
+
+  // Unten: von der Unterkante der unteren Ziffern bis zum Tafelrand
+  Polygon unten { lu_oben, lu, lu_unten, ru_unten, ru, ru_oben };
+  for (auto it = std::crbegin(stuetzpunkte_unten); it != std::crend(stuetzpunkte_unten); ++it) {
+    unten.push_back(P(*it, y_ziffern_unten));
+  }
+  TrianguliereEarClipping(unten, MakeFace);
+
+  // Links
+  Polygon links { lo_unten, lu_oben, P(stuetzpunkte_unten.front(), y_ziffern_unten), P(stuetzpunkte_unten.front(), kYTafelMitte_mm) };
+  AddMitte(&links, stuetzpunkte_unten.front(), stuetzpunkte_oben.front());
+  links.push_back(P(stuetzpunkte_oben.front(), kYTafelMitte_mm));
+  links.push_back(P(stuetzpunkte_oben.front(), y_ziffern_oben));
+  TrianguliereEarClipping(links, MakeFace);
+
+  // Rechts
+  Polygon rechts { ro_unten, P(stuetzpunkte_oben.back(), y_ziffern_oben), P(stuetzpunkte_oben.back(), kYTafelMitte_mm) };
+  AddMitte(&rechts, stuetzpunkte_oben.back(), stuetzpunkte_unten.back());
+  rechts.push_back(P(stuetzpunkte_unten.back(), kYTafelMitte_mm));
+  rechts.push_back(P(stuetzpunkte_unten.back(), y_ziffern_unten));
+  rechts.push_back(ru_oben);
+  TrianguliereEarClipping(rechts, MakeFace);
+
+  return result;
+}
+
+Mesh TafelVorderseiteBuilder::BuildGrob(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten) {
+  assert(stuetzpunkte_oben.size() >= 2);
+  assert(stuetzpunkte_unten.size() >= 2);
+
+  TraceBereich bereich("Vorderseite");
+
+  Mesh result;
+
+  InlineVector<std::pair<Punkt, VertexIndex>, 6 * 4> vertices;  // hoechstens 6 Rechtecke
+  auto GetVertex = [&](const Punkt& p) -> VertexIndex {
+    for (const auto& [punkt, idx] : vertices) {
+      if (punkt == p) {
+        return idx;
+      }
+    }
+    const auto idx = result.EmplaceVertex(
+        0, -Millimeter(p.x), Millimeter(p.y),
+        -1, 0, 0,
+        tp.tex_tafel_vorderseite.GetU(p.x), tp.tex_tafel_vorderseite.GetV(p.y),
+        tp.tex_transparent.u_links, tp.tex_transparent.v_unten);
+    vertices.emplace_back(p, idx);
+    return idx;
+  };
+
+  // Wie in BuildMinimal sind die Faces im Uhrzeigersinn orientiert
+  auto MakeRechteck = [&](int x_links, int y_unten, int x_rechts, int y_oben) {
+    if (x_links >= x_rechts || y_unten >= y_oben) {
+      return;
+    }
+    const auto v_lu = GetVertex({ x_links, y_unten });
+    const auto v_lo = GetVertex({ x_links, y_oben });
+    const auto v_ro = GetVertex({ x_rechts, y_oben });
+    const auto v_ru = GetVertex({ x_rechts, y_unten });
+    result.faces.emplace_back(v_lu, v_lo, v_ro);
+    result.faces.emplace_back(v_ro, v_ru, v_lu);
+  };
+
+  const int y_ziffern_oben = tp.YOben() - kEckenRadius_mm;
+  const int y_ziffern_unten = kYTafelMitte_mm - tp.ziffernhoehe_mm - 2 * kYAbstandZiffern_mm;
+
+  MakeRechteck(tp.XLinks(), y_ziffern_oben, tp.XRechts(), tp.YOben());
+  MakeRechteck(tp.XLinks(), kYTafelMitte_mm, stuetzpunkte_oben.front(), y_ziffern_oben);
+  MakeRechteck(stuetzpunkte_oben.back(), kYTafelMitte_mm, tp.XRechts(), y_ziffern_oben);
+  MakeRechteck(tp.XLinks(), y_ziffern_unten, stuetzpunkte_unten.front(), kYTafelMitte_mm);
+  MakeRechteck(stuetzpunkte_unten.back(), y_ziffern_unten, tp.XRechts(), kYTafelMitte_mm);
+  MakeRechteck(tp.XLinks(), tp.YUnten(), tp.XRechts(), y_ziffern_unten);
+
+  return result;
+}
+
+Mesh TafelVorderseiteBuilder::Build(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten,
+    Triangulierung triangulierung) {
   assert(stuetzpunkte_oben.size() >= 2);
   assert(stuetzpunkte_unten.size() >= 2);
 
+  TraceBereich bereich("Vorderseite");
+
+  if (triangulierung == Triangulierung::kMinimal) {
+    return BuildMinimal(tp, stuetzpunkte_oben, stuetzpunkte_unten);
+  }
+
   Mesh result;
 
   auto ecken = BaueTafelEcken(&result, tp, tp.tex_tafel_vorderseite);
 
   auto MakeVertex = [&](int x, int y) -> VertexIndex {
     return result.EmplaceVertex(
-        0, -x / 1000.0, y / 1000.0,
+        0, -Millimeter(x), Millimeter(y),
         -1, 0, 0,
         tp.tex_tafel_vorderseite.GetU(x), tp.tex_tafel_vorderseite.GetV(y),
         tp.tex_transparent.u_links, tp.tex_transparent.v_unten);
@@ -413,13 +804,17 @@ Mesh TafelVorderseiteBuilder::Build(const TafelParameter& tp, const std::vector<
 
 namespace {
 
-std::vector<int> GetZiffern(int zahl) {
-  std::vector<int> result;
+using ZiffernListe = InlineVector<int, kMaxZiffern>;
+using Abstaende = InlineVector<int, kMaxZiffern + 1>;
+
+ZiffernListe GetZiffern(int zahl) {
+  ZiffernListe result;
   while (zahl >= 10) {
-    result.insert(result.begin(), zahl % 10);
+    result.push_back(zahl % 10);
     zahl /= 10;
   }
-  result.insert(result.begin(), zahl);
+  result.push_back(zahl);
+  std::reverse(std::begin(result), std::end(result));
   return result;
 }
 
@@ -451,9 +846,9 @@ int GetZiffernAbstand(const TafelParameter& tp, int ziffer_links, int ziffer_rec
   return std::min(anzahl_ziffern * tp.max_ziffernabstand_mm, result);
 }
 
-std::vector<int> GetDefaultAbstaende(const TafelParameter& tp, const std::vector<int>& ziffern) {
+Abstaende GetDefaultAbstaende(const TafelParameter& tp, const ZiffernListe& ziffern) {
   assert(ziffern.size() >= 1);
-  std::vector<int> result = { GetZiffernAbstand(tp, -1, ziffern.front()) };
+  Abstaende result = { GetZiffernAbstand(tp, -1, ziffern.front()) };
   for (size_t i = 0; i < ziffern.size() - 1; ++i) {
     result.push_back(GetZiffernAbstand(tp, ziffern[i], ziffern[i + 1]));
   }
@@ -464,7 +859,7 @@ std::vector<int> GetDefaultAbstaende(const TafelParameter& tp, const std::vector
 
 // Berechnet Ziffernabstaende so, dass die Ziffern in die angegebene Gesamtbreite passen
 // und alle Abstaende >= 0 sind.
-std::vector<int> GetAbstaende(const TafelParameter& tp, const std::vector<int>& ziffern, const std::array<Textur, 11>& ziffern_texturen, int gesamtbreite_mm, bool unten) {
+Abstaende GetAbstaende(const TafelParameter& tp, const ZiffernListe& ziffern, const std::array<Textur, 11>& ziffern_texturen, int gesamtbreite_mm, bool unten) {
   auto result = GetDefaultAbstaende(tp, ziffern);
   // result kann an dieser Stelle noch negative Werte enthalten,
   // die durch spaeteres Erhoehen der Ziffernabstaende ausgeglichen werden koennen.
@@ -497,6 +892,12 @@ std::vector<int> GetAbstaende(const TafelParameter& tp, const std::vector<int>&
       ++j;
     }
   } else if (spielraum > 0) {
+    // Negatives Kerning ist in breite_summe als 0 enthalten, die Abstaende werden aber
+    // ausgehend vom tatsaechlichen (negativen) Wert vergroessert.
+    for (const auto& abstand : result) {
+      spielraum -= std::min(0, abstand);
+    }
+
     if (unten && (ziffern.size() > 1)) {
       // Ueberlaenge: Lasse Platz zwischen der ersten Ziffer und den restlichen Ziffern
       const auto abstand = std::min(spielraum, 2 * tp.max_ziffernabstand_mm - result[1]);
@@ -556,9 +957,12 @@ using Intervall = std::pair<T, T>;
 // Berechnet unter Beruecksichtigung des maximalen Ziffernabstandes aus `tp`
 // die Intervalle, in denen die X-Koordinaten der Vertices fuer die
 // gegebenen Ziffern mit den gegebenen Abstaenden liegen koennen.
-std::vector<Intervall<int>> GetStuetzpunktIntervalle(const TafelParameter& tp, const std::vector<int>& ziffern, const std::vector<int>& abstaende) {
+template <typename T>
+using Intervalle = InlineVector<Intervall<T>, 2 * kMaxZiffern>;
+
+Intervalle<int> GetStuetzpunktIntervalle(const TafelParameter& tp, const ZiffernListe& ziffern, const Abstaende& abstaende) {
   assert(abstaende.size() == ziffern.size() + 1);
-  std::vector<Intervall<int>> result;
+  Intervalle<int> result;
 
   // Linken Stuetzpunkt, wenn moeglich, mit der linken Tafelseite zusammenfallen lassen
   int offset = tp.XLinks() + abstaende.front();
@@ -599,10 +1003,10 @@ std::vector<Intervall<int>> GetStuetzpunktIntervalle(const TafelParameter& tp, c
 //   stuetzpunkte1: X          X         X
 //   stuetzpunkte2:            X         X
 template <typename T>
-std::pair<std::vector<T>, std::vector<T>> GetStuetzpunkte(
-    std::vector<Intervall<T>> stuetzpunkt_intervalle_1,
-    std::vector<Intervall<T>> stuetzpunkt_intervalle_2) {
-  std::vector<T> stuetzpunkte1, stuetzpunkte2;
+std::pair<InlineVector<T, 2 * kMaxZiffern>, InlineVector<T, 2 * kMaxZiffern>> GetStuetzpunkte(
+    const Intervalle<T>& stuetzpunkt_intervalle_1,
+    const Intervalle<T>& stuetzpunkt_intervalle_2) {
+  InlineVector<T, 2 * kMaxZiffern> stuetzpunkte1, stuetzpunkte2;
 
   auto it1 = std::cbegin(stuetzpunkt_intervalle_1);
   auto end1 = std::cend(stuetzpunkt_intervalle_1);
@@ -610,9 +1014,9 @@ std::pair<std::vector<T>, std::vector<T>> GetStuetzpunkte(
   auto end2 = std::cend(stuetzpunkt_intervalle_2);
 
   auto NeuerStuetzpunkt = [&](
-      typename std::vector<Intervall<T>>::const_iterator& it,
-      typename std::vector<Intervall<T>>::const_iterator& end,
-      std::vector<T>& stuetzpunkte,
+      typename Intervalle<T>::const_iterator& it,
+      typename Intervalle<T>::const_iterator& end,
+      InlineVector<T, 2 * kMaxZiffern>& stuetzpunkte,
       T stuetzpunkt) {
     assert(it != end);
     assert(stuetzpunkt >= it->first);
@@ -661,44 +1065,62 @@ std::pair<std::vector<T>, std::vector<T>> GetStuetzpunkte(
 
 }  // namespace
 
-Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge) {
+ZiffernLayout ZiffernBuilder::Layout(const TafelParameter& tp, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge) {
   assert(zahl_oben >= 0);
-  assert(zahl_oben <= 999);
+  assert(zahl_oben <= kMaxKm);
   assert(ziffer_unten >= 0);
   assert(ziffer_unten <= 9);
   assert(!ueberlaenge.has_value() || (ueberlaenge >= 0));
   assert(!ueberlaenge.has_value() || (ueberlaenge <= kMaxUeberlaenge));
 
-  const auto& ziffern_oben = GetZiffern(zahl_oben);
-  assert(ziffern_oben.size() >= 1);
-  assert(ziffern_oben.size() <= 3);
+  ZiffernLayout result;
+  result.ziffern_oben = GetZiffern(zahl_oben);
+  assert(result.ziffern_oben.size() >= 1);
+  assert(result.ziffern_oben.size() <= 3);
 
-  std::vector<int> ziffern_unten = { ziffer_unten };
+  result.ziffern_unten = { ziffer_unten };
   if (ueberlaenge.has_value()) {
-    const auto& ziffern_ueberlaenge = GetZiffern(*ueberlaenge);
-    ziffern_unten.insert(std::end(ziffern_unten), std::cbegin(ziffern_ueberlaenge), std::cend(ziffern_ueberlaenge));
+    for (const auto ziffer : GetZiffern(*ueberlaenge)) {
+      result.ziffern_unten.push_back(ziffer);
+    }
   }
-  assert(ziffern_unten.size() >= 1);
-  assert(ziffern_unten.size() <= 3);
+  assert(result.ziffern_unten.size() >= 1);
+  assert(result.ziffern_unten.size() <= 3);
 
   // Ziffernabstaende berechnen
-  const auto abstaende_oben = GetAbstaende(tp, ziffern_oben, tp.tex_ziffern, tp.breite_mm, false);
-  assert(abstaende_oben.size() == ziffern_oben.size() + 1);
-  const auto abstaende_unten = GetAbstaende(tp, ziffern_unten, tp.tex_ziffern, tp.breite_mm, true);
-  assert(abstaende_unten.size() == ziffern_unten.size() + 1);
+  result.abstaende_oben = GetAbstaende(tp, result.ziffern_oben, tp.tex_ziffern, tp.breite_mm, false);
+  assert(result.abstaende_oben.size() == result.ziffern_oben.size() + 1);
+  result.abstaende_unten = GetAbstaende(tp, result.ziffern_unten, tp.tex_ziffern, tp.breite_mm, true);
+  assert(result.abstaende_unten.size() == result.ziffern_unten.size() + 1);
 
   // Stuetzpunkt-Intervalle berechnen
-  const auto& stuetzpunkt_intervalle_oben = GetStuetzpunktIntervalle(tp, ziffern_oben, abstaende_oben);
-  const auto& stuetzpunkt_intervalle_unten = GetStuetzpunktIntervalle(tp, ziffern_unten, abstaende_unten);
+  result.intervalle_oben = GetStuetzpunktIntervalle(tp, result.ziffern_oben, result.abstaende_oben);
+  result.intervalle_unten = GetStuetzpunktIntervalle(tp, result.ziffern_unten, result.abstaende_unten);
 
   // Stuetzpunkte berechnen
-  const auto& [ stuetzpunkte_oben, stuetzpunkte_unten ] = GetStuetzpunkte(stuetzpunkt_intervalle_oben, stuetzpunkt_intervalle_unten);
+  std::tie(result.stuetzpunkte_oben, result.stuetzpunkte_unten) = GetStuetzpunkte(result.intervalle_oben, result.intervalle_unten);
+  return result;
+}
+
+Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge,
+    Detailstufe detailstufe) {
+  TraceBereich layout_bereich("Layout");
+  const auto layout = Layout(tp, zahl_oben, ziffer_unten, ueberlaenge);
+  const auto& ziffern_oben = layout.ziffern_oben;
+  const auto& ziffern_unten = layout.ziffern_unten;
+  const auto& abstaende_oben = layout.abstaende_oben;
+  const auto& abstaende_unten = layout.abstaende_unten;
+  const auto& stuetzpunkte_oben = layout.stuetzpunkte_oben;
+  const auto& stuetzpunkte_unten = layout.stuetzpunkte_unten;
+
+  layout_bereich.Beende();
+  TraceBereich ziffern_bereich("Ziffern");
 
   Mesh result;
 
   auto MakeVertex = [&tp, &result](int x, int y, float u2, float v2) -> VertexIndex {
     return result.EmplaceVertex(
-        0, -x / 1000.0, y / 1000.0,
+        0, -Millimeter(x), Millimeter(y),
         -1, 0, 0,
         tp.tex_tafel_vorderseite.GetU(x),
         tp.tex_tafel_vorderseite.GetV(y),
@@ -708,7 +1130,7 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
   auto MakeZiffer = [&tp, &result, &MakeVertex](int ziffer,
       int y_oben_mm, int y_unten_mm, int abstand_oben_mm, int abstand_unten_mm,
       int x_links_mm, int x_rechts_mm, int abstand_links_mm, int abstand_rechts_mm,
-      const std::vector<int> stuetzpunkte, bool istOben) {
+      const Stuetzpunkte& stuetzpunkte, bool istOben) {
     assert(abstand_links_mm >= 0);
     assert(abstand_rechts_mm >= 0);
 
@@ -741,8 +1163,8 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
     }
   };
 
-  auto MakeZiffern = [&tp, &MakeZiffer](const std::vector<int>& ziffern, const std::vector<int>& x_abstaende,
-      const std::vector<int>& stuetzpunkte, const std::vector<int>& stuetzpunkte2,
+  auto MakeZiffern = [&tp, &MakeZiffer](const ZiffernListe& ziffern, const Abstaende& x_abstaende,
+      const Stuetzpunkte& stuetzpunkte, const Stuetzpunkte& stuetzpunkte2,
       int y_oben_mm, int y_unten_mm, int abstand_oben_mm, int abstand_unten_mm, bool istOben) {
     assert(x_abstaende.size() == ziffern.size() + 1);
     assert(stuetzpunkte.size() == 2 * ziffern.size());
@@ -778,12 +1200,16 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
     }
   };
 
-  MakeZiffern(ziffern_oben, abstaende_oben, stuetzpunkte_oben, stuetzpunkte_unten,
+  // Ohne Stuetzpunkte der jeweils anderen Zeile entstehen an der Tafelmitte T-Verbindungen,
+  // die aus grosser Entfernung nicht sichtbar sind.
+  const bool mit_stuetzpunkten = detailstufe == Detailstufe::kVoll;
+
+  MakeZiffern(ziffern_oben, abstaende_oben, stuetzpunkte_oben, mit_stuetzpunkten ? stuetzpunkte_unten : Stuetzpunkte {},
       tp.YOben() - kEckenRadius_mm, kYTafelMitte_mm,
       (tp.YOben() - kEckenRadius_mm - tp.ziffernhoehe_mm - kYAbstandZiffern_mm) - kYTafelMitte_mm, kYAbstandZiffern_mm,
       true);
 
-  MakeZiffern(ziffern_unten, abstaende_unten, stuetzpunkte_unten, stuetzpunkte_oben,
+  MakeZiffern(ziffern_unten, abstaende_unten, stuetzpunkte_unten, mit_stuetzpunkten ? stuetzpunkte_oben : Stuetzpunkte {},
       kYTafelMitte_mm, kYTafelMitte_mm - tp.ziffernhoehe_mm - 2 * kYAbstandZiffern_mm,
       kYAbstandZiffern_mm, kYAbstandZiffern_mm, false);
 
@@ -801,10 +1227,10 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
     const auto x_links = std::max(x_rechts_regulaer - breite_regulaer, tp.XLinks() + abstand_x);
     const auto x_rechts = std::max(x_rechts_regulaer, x_links + breite_min);
 
-    const auto v1 = plusminus_mesh.EmplaceVertex(-0.01, -x_rechts / 1000.0, y_unten / 1000.0, -1, 0, 0, .103, .915, .103, .915);
-    const auto v2 = plusminus_mesh.EmplaceVertex(-0.01,  -x_links / 1000.0, y_unten / 1000.0, -1, 0, 0, .103, .915, .103, .915);
-    const auto v3 = plusminus_mesh.EmplaceVertex(-0.01,  -x_links / 1000.0,  y_oben / 1000.0, -1, 0, 0, .103, .915, .103, .915);
-    const auto v4 = plusminus_mesh.EmplaceVertex(-0.01, -x_rechts / 1000.0,  y_oben / 1000.0, -1, 0, 0, .103, .915, .103, .915);
+    const auto v1 = plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(x_rechts), Millimeter(y_unten), -1, 0, 0, .103, .915, .103, .915);
+    const auto v2 = plusminus_mesh.EmplaceVertex(kXPlusMinus,  -Millimeter(x_links), Millimeter(y_unten), -1, 0, 0, .103, .915, .103, .915);
+    const auto v3 = plusminus_mesh.EmplaceVertex(kXPlusMinus,  -Millimeter(x_links),  Millimeter(y_oben), -1, 0, 0, .103, .915, .103, .915);
+    const auto v4 = plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(x_rechts),  Millimeter(y_oben), -1, 0, 0, .103, .915, .103, .915);
     plusminus_mesh.faces.emplace_back(v1, v2, v3);
     plusminus_mesh.faces.emplace_back(v3, v4, v1);
   }
@@ -816,34 +1242,34 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
     const auto x = tp.XLinks() + abstaende_unten[0] + tp.tex_ziffern[ziffern_unten[0]].breite_mm + abstaende_unten[1] / 2;
     const auto y = ((tp.YUnten() + kEckenRadius_mm) + kYTafelMitte_mm) / 2;
 
-    const auto xs = std::vector<int> {
+    const auto xs = std::array<int, 4> {
       x - tp.zifferndicke_mm / 2 - tp.zifferndicke_mm,
       x - tp.zifferndicke_mm / 2,
       x + tp.zifferndicke_mm / 2,
       x + tp.zifferndicke_mm / 2 + tp.zifferndicke_mm,
     };
-    const auto ys = std::vector<int> {
+    const auto ys = std::array<int, 4> {
       y + tp.zifferndicke_mm / 2 + tp.zifferndicke_mm,
       y + tp.zifferndicke_mm / 2,
       y - tp.zifferndicke_mm / 2,
       y - tp.zifferndicke_mm / 2 - tp.zifferndicke_mm,
     };
 
-    const auto verts = std::vector {
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[2] / 1000.0, ys[3] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[1] / 1000.0, ys[3] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[1] / 1000.0, ys[0] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[2] / 1000.0, ys[0] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-
-      plusminus_mesh.EmplaceVertex(-0.01, -(xs[1] + 1) / 1000.0, ys[2] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[0] / 1000.0, ys[2] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[0] / 1000.0, ys[1] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01, -(xs[1] + 1) / 1000.0, ys[1] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[3] / 1000.0, ys[2] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01, -(xs[2] - 1) / 1000.0, ys[2] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01, -(xs[2] - 1) / 1000.0, ys[1] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
-      plusminus_mesh.EmplaceVertex(-0.01,       -xs[3] / 1000.0, ys[1] / 1000.0, -1, 0, 0, .103, .915, .103, .915),
+    const auto verts = std::array {
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[2]), Millimeter(ys[3]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[1]), Millimeter(ys[3]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[1]), Millimeter(ys[0]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[2]), Millimeter(ys[0]), -1, 0, 0, .103, .915, .103, .915),
+
+      plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(xs[1] + 1), Millimeter(ys[2]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[0]), Millimeter(ys[2]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[0]), Millimeter(ys[1]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(xs[1] + 1), Millimeter(ys[1]), -1, 0, 0, .103, .915, .103, .915),
+
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[3]), Millimeter(ys[2]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(xs[2] - 1), Millimeter(ys[2]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus, -Millimeter(xs[2] - 1), Millimeter(ys[1]), -1, 0, 0, .103, .915, .103, .915),
+      plusminus_mesh.EmplaceVertex(kXPlusMinus,       -Millimeter(xs[3]), Millimeter(ys[1]), -1, 0, 0, .103, .915, .103, .915),
     };
 
     plusminus_mesh.faces.emplace_back(verts[0], verts[1], verts[2]);
@@ -860,19 +1286,21 @@ Ziffern ZiffernBuilder::Build(const TafelParameter& tp, bool ist_negativ, int za
 }
 
 
-Mesh MastBuilder::Build(const TafelParameter& tp) {
+Mesh MastBuilder::Build(const TafelParameter& tp, Detailstufe detailstufe) {
+  TraceBereich bereich("Mast");
+
   Mesh result;
 
-  constexpr float z_top = .1;
-  constexpr float z_bottom = -3.4;
+  constexpr Koordinate z_top = 100 * kKoordinateProMm;
+  constexpr Koordinate z_bottom = -3400 * kKoordinateProMm;
 
-  constexpr float radius = 0.0375;  // Halbe Mastdicke
+  constexpr Koordinate radius = 37500;  // Halbe Mastdicke (37.5mm)
 
   const float u_links = tp.tex_mast.u_links;
   const float u_rechts = tp.tex_mast.u_rechts;
 
   const float v_top = tp.tex_mast.v_oben;
-  const float v_bottom = (z_top - z_bottom) / (2 * radius) * (u_rechts - u_links);
+  const float v_bottom = static_cast<float>(z_top - z_bottom) / (2 * radius) * (u_rechts - u_links);
 
   const float u_transp = tp.tex_transparent.u_links;
   const float v_transp = tp.tex_transparent.v_unten;
@@ -930,7 +1358,7 @@ Mesh MastBuilder::Build(const TafelParameter& tp) {
   }
 
   // Deckel
-  {
+  if (detailstufe != Detailstufe::kFern) {
     const float v_oben = 0;
     const float v_unten = u_rechts - u_links;
 
@@ -964,19 +1392,19 @@ static constexpr Textur MakeTexturGimp(
     hoehe_mm, (y_unten_px) / 256.0f, (y_unten_px + hoehe_px) / 256.0f };
 }
 
-static const Textur kTransparentTextur = MakeTexturGimp(0, 4, 0, 0, 252, 0);
+static constexpr Textur kTransparentTextur = MakeTexturGimp(0, 4, 0, 0, 252, 0);
 
-static const Textur kTafelVorderseiteTexturGross           = MakeTexturGimp(720 / 2,  59,  57, 800 / 2, 65, 64);
-static const Textur kTafelVorderseiteTexturGrossGespiegelt = MakeTexturGimp(720 / 2,  58, -57, 800 / 2, 65, 64);
-static const Textur kTafelRueckseiteTexturGross            = MakeTexturGimp(720 / 2, 174,  55, 800 / 2, 65, 64);
-static const Textur kTafelRueckseiteTexturGrossGespiegelt  = MakeTexturGimp(720 / 2, 174, -55, 800 / 2, 65, 64);
+static constexpr Textur kTafelVorderseiteTexturGross           = MakeTexturGimp(720 / 2,  59,  57, 800 / 2, 65, 64);
+static constexpr Textur kTafelVorderseiteTexturGrossGespiegelt = MakeTexturGimp(720 / 2,  58, -57, 800 / 2, 65, 64);
+static constexpr Textur kTafelRueckseiteTexturGross            = MakeTexturGimp(720 / 2, 174,  55, 800 / 2, 65, 64);
+static constexpr Textur kTafelRueckseiteTexturGrossGespiegelt  = MakeTexturGimp(720 / 2, 174, -55, 800 / 2, 65, 64);
 
-static const Textur kTafelVorderseiteTexturKlein           = MakeTexturGimp(480 / 2,  59,  57, 610 / 2, 65, 64);
-static const Textur kTafelVorderseiteTexturKleinGespiegelt = MakeTexturGimp(480 / 2,  58, -57, 610 / 2, 65, 64);
-static const Textur kTafelRueckseiteTexturKlein            = MakeTexturGimp(480 / 2, 174,  52, 610 / 2, 65, 64);
-static const Textur kTafelRueckseiteTexturKleinGespiegelt  = MakeTexturGimp(480 / 2, 174, -52, 610 / 2, 65, 64);
+static constexpr Textur kTafelVorderseiteTexturKlein           = MakeTexturGimp(480 / 2,  59,  57, 610 / 2, 65, 64);
+static constexpr Textur kTafelVorderseiteTexturKleinGespiegelt = MakeTexturGimp(480 / 2,  58, -57, 610 / 2, 65, 64);
+static constexpr Textur kTafelRueckseiteTexturKlein            = MakeTexturGimp(480 / 2, 174,  52, 610 / 2, 65, 64);
+static constexpr Textur kTafelRueckseiteTexturKleinGespiegelt  = MakeTexturGimp(480 / 2, 174, -52, 610 / 2, 65, 64);
 
-static const Textur kMastTextur = MakeTexturGimp(22, 233, 22, 256, 0, 256);
+static constexpr Textur kMastTextur = MakeTexturGimp(22, 233, 22, 256, 0, 256);
 
 /**
  * Hilfsmethode zum Erstellen einer Zifferntextur.
@@ -1021,71 +1449,203 @@ static constexpr float AbstandX(bool gross) {
   return gross ? kAbstandXGross_mm : kAbstandXKlein_mm;
 }
 
+// Position der Ziffern 0 bis 8 im Texturatlas in Pixeln, Koordinatensystem wie in Inkscape
+struct ZiffernPosition final {
+  double x_links_px;
+  double breite_px;
+  double y_unten_px;
+  double hoehe_px;
+};
+
+static constexpr std::array<ZiffernPosition, 9> kZiffernPositionen {{
+  //   x_links_px, breite_px, y_unten_px, hoehe_px
+  {        19.000,    38.095,         68,       51 },
+  {        15.000,    14.695,          7,       51 },
+  {        45.689,    31.383,          7,       51 },
+  {       128.139,    28.371,         68,       51 },
+  {       175.570,    36.430,         68,       51 },
+  {        76.168,    32.898,         68,       51 },
+  {        93.066,    33.030,          7,       51 },
+  {       142.090,    27.766,          7,       51 },
+  {       185.850,    30.150,          7,       51 },
+}};
+
+static constexpr Textur MakeZiffernTextur(int breite_mm, const ZiffernPosition& p, float abstand_x_mm, int hoehe_mm) {
+  return MakeZiffernTextur(breite_mm, p.x_links_px, p.breite_px, abstand_x_mm, hoehe_mm, p.y_unten_px, p.hoehe_px);
+}
+
+// Um 180 Grad gedrehte Ziffer
+static constexpr ZiffernPosition Gedreht(const ZiffernPosition& p) {
+  return { p.x_links_px + p.breite_px, -p.breite_px, p.y_unten_px + p.hoehe_px, -p.hoehe_px };
+}
+
 static constexpr std::array<Textur, 11> MakeZiffernTexturen(bool gross) {
   return {{
-    //                        breite_mm, x_links_px,     breite_px, abstand_x_mm,       hoehe_mm, y_unten_px, hoehe_px
-    MakeZiffernTextur(gross ? 231 : 157,  19.000,           38.095, AbstandX(gross), gross ? 310 : 210,      68,  51),
-    MakeZiffernTextur(gross ?  89 :  60,  15.000,           14.695, AbstandX(gross), gross ? 310 : 210,       7,  51),
-    MakeZiffernTextur(gross ? 190 : 129,  45.689,           31.383, AbstandX(gross), gross ? 310 : 210,       7,  51),
-    MakeZiffernTextur(gross ? 173 : 117, 128.139,           28.371, AbstandX(gross), gross ? 310 : 210,      68,  51),
-    MakeZiffernTextur(gross ? 221 : 150, 175.570,           36.430, AbstandX(gross), gross ? 310 : 210,      68,  51),
-
-    MakeZiffernTextur(gross ? 200 : 135,  76.168,           32.898, AbstandX(gross), gross ? 310 : 210,      68,  51),
-    MakeZiffernTextur(gross ? 201 : 136,  93.066,           33.030, AbstandX(gross), gross ? 310 : 210,       7,  51),
-    MakeZiffernTextur(gross ? 169 : 114, 142.090,           27.766, AbstandX(gross), gross ? 310 : 210,       7,  51),
-    MakeZiffernTextur(gross ? 183 : 124, 185.850,           30.150, AbstandX(gross), gross ? 310 : 210,       7,  51),
+    //                        breite_mm, Position,                       abstand_x_mm,       hoehe_mm
+    MakeZiffernTextur(gross ? 231 : 157, kZiffernPositionen[0],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ?  89 :  60, kZiffernPositionen[1],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 190 : 129, kZiffernPositionen[2],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 173 : 117, kZiffernPositionen[3],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 221 : 150, kZiffernPositionen[4],         AbstandX(gross), gross ? 310 : 210),
+
+    MakeZiffernTextur(gross ? 200 : 135, kZiffernPositionen[5],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 201 : 136, kZiffernPositionen[6],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 169 : 114, kZiffernPositionen[7],         AbstandX(gross), gross ? 310 : 210),
+    MakeZiffernTextur(gross ? 183 : 124, kZiffernPositionen[8],         AbstandX(gross), gross ? 310 : 210),
     // Ziffer 9 ist eine gedrehte Ziffer 6
-    MakeZiffernTextur(gross ? 201 : 136,  93.066 + 33.030, -33.030, AbstandX(gross), gross ? 310 : 210,  7 + 51, -51),
+    MakeZiffernTextur(gross ? 201 : 136, Gedreht(kZiffernPositionen[6]), AbstandX(gross), gross ? 310 : 210),
 
     // Leertextur, falls Abstand > max. Ziffernabstand
     MakeZiffernTextur(                0,       5,                0,               0,                 0,       0,   0),
   }};
 }
 
+#ifdef HEKTO_TEXTUR_ATLAS
+// Die Tabellen oben werden beim Bauen gegen den vermessenen Texturatlas geprueft (siehe atlas_main.cpp).
+// Schlaegt eine Pruefung fehl, stehen die aktuellen Werte in generiert/textur_atlas.hpp.
+static constexpr bool Nahe(double a_px, double b_px) {
+  return a_px - b_px <= textur_atlas::kToleranz_px && b_px - a_px <= textur_atlas::kToleranz_px;
+}
+
+static constexpr bool Innerhalb(double a_px, double min_px, double max_px) {
+  return a_px >= min_px - textur_atlas::kToleranz_px && a_px <= max_px + textur_atlas::kToleranz_px;
+}
+
+static constexpr bool PasstZuAtlas(const ZiffernPosition& p, const textur_atlas::Rechteck& r) {
+  return Nahe(p.x_links_px, r.links) && Nahe(p.x_links_px + p.breite_px, r.rechts)
+    && Nahe(256 - p.y_unten_px - p.hoehe_px, r.oben) && Nahe(256 - p.y_unten_px, r.unten);
+}
+
+// Tafeltexturen zeigen die untere Haelfte der Tafel, ungespiegelt die rechte und gespiegelt die linke.
+// Die Kante an der Tafelmitte muss passen, die aeussere Kante darf nach innen versetzt sein.
+static constexpr bool PasstZuAtlas(const Textur& t, const textur_atlas::Rechteck& r) {
+  const double links = std::min(t.u_links, t.u_rechts) * 256;
+  const double rechts = std::max(t.u_links, t.u_rechts) * 256;
+  const double mitte = t.u_links < t.u_rechts ? links : rechts;
+  return Innerhalb(links, r.links, r.rechts) && Innerhalb(rechts, r.links, r.rechts) && Nahe(mitte, (r.links + r.rechts) / 2)
+    && Nahe(t.v_oben * 256, (r.oben + r.unten) / 2) && Nahe(t.v_unten * 256, r.unten);
+}
+
+static_assert(PasstZuAtlas(kZiffernPositionen[0], textur_atlas::kZiffern[0]), "Ziffer 0 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[1], textur_atlas::kZiffern[1]), "Ziffer 1 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[2], textur_atlas::kZiffern[2]), "Ziffer 2 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[3], textur_atlas::kZiffern[3]), "Ziffer 3 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[4], textur_atlas::kZiffern[4]), "Ziffer 4 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[5], textur_atlas::kZiffern[5]), "Ziffer 5 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[6], textur_atlas::kZiffern[6]), "Ziffer 6 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[7], textur_atlas::kZiffern[7]), "Ziffer 7 passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kZiffernPositionen[8], textur_atlas::kZiffern[8]), "Ziffer 8 passt nicht zum Texturatlas");
+
+static_assert(PasstZuAtlas(kTafelVorderseiteTexturGross, textur_atlas::kVorderseite)
+    && PasstZuAtlas(kTafelVorderseiteTexturGrossGespiegelt, textur_atlas::kVorderseite)
+    && PasstZuAtlas(kTafelVorderseiteTexturKlein, textur_atlas::kVorderseite)
+    && PasstZuAtlas(kTafelVorderseiteTexturKleinGespiegelt, textur_atlas::kVorderseite),
+    "Vorderseite passt nicht zum Texturatlas");
+static_assert(PasstZuAtlas(kTafelRueckseiteTexturGross, textur_atlas::kRueckseite)
+    && PasstZuAtlas(kTafelRueckseiteTexturGrossGespiegelt, textur_atlas::kRueckseite)
+    && PasstZuAtlas(kTafelRueckseiteTexturKlein, textur_atlas::kRueckseite)
+    && PasstZuAtlas(kTafelRueckseiteTexturKleinGespiegelt, textur_atlas::kRueckseite),
+    "Rueckseite passt nicht zum Texturatlas");
+static_assert(Innerhalb(kMastTextur.u_links * 256, textur_atlas::kMast.links, textur_atlas::kMast.rechts)
+    && Innerhalb(kMastTextur.u_rechts * 256, textur_atlas::kMast.links, textur_atlas::kMast.rechts)
+    && Nahe(kMastTextur.v_oben * 256, textur_atlas::kMast.oben) && Nahe(kMastTextur.v_unten * 256, textur_atlas::kMast.unten),
+    "Mast passt nicht zum Texturatlas");
+#endif
+
 static constexpr std::array<Textur, 11> kZiffernTexturenGross = MakeZiffernTexturen(true);
 static constexpr std::array<Textur, 11> kZiffernTexturenKlein = MakeZiffernTexturen(false);
 
-// Z-Verschiebung fuer die hohe Variante der Tafel
-static constexpr float kZVerschiebungHoch = 2.4f;
+// Pseudozufallszahlen wie rand() der Microsoft-C-Laufzeitbibliothek, gegen die die DLL gelinkt wird.
+// Im Gegensatz zu srand()/rand() ohne globalen Zustand, also threadsicher und plattformunabhaengig.
+class Zufall final {
+ public:
+  explicit Zufall(uint32_t seed) : zustand_(seed) { }
 
-}  // namespace
+  int Naechste() {
+    zustand_ = zustand_ * 214013u + 2531011u;
+    return static_cast<int>((zustand_ >> 16) & 0x7FFF);
+  }
 
-void HektoBuilder::Build(FILE* fd, const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
-  const bool ist_negativ = kilometrierung.istNegativ();
-  const int zahl_oben = std::abs(kilometrierung.km);
-  const int ziffer_unten = std::abs(kilometrierung.hm);
+ private:
+  uint32_t zustand_;
+};
 
-  assert(zahl_oben >= 0);
-  assert(zahl_oben <= 999);
-  assert(ziffer_unten >= 0);
-  assert(ziffer_unten <= 9);
-  assert(!ueberlaenge_hm.has_value() || (ueberlaenge_hm >= 0));
-  assert(!ueberlaenge_hm.has_value() || (ueberlaenge_hm <= kMaxUeberlaenge));
+// Z-Verschiebung fuer die hohe Variante der Tafel
+static constexpr Koordinate kZVerschiebungHoch = 2400 * kKoordinateProMm;
+
+// Alles, wovon Ziffern-Layout und Vorderseite einer Tafel abhaengen.
+// Die Texturspiegelung wird aus zahl_oben und ziffer_unten abgeleitet
+// und ist deshalb nicht separat Teil des Schluessels.
+struct ZiffernSchluessel final {
+  Groesse groesse;
+  bool ist_negativ;
+  int zahl_oben;
+  int ziffer_unten;
+  std::optional<int> ueberlaenge;
+  Triangulierung triangulierung;  // nur fuer die Vorderseite relevant
+  Detailstufe detailstufe;
+
+  bool operator==(const ZiffernSchluessel& other) const {
+    return groesse == other.groesse && ist_negativ == other.ist_negativ && zahl_oben == other.zahl_oben
+      && ziffer_unten == other.ziffer_unten && ueberlaenge == other.ueberlaenge && triangulierung == other.triangulierung
+      && detailstufe == other.detailstufe;
+  }
+};
 
-  fprintf(fd,
-      "\xef\xbb\xbf"
-      "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
-      "<Zusi>\n"
-      "<Info DateiTyp=\"Landschaft\" Version=\"A.1\" MinVersion=\"A.1\">\n"
-      "<AutorEintrag AutorID=\"-1\" AutorName=\"Zusi-generiert\"/>\n"
-      "</Info>\n"
-      "<Landschaft>\n");
+struct ZiffernSchluesselHash final {
+  size_t operator()(const ZiffernSchluessel& s) const {
+    // zahl_oben <= kMaxKm, ziffer_unten <= 9, ueberlaenge <= kMaxUeberlaenge
+    return (((((static_cast<size_t>(s.zahl_oben) * 10 + s.ziffer_unten) * (kMaxUeberlaenge + 2)
+        + (s.ueberlaenge.has_value() ? *s.ueberlaenge + 1 : 0)) * 2 + s.ist_negativ) * 2
+      + static_cast<size_t>(s.groesse)) * 2 + static_cast<size_t>(s.triangulierung)) * 3 + static_cast<size_t>(s.detailstufe);
+  }
+};
 
-  const uint32_t grundfarbe = bauparameter.textur == TexturDatei::kTunnel ? 0xC0C0C0 : 0xFFFFFF;
-  const uint32_t nachtfarbe = bauparameter.textur == TexturDatei::kTunnel ? 0xC0C0C0 : 0x646464;
+constexpr size_t kZiffernCacheKapazitaet = 4096;
+
+LruCache<ZiffernSchluessel, Ziffern, ZiffernSchluesselHash> g_ziffern_cache(kZiffernCacheKapazitaet);
+LruCache<ZiffernSchluessel, Mesh, ZiffernSchluesselHash> g_vorderseiten_cache(kZiffernCacheKapazitaet);
+
+// Alles, wovon Rueckseite und Mast (fertig verschoben) abhaengen.
+struct StatischSchluessel final {
+  Groesse groesse;
+  bool breit;
+  Hoehe hoehe;
+  Mast mast;
+  Beidseitig beidseitig;
+  bool rueckseite_gespiegelt;
+  Detailstufe detailstufe;
+  Ausgabeformat format;
+
+  bool operator==(const StatischSchluessel& other) const {
+    return groesse == other.groesse && breit == other.breit && hoehe == other.hoehe && mast == other.mast
+      && beidseitig == other.beidseitig && rueckseite_gespiegelt == other.rueckseite_gespiegelt
+      && detailstufe == other.detailstufe && format == other.format;
+  }
+};
 
-  SubsetBuilder subset_unbeleuchtet(grundfarbe | 0xFF000000, 0xFF000000, static_cast<size_t>(bauparameter.textur));
-  SubsetBuilder subset_beleuchtet((grundfarbe - nachtfarbe) | 0xFF000000, nachtfarbe | 0xFF000000, static_cast<size_t>(bauparameter.textur));
-  auto& subset_evtl_beleuchtet = (bauparameter.rueckstrahlend == Rueckstrahlend::kYes ? subset_beleuchtet : subset_unbeleuchtet);
+struct StatischSchluesselHash final {
+  size_t operator()(const StatischSchluessel& s) const {
+    return (static_cast<size_t>(s.format.genauigkeit) << 9) | (static_cast<size_t>(s.format.attributausgabe) << 8) | (static_cast<size_t>(s.detailstufe) << 6) | (static_cast<size_t>(s.groesse) << 5) | (static_cast<size_t>(s.breit) << 4) | (static_cast<size_t>(s.hoehe) << 3) | (static_cast<size_t>(s.mast) << 2)
+      | (static_cast<size_t>(s.beidseitig) << 1) | static_cast<size_t>(s.rueckseite_gespiegelt);
+  }
+};
+
+// Es gibt nur 4 * 3 * 2^6 verschiedene Schluessel.
+LruCache<StatischSchluessel, VorformatierterMesh, StatischSchluesselHash> g_statische_geometrie_cache(4 * 3 * 64);
 
+}  // namespace
+
+TafelParameter HektoBuilder::BaueTafelParameter(Groesse groesse, bool ist_negativ, int zahl_oben, int ziffer_unten,
+    std::optional<int> ueberlaenge_hm) {
   // Die Spiegelung der Vorder- und Rueckseitentextur ist abhaengig vom dargestellten Wert
-  std::srand(1000 * zahl_oben + 100 * ziffer_unten);
+  Zufall zufall(1000 * zahl_oben + 100 * ziffer_unten);
 
-  const float mm_per_px = bauparameter.groesse == Groesse::kKlein ? 210.0f / 51.0f : 310.0f / 51.0f;
+  const float mm_per_px = groesse == Groesse::kKlein ? 210.0f / 51.0f : 310.0f / 51.0f;
 
   const bool breit = (ist_negativ && (zahl_oben >= 10)) || (zahl_oben >= 100) || ueberlaenge_hm.has_value();
 
-  TafelParameter tp = bauparameter.groesse == Groesse::kKlein ?
+  return groesse == Groesse::kKlein ?
     TafelParameter {
       /* breite */ breit ? 480 : 320,
       /* hoehe */ 610,
@@ -1095,8 +1655,8 @@ void HektoBuilder::Build(FILE* fd, const BauParameter& bauparameter, Kilometrier
       /* max_ziffernabstand_mm */ static_cast<int>(15/*px*/ * mm_per_px - 2 * kAbstandXKlein_mm),
       /* zifferndicke_mm */ 27,
 
-      /* tex_tafel_vorderseite */ rand() % 2 == 0 ? kTafelVorderseiteTexturKlein : kTafelVorderseiteTexturKleinGespiegelt,
-      /* tex_tafel_rueckseite */ rand() % 2 == 0 ? kTafelRueckseiteTexturKlein : kTafelRueckseiteTexturKleinGespiegelt,
+      /* tex_tafel_vorderseite */ zufall.Naechste() % 2 == 0 ? kTafelVorderseiteTexturKlein : kTafelVorderseiteTexturKleinGespiegelt,
+      /* tex_tafel_rueckseite */ zufall.Naechste() % 2 == 0 ? kTafelRueckseiteTexturKlein : kTafelRueckseiteTexturKleinGespiegelt,
       /* tex_ziffern */ kZiffernTexturenKlein,
       /* tex_mast */ kMastTextur,
       /* tex_transparent */ kTransparentTextur
@@ -1109,78 +1669,355 @@ void HektoBuilder::Build(FILE* fd, const BauParameter& bauparameter, Kilometrier
       /* max_ziffernabstand_mm */ static_cast<int>(15/*px*/ * mm_per_px - 2 * kAbstandXGross_mm),
       /* zifferndicke_mm */ 40,
 
-      /* tex_tafel_vorderseite */ rand() % 2 == 0 ? kTafelVorderseiteTexturGross : kTafelVorderseiteTexturGrossGespiegelt,
-      /* tex_tafel_rueckseite */ rand() % 2 == 0 ? kTafelRueckseiteTexturGross : kTafelRueckseiteTexturGrossGespiegelt,
+      /* tex_tafel_vorderseite */ zufall.Naechste() % 2 == 0 ? kTafelVorderseiteTexturGross : kTafelVorderseiteTexturGrossGespiegelt,
+      /* tex_tafel_rueckseite */ zufall.Naechste() % 2 == 0 ? kTafelRueckseiteTexturGross : kTafelRueckseiteTexturGrossGespiegelt,
       /* tex_ziffern */ kZiffernTexturenGross,
       /* tex_mast */ kMastTextur,
       /* tex_transparent */ kTransparentTextur
     };
+}
+
+namespace {
+
+// Von Textur und Rueckstrahlung unabhaengige Bestandteile einer Tafel.
+struct TafelGeometrie final {
+  Mesh vorderseite;  // Vorderseite(n) inkl. Ziffern, fertig verschoben
+  std::shared_ptr<const VorformatierterMesh> statisch;  // Rueckseite(n) und Mast, fertig verschoben; evtl. nullptr
+  std::string ankerpunkte;
+};
+
+// Verschiebung der Tafel in X-Richtung, damit sie am Mast anliegt
+Koordinate XVerschiebung(const BauParameter& bauparameter) {
+  return bauparameter.mast == Mast::kMitMast ? Millimeter(38) : 0;
+}
+
+Koordinate ZVerschiebung(const BauParameter& bauparameter) {
+  return bauparameter.hoehe == Hoehe::kHoch ? kZVerschiebungHoch : 0;
+}
+
+std::string BaueAnkerpunkte(const BauParameter& bauparameter) {
+  if (bauparameter.ankerpunkt != Ankerpunkt::kYes) {
+    return {};
+  }
 
   const char* nbue_dateiname = bauparameter.groesse == Groesse::kKlein ?
     "_Setup\\lib\\milepost\\hektometertafeln_DB\\NBUe_Signal_klein.ls3" :
     "_Setup\\lib\\milepost\\hektometertafeln_DB\\NBUe_Signal.ls3";
 
-  auto MakeAnkerpunkt = [&](float x, float z, bool rueckseite) {
-    fprintf(fd, "<Ankerpunkt>\n");
+  PufferAusgabe ankerpunkte;
+  auto MakeAnkerpunkt = [&](Koordinate x, Koordinate z, bool rueckseite) {
+    ankerpunkte.SchreibeLiteral("<Ankerpunkt>\n");
     if (x != 0 || z != 0) {
-      fprintf(fd, "<p");
+      char puffer[kMaxFloatLaenge];
+      ankerpunkte.SchreibeLiteral("<p");
       if (x != 0) {
-        fprintf(fd, " X=\"%f\"", x);
+        ankerpunkte.SchreibeFormatiert(" X=\"%.*s\"", static_cast<int>(FormatKoordinate(puffer, x) - puffer), puffer);
       }
       if (z != 0) {
-        fprintf(fd, " Z=\"%f\"", z);
+        ankerpunkte.SchreibeFormatiert(" Z=\"%.*s\"", static_cast<int>(FormatKoordinate(puffer, z) - puffer), puffer);
       }
-      fprintf(fd, "/>\n");
+      ankerpunkte.SchreibeLiteral("/>\n");
     }
     if (rueckseite) {
-      fprintf(fd, "<phi Z=\"3.141592\"/>");
+      ankerpunkte.SchreibeLiteral("<phi Z=\"3.141592\"/>");
     }
-    fprintf(fd, "<Datei Dateiname=\"%s\"/>\n</Ankerpunkt>\n", nbue_dateiname);
+    ankerpunkte.SchreibeFormatiert("<Datei Dateiname=\"%s\"/>\n</Ankerpunkt>\n", nbue_dateiname);
   };
 
-  const float x_verschiebung = bauparameter.mast == Mast::kMitMast ? .038f : 0.0f;
-  const float z_verschiebung = bauparameter.hoehe == Hoehe::kHoch ? kZVerschiebungHoch : 0.0f;
+  const Koordinate x_verschiebung = XVerschiebung(bauparameter);
+  const Koordinate z_verschiebung = ZVerschiebung(bauparameter);
+  if (bauparameter.beidseitig == Beidseitig::kBeidseitig) {
+    MakeAnkerpunkt(-x_verschiebung - Millimeter(10), z_verschiebung, false);
+    MakeAnkerpunkt(x_verschiebung + Millimeter(10), z_verschiebung, true);
+  } else {
+    MakeAnkerpunkt(-x_verschiebung, z_verschiebung, false);
+  }
+
+  return std::move(ankerpunkte.Inhalt());
+}
+
+TafelGeometrie BaueGeometrie(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
+  TraceBereich bereich("Geometrie");
+  const bool ist_negativ = kilometrierung.istNegativ();
+  const int zahl_oben = std::abs(kilometrierung.km);
+  const int ziffer_unten = std::abs(kilometrierung.hm);
+
+  assert(zahl_oben >= 0);
+  assert(zahl_oben <= kMaxKm);
+  assert(ziffer_unten >= 0);
+  assert(ziffer_unten <= 9);
+  assert(!ueberlaenge_hm.has_value() || (ueberlaenge_hm >= 0));
+  assert(!ueberlaenge_hm.has_value() || (ueberlaenge_hm <= kMaxUeberlaenge));
+
+  TafelGeometrie result;
+
+  const bool breit = (ist_negativ && (zahl_oben >= 10)) || (zahl_oben >= 100) || ueberlaenge_hm.has_value();
+  const TafelParameter tp = HektoBuilder::BaueTafelParameter(bauparameter.groesse, ist_negativ, zahl_oben, ziffer_unten, ueberlaenge_hm);
+
+  const Koordinate x_verschiebung = XVerschiebung(bauparameter);
+  const Koordinate z_verschiebung = ZVerschiebung(bauparameter);
   // Die generierte Tafel ist in Y- und Z-Richtung zentriert
   // Verschiebe sie so, dass die Oberkante bei z=0 liegt
-  const float z_verschiebung_tafel = z_verschiebung + (bauparameter.groesse == Groesse::kKlein ? -.61 / 2 : -.80 / 2);
+  const Koordinate z_verschiebung_tafel = z_verschiebung - Millimeter(bauparameter.groesse == Groesse::kKlein ? 610 / 2 : 800 / 2);
 
-  const auto& ziffern = ZiffernBuilder::Build(tp, ist_negativ, zahl_oben, ziffer_unten, ueberlaenge_hm);
-  const auto& mesh_vorderseite = TafelVorderseiteBuilder::Build(tp, ziffern.stuetzpunkte_oben, ziffern.stuetzpunkte_unten);
-  const auto& mesh_rueckseite = TafelRueckseiteBuilder::Build(tp);
+  const auto detailstufe = bauparameter.detailstufe;
 
-  subset_evtl_beleuchtet.AddMesh(MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, ziffern.mesh1));
-  subset_evtl_beleuchtet.AddMesh(MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, ziffern.mesh2)); // TODO: sep. Subset
-  subset_evtl_beleuchtet.AddMesh(MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, mesh_vorderseite));
+  // In der Detailstufe kFern gibt es keine Vorderseite
+  if (detailstufe != Detailstufe::kFern) {
+    const ZiffernSchluessel schluessel {
+      bauparameter.groesse, ist_negativ, zahl_oben, ziffer_unten, ueberlaenge_hm, bauparameter.triangulierung, detailstufe
+    };
+    const auto ziffern_ptr = g_ziffern_cache.GetOrBuild(schluessel, [&]() {
+      return ZiffernBuilder::Build(tp, ist_negativ, zahl_oben, ziffer_unten, ueberlaenge_hm, detailstufe);
+    });
+    const auto mesh_vorderseite_ptr = g_vorderseiten_cache.GetOrBuild(schluessel, [&]() {
+      if (detailstufe == Detailstufe::kGrob) {
+        return TafelVorderseiteBuilder::BuildGrob(tp, ziffern_ptr->stuetzpunkte_oben, ziffern_ptr->stuetzpunkte_unten);
+      }
+      return TafelVorderseiteBuilder::Build(tp, ziffern_ptr->stuetzpunkte_oben, ziffern_ptr->stuetzpunkte_unten, bauparameter.triangulierung);
+    });
+    const auto& ziffern = *ziffern_ptr;
+    const auto& mesh_vorderseite = *mesh_vorderseite_ptr;
 
-  if (bauparameter.beidseitig == Beidseitig::kBeidseitig) {
-    subset_evtl_beleuchtet.AddMesh(MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(ziffern.mesh1)));
-    subset_evtl_beleuchtet.AddMesh(MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(ziffern.mesh2))); // TODO: sep. Subset
-    subset_evtl_beleuchtet.AddMesh(MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_vorderseite)));
-  }
+    TraceBereich transformation_bereich("Transformation");
+    MeshOps::append(&result.vorderseite, MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, ziffern.mesh1));
+    MeshOps::append(&result.vorderseite, MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, ziffern.mesh2)); // TODO: sep. Subset
+    MeshOps::append(&result.vorderseite, MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, mesh_vorderseite));
 
-  if (bauparameter.mast == Mast::kMitMast) {
-    subset_unbeleuchtet.AddMesh(MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_rueckseite)));
     if (bauparameter.beidseitig == Beidseitig::kBeidseitig) {
-      subset_unbeleuchtet.AddMesh(MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, mesh_rueckseite));
+      MeshOps::append(&result.vorderseite, MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(ziffern.mesh1)));
+      MeshOps::append(&result.vorderseite, MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(ziffern.mesh2))); // TODO: sep. Subset
+      MeshOps::append(&result.vorderseite, MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_vorderseite)));
     }
-    subset_unbeleuchtet.AddMesh(MeshOps::translate(0, 0, z_verschiebung, MastBuilder::Build(tp)));
-  } else if (bauparameter.beidseitig == Beidseitig::kEinseitig) {
-    subset_unbeleuchtet.AddMesh(MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_rueckseite)));
   }
 
-  if (bauparameter.ankerpunkt == Ankerpunkt::kYes) {
-    if (bauparameter.beidseitig == Beidseitig::kBeidseitig) {
-      MakeAnkerpunkt(-x_verschiebung - 0.01, z_verschiebung, false);
-      MakeAnkerpunkt(x_verschiebung + 0.01, z_verschiebung, true);
-    } else {
-      MakeAnkerpunkt(-x_verschiebung, z_verschiebung, false);
-    }
+  // Rueckseite und Mast haengen nicht vom dargestellten Wert ab und werden
+  // pro Variante nur einmal erzeugt und formatiert.
+  if (bauparameter.mast == Mast::kMitMast || (bauparameter.beidseitig == Beidseitig::kEinseitig && detailstufe != Detailstufe::kFern)) {
+    const StatischSchluessel statisch_schluessel {
+      bauparameter.groesse, breit, bauparameter.hoehe, bauparameter.mast, bauparameter.beidseitig,
+      &tp.tex_tafel_rueckseite == &kTafelRueckseiteTexturGrossGespiegelt || &tp.tex_tafel_rueckseite == &kTafelRueckseiteTexturKleinGespiegelt,
+      detailstufe, AusgabeformatVon(bauparameter)
+    };
+    result.statisch = g_statische_geometrie_cache.GetOrBuild(statisch_schluessel, [&]() {
+      if (detailstufe == Detailstufe::kFern) {
+        return SubsetBuilder::Vorformatieren(MeshOps::translate(0, 0, z_verschiebung, MastBuilder::Build(tp, detailstufe)),
+            AusgabeformatVon(bauparameter));
+      }
+
+      const auto& mesh_rueckseite = detailstufe == Detailstufe::kVoll ? TafelRueckseiteBuilder::Build(tp) : TafelRueckseiteBuilder::BuildGrob(tp);
+      Mesh mesh;
+      if (bauparameter.mast == Mast::kMitMast) {
+        MeshOps::append(&mesh, MeshOps::translate(-x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_rueckseite)));
+        if (bauparameter.beidseitig == Beidseitig::kBeidseitig) {
+          MeshOps::append(&mesh, MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, mesh_rueckseite));
+        }
+        MeshOps::append(&mesh, MeshOps::translate(0, 0, z_verschiebung, MastBuilder::Build(tp)));
+      } else {
+        MeshOps::append(&mesh, MeshOps::translate(x_verschiebung, 0, z_verschiebung_tafel, MeshOps::rotateZ180(mesh_rueckseite)));
+      }
+      return SubsetBuilder::Vorformatieren(std::move(mesh), AusgabeformatVon(bauparameter));
+    });
   }
 
-  subset_beleuchtet.Write(fd);
-  subset_unbeleuchtet.Write(fd);
+  result.ankerpunkte = BaueAnkerpunkte(bauparameter);
+  return result;
+}
+
+struct SubsetFarben final {
+  uint32_t tagfarbe;
+  uint32_t nachtfarbe;
+};
+
+SubsetFarben FarbenUnbeleuchtet(TexturDatei textur) {
+  const uint32_t grundfarbe = textur == TexturDatei::kTunnel ? 0xC0C0C0 : 0xFFFFFF;
+  return { grundfarbe | 0xFF000000, 0xFF000000 };
+}
+
+SubsetFarben FarbenBeleuchtet(TexturDatei textur) {
+  const uint32_t grundfarbe = textur == TexturDatei::kTunnel ? 0xC0C0C0 : 0xFFFFFF;
+  const uint32_t nachtfarbe = textur == TexturDatei::kTunnel ? 0xC0C0C0 : 0x646464;
+  return { (grundfarbe - nachtfarbe) | 0xFF000000, nachtfarbe | 0xFF000000 };
+}
 
-  fprintf(fd,
+void SchreibeLandschaftKopf(Ausgabe* ausgabe) {
+  ausgabe->SchreibeLiteral(
+      "\xef\xbb\xbf"
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      "<Zusi>\n"
+      "<Info DateiTyp=\"Landschaft\" Version=\"A.1\" MinVersion=\"A.1\">\n"
+      "<AutorEintrag AutorID=\"-1\" AutorName=\"Zusi-generiert\"/>\n"
+      "</Info>\n"
+      "<Landschaft>\n");
+}
+
+void SchreibeLandschaftEnde(Ausgabe* ausgabe) {
+  ausgabe->SchreibeLiteral(
       "</Landschaft>\n"
       "</Zusi>\n");
 }
+
+// Die Masttextur nimmt die volle Hoehe des Atlas ein und wird entlang des Mastes wiederholt (bis etwa v = 4).
+constexpr Texturbereich kTexturbereichStatisch { -0.5f / 256, 1 + 0.5f / 256, -0.5f / 256, 5 };
+
+// Bit n steht fuer LOD n, LOD 0 ist die naechste Entfernung.
+// Tafeln ohne Mast haben keine Geometrie in kFern und werden in LOD 2 und 3 ausgeblendet.
+uint32_t LodBits(Detailstufe detailstufe) {
+  switch (detailstufe) {
+    case Detailstufe::kVoll:
+      return 0b0001;
+    case Detailstufe::kGrob:
+      return 0b0010;
+    case Detailstufe::kFern:
+      return 0b1100;
+  }
+  return 0;
+}
+
+}  // namespace
+
+void HektoBuilder::Build(FILE* fd, const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
+  DateiAusgabe ausgabe(fd);
+  Build(&ausgabe, bauparameter, kilometrierung, ueberlaenge_hm);
+}
+
+void HektoBuilder::Build(Ausgabe* ausgabe, const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
+  BuildVarianten({ { bauparameter.textur, bauparameter.rueckstrahlend, ausgabe } }, bauparameter, kilometrierung, ueberlaenge_hm);
+}
+
+void HektoBuilder::BuildVarianten(const std::vector<TexturVariante>& varianten,
+    const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm,
+    std::vector<MeshFehler>* mesh_fehler) {
+  const auto geometrie = BaueGeometrie(bauparameter, kilometrierung, ueberlaenge_hm);
+
+  if (mesh_fehler != nullptr) {
+    TraceBereich pruefung_bereich("Pruefung");
+    *mesh_fehler = ValidateMesh(geometrie.vorderseite);
+    if (mesh_fehler->empty() && geometrie.statisch) {
+      *mesh_fehler = ValidateMesh(geometrie.statisch->mesh, kTexturbereichStatisch);
+    }
+    if (!mesh_fehler->empty()) {
+      return;
+    }
+  }
+
+  TraceBereich bereich("Serialisierung");
+
+  // Die Rueckstrahlung bestimmt nur, in welchem Subset die Vorderseite landet.
+  for (const auto rueckstrahlend : { Rueckstrahlend::kYes, Rueckstrahlend::kNo }) {
+    const auto anzahl = std::count_if(std::cbegin(varianten), std::cend(varianten),
+        [rueckstrahlend](const auto& variante) { return variante.rueckstrahlend == rueckstrahlend; });
+    if (anzahl == 0) {
+      continue;
+    }
+
+    SubsetBuilder subset_unbeleuchtet(0, 0, 0, AusgabeformatVon(bauparameter));
+    SubsetBuilder subset_beleuchtet(0, 0, 0, AusgabeformatVon(bauparameter));
+    auto& subset_evtl_beleuchtet = (rueckstrahlend == Rueckstrahlend::kYes ? subset_beleuchtet : subset_unbeleuchtet);
+
+    subset_evtl_beleuchtet.AddMesh(geometrie.vorderseite);
+    if (geometrie.statisch) {
+      subset_unbeleuchtet.AddMesh(geometrie.statisch);
+    }
+    if (bauparameter.index_reihenfolge == IndexReihenfolge::kVertexCache) {
+      subset_beleuchtet.OptimiereVertexCache();
+      subset_unbeleuchtet.OptimiereVertexCache();
+    }
+
+    // Bei mehreren Varianten wird der Subset-Inhalt nur einmal formatiert.
+    PufferAusgabe inhalt_beleuchtet;
+    PufferAusgabe inhalt_unbeleuchtet;
+    if (anzahl > 1) {
+      subset_beleuchtet.WriteInhalt(&inhalt_beleuchtet);
+      subset_unbeleuchtet.WriteInhalt(&inhalt_unbeleuchtet);
+    }
+
+    auto WriteSubset = [anzahl](Ausgabe* ausgabe, const SubsetBuilder& subset, const PufferAusgabe& inhalt,
+        SubsetFarben farben, TexturDatei textur) {
+      if (subset.IsEmpty()) {
+        return;
+      }
+      SubsetBuilder::WriteKopf(ausgabe, farben.tagfarbe, farben.nachtfarbe, static_cast<size_t>(textur));
+      if (anzahl > 1) {
+        ausgabe->Schreibe(inhalt.Inhalt());
+      } else {
+        subset.WriteInhalt(ausgabe);
+      }
+    };
+
+    for (const auto& variante : varianten) {
+      if (variante.rueckstrahlend != rueckstrahlend) {
+        continue;
+      }
+      auto* ausgabe = variante.ausgabe;
+
+      SchreibeLandschaftKopf(ausgabe);
+      ausgabe->Schreibe(geometrie.ankerpunkte);
+
+      WriteSubset(ausgabe, subset_beleuchtet, inhalt_beleuchtet, FarbenBeleuchtet(variante.textur), variante.textur);
+      WriteSubset(ausgabe, subset_unbeleuchtet, inhalt_unbeleuchtet, FarbenUnbeleuchtet(variante.textur), variante.textur);
+
+      SchreibeLandschaftEnde(ausgabe);
+    }
+  }
+}
+
+TafelMeshes HektoBuilder::BuildMeshes(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm) {
+  auto geometrie = BaueGeometrie(bauparameter, kilometrierung, ueberlaenge_hm);
+
+  // Gleiche Reihenfolge wie in BuildVarianten()
+  TafelMeshes result;
+  if (bauparameter.rueckstrahlend == Rueckstrahlend::kYes) {
+    result.beleuchtet = std::move(geometrie.vorderseite);
+  } else {
+    result.unbeleuchtet = std::move(geometrie.vorderseite);
+  }
+  if (geometrie.statisch) {
+    MeshOps::append(&result.unbeleuchtet, geometrie.statisch->mesh);
+  }
+  return result;
+}
+
+void HektoBuilder::WriteLandschaft(Ausgabe* ausgabe, TexturDatei textur, const SubsetBuilder& beleuchtet, const SubsetBuilder& unbeleuchtet) {
+  SchreibeLandschaftKopf(ausgabe);
+  for (const auto& [subset, farben] : { std::pair { &beleuchtet, FarbenBeleuchtet(textur) }, std::pair { &unbeleuchtet, FarbenUnbeleuchtet(textur) } }) {
+    if (!subset->IsEmpty()) {
+      SubsetBuilder::WriteKopf(ausgabe, farben.tagfarbe, farben.nachtfarbe, static_cast<size_t>(textur));
+      subset->WriteInhalt(ausgabe);
+    }
+  }
+  SchreibeLandschaftEnde(ausgabe);
+}
+
+void HektoBuilder::BuildVerknuepfung(Ausgabe* ausgabe, const BauParameter& bauparameter, const std::vector<DetailstufenDatei>& dateien) {
+  SchreibeLandschaftKopf(ausgabe);
+  ausgabe->Schreibe(BaueAnkerpunkte(bauparameter));
+  for (const auto& datei : dateien) {
+    ausgabe->SchreibeFormatiert("<Verknuepfte LODbit=\"%u\">\n<Datei Dateiname=\"%s\"/>\n</Verknuepfte>\n",
+        LodBits(datei.detailstufe), datei.dateiname.c_str());
+  }
+  SchreibeLandschaftEnde(ausgabe);
+}
+
+void HektoBuilder::BuildPlatzierung(Ausgabe* ausgabe, const std::vector<VerknuepfteDatei>& dateien) {
+  SchreibeLandschaftKopf(ausgabe);
+  char puffer[kMaxFloatLaenge];
+  for (const auto& datei : dateien) {
+    ausgabe->SchreibeFormatiert("<Verknuepfte>\n<Datei Dateiname=\"%s\"/>\n", datei.dateiname.c_str());
+    if (datei.x != 0 || datei.y != 0 || datei.z != 0) {
+      ausgabe->SchreibeLiteral("<p");
+      for (const auto& [name, wert] : { std::pair { "X", datei.x }, std::pair { "Y", datei.y }, std::pair { "Z", datei.z } }) {
+        if (wert != 0) {
+          ausgabe->SchreibeFormatiert(" %s=\"%.*s\"", name, static_cast<int>(FormatKoordinate(puffer, wert) - puffer), puffer);
+        }
+      }
+      ausgabe->SchreibeLiteral("/>\n");
+    }
+    if (datei.richtung != 0) {
+      ausgabe->SchreibeFormatiert("<phi Z=\"%.*s\"/>\n",
+          static_cast<int>(FormatFloat(puffer, static_cast<float>(datei.richtung)) - puffer), puffer);
+    }
+    ausgabe->SchreibeLiteral("</Verknuepfte>\n");
+  }
+  SchreibeLandschaftEnde(ausgabe);
+}
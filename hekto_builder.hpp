@@ -3,12 +3,20 @@
 #ifndef HEKTO_BUILDER_HPP_
 #define HEKTO_BUILDER_HPP_
 
+#include "ausgabe.hpp"
+#include "inline_vector.hpp"
 #include "mesh.hpp"
+#include "textur.hpp"
 
+#include <array>
 #include <cstdio>
 #include <cstdint>
 #include <cmath>
+#include <cstdlib>
+#include <memory>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 enum class Hoehe { kHoch, kNiedrig };
@@ -19,6 +27,37 @@ enum class Rueckstrahlend { kYes, kNo };
 enum class Ankerpunkt { kYes, kNo };
 enum class TexturDatei { kStandard = 0, kTunnel = 1, kVerwittert1 = 2, kVerwittert2 = 3 };
 
+// Triangulierung der Tafelvorderseite um die Ziffern herum
+enum class Triangulierung {
+  kFaecher,  ///< Faecher entlang der Stuetzpunkte (urspruengliches Verfahren)
+  kMinimal,  ///< Ear Clipping ohne degenerierte Dreiecke, minimale Anzahl Dreiecke fuer die gegebenen Randpunkte
+};
+
+// Reihenfolge der Faces und Vertices in der Ausgabe
+enum class IndexReihenfolge {
+  kUnveraendert,  ///< in der Reihenfolge, in der die Meshes zusammengesetzt wurden
+  kVertexCache,  ///< fuer den Vertex-Cache der Grafikkarte optimiert, siehe OptimiereVertexCache()
+};
+
+// Detailstufe (LOD) der erzeugten Geometrie
+enum class Detailstufe {
+  kVoll,  ///< abgerundete Ecken, Ziffern mit Stuetzpunkten, Rueckseite und Mast
+  kGrob,  ///< Tafel ohne abgerundete Ecken, ein Viereck pro Ziffer und fuer die Rueckseite, Mast
+  kFern,  ///< nur die Seitenflaechen des Mastes; leer bei Tafeln ohne Mast
+};
+
+// Umfang der Vertex-Attribute in der Ausgabe
+enum class Attributausgabe {
+  kVollstaendig,  ///< alle Attribute mit 6 Nachkommastellen
+  kKompakt,  ///< ohne Attribute mit Zusis Standardwert 0, ohne Nullen am Ende der Nachkommastellen
+};
+
+// Genauigkeit der Zahlen in der Ausgabe
+enum class Genauigkeit {
+  kVoll,  ///< 6 Nachkommastellen, Positionen exakt in Mikrometern
+  kQuantisiert,  ///< Positionen auf ganze Millimeter, Texturkoordinaten und Normalen auf 1/4096 gerundet
+};
+
 struct BauParameter final {
   Hoehe hoehe;
   Mast mast;
@@ -27,12 +66,80 @@ struct BauParameter final {
   Rueckstrahlend rueckstrahlend;
   Ankerpunkt ankerpunkt;
   TexturDatei textur;
+  Triangulierung triangulierung;
+  IndexReihenfolge index_reihenfolge;
+  Detailstufe detailstufe;
+  Attributausgabe attributausgabe;
+  Genauigkeit genauigkeit;
+};
+
+// Alles, wovon der Text eines Vertex neben dem Vertex selbst abhaengt.
+struct Ausgabeformat final {
+  Attributausgabe attributausgabe = Attributausgabe::kVollstaendig;
+  Genauigkeit genauigkeit = Genauigkeit::kVoll;
+
+  bool operator==(const Ausgabeformat& other) const {
+    return attributausgabe == other.attributausgabe && genauigkeit == other.genauigkeit;
+  }
 };
 
-struct TafelParameter;
+inline Ausgabeformat AusgabeformatVon(const BauParameter& bauparameter) {
+  return { bauparameter.attributausgabe, bauparameter.genauigkeit };
+}
+
+// Abmessungen und Texturen einer Tafel, siehe HektoBuilder::BaueTafelParameter().
+/* Koordinatensystem:
+ *  y
+ *  ^
+ *  |
+ *  +-> x
+ */
+struct TafelParameter final {
+  int breite_mm;
+  int hoehe_mm;
+
+  int ziffernhoehe_mm;
+  int def_ziffernabstand_mm;
+  int max_ziffernabstand_mm;
+
+  int zifferndicke_mm;
+
+  const Textur& tex_tafel_vorderseite;
+  const Textur& tex_tafel_rueckseite;
+  const std::array<Textur, 11>& tex_ziffern;
+  const Textur& tex_mast;
+  const Textur& tex_transparent;
+
+  inline int XLinks() const {
+    return -breite_mm / 2;
+  }
+
+  inline int XRechts() const {
+    return -breite_mm / 2 + breite_mm;
+  }
+
+  inline int YUnten() const {
+    return -hoehe_mm / 2;
+  }
+
+  inline int YOben() const {
+    return -hoehe_mm / 2 + hoehe_mm;
+  }
+};
+
+// Version der erzeugten Dateien. Bei jeder beabsichtigten Aenderung der Ausgabe erhoehen, zusammen mit
+// testdaten/referenz_hashes.bin (hekto_korpus --schreibe prueft das); geht in die Schluessel des
+// Dateiindex ein, sodass veraltete Dateien neu erzeugt werden.
+constexpr uint32_t kAusgabeVersion = 1;
+
+// Groesster Betrag der Kilometer, den eine Tafel darstellen kann
+constexpr int kMaxKm = 999;
+
+// Groesster Betrag in Metern, den Kilometrierung::fromMeter() auf hoechstens kMaxKm rundet
+constexpr int kMaxWert_m = 1000 * kMaxKm + 949;
 
 struct Kilometrierung {
-  // Invariante: -oo < km < oo
+  // Invariante: -oo < km < oo; gebaut werden koennen nur Tafeln mit istDarstellbar()
   // Invariante: 0 <= |hm| <= 9
   // Invariante: km < 0 ==> hm < 0
   // Invariante: km > 0 ==> hm > 0
@@ -56,10 +163,20 @@ struct Kilometrierung {
   bool istNegativ() const {
     return hm < 0;
   }
+
+  bool istDarstellbar() const {
+    return std::abs(km) <= kMaxKm;
+  }
 };
 
 constexpr int kMaxUeberlaenge = 39;
 
+// Maximale Anzahl Ziffern der oberen bzw. unteren Zahl (inkl. Ueberlaenge)
+constexpr size_t kMaxZiffern = 3;
+
+// Zwei Stuetzpunkte (links und rechts) pro Ziffer
+using Stuetzpunkte = InlineVector<int, 2 * kMaxZiffern>;
+
 //       +-*--*-+
 //       |      |
 //       |      |
@@ -71,45 +188,154 @@ constexpr int kMaxUeberlaenge = 39;
 struct Ziffern final {
   Mesh mesh1;
   Mesh mesh2;
-  std::vector<int> stuetzpunkte_oben;
-  std::vector<int> stuetzpunkte_unten;
+  Stuetzpunkte stuetzpunkte_oben;
+  Stuetzpunkte stuetzpunkte_unten;
+};
+
+// Mesh, dessen Vertices bereits im Ausgabeformat von SubsetBuilder::Write vorliegen.
+// Die Faces werden erst beim Schreiben formatiert, da ihre Indizes von der
+// Position des Meshes im Subset abhaengen.
+struct VorformatierterMesh final {
+  Mesh mesh;
+  std::string vertices;
+  Ausgabeformat format;
 };
 
 class SubsetBuilder final {
  public:
-  SubsetBuilder(uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx);
+  SubsetBuilder(uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx, Ausgabeformat format = {});
   void AddMesh(const Mesh& mesh);
-  void Write(FILE* fd);
+  // Der vorformatierte Text wird nur verwendet, wenn er im selben Ausgabeformat vorliegt.
+  void AddMesh(std::shared_ptr<const VorformatierterMesh> mesh);
+  bool IsEmpty() const;
+  size_t AnzahlVertices() const { return m_mesh.vertices.size(); }
+  void Write(Ausgabe* ausgabe) const;
+
+  // Ordnet Faces und Vertices des gesamten Subsets fuer den Vertex-Cache um.
+  // Vorformatierte Meshes werden dabei aufgeloest und beim Schreiben neu formatiert.
+  void OptimiereVertexCache();
+
+  // Schreibt den Subset-Kopf mit Farben und Textur. Geometrie und Textur sind unabhaengig voneinander,
+  // sodass derselbe Inhalt mit verschiedenen Koepfen geschrieben werden kann.
+  static void WriteKopf(Ausgabe* ausgabe, uint32_t tagfarbe, uint32_t nachtfarbe, size_t textur_idx);
+  // Schreibt Vertices, Faces und das Subset-Ende.
+  void WriteInhalt(Ausgabe* ausgabe) const;
+
+  static VorformatierterMesh Vorformatieren(Mesh mesh, Ausgabeformat format);
  private:
   Mesh m_mesh {};
+  // Vorformatierte Meshes mit dem Index ihres ersten Vertex in m_mesh
+  std::vector<std::pair<VertexIndex, std::shared_ptr<const VorformatierterMesh>>> m_vorformatiert {};
   uint32_t tagfarbe_ {};
   uint32_t nachtfarbe_ {};
   size_t textur_idx_ {};
+  Ausgabeformat format_ {};
 };
 
 class TafelRueckseiteBuilder final {
  public:
   static Mesh Build(const TafelParameter& tp);
+  // Ein einzelnes Viereck ohne abgerundete Ecken
+  static Mesh BuildGrob(const TafelParameter& tp);
 };
 
 class TafelVorderseiteBuilder final {
  public:
-  static Mesh Build(const TafelParameter& tp, const std::vector<int>& stuetzpunkte_oben, const std::vector<int>& stuetzpunkte_unten);
+  static Mesh Build(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten,
+      Triangulierung triangulierung = Triangulierung::kFaecher);
+  // Rechtecke ohne abgerundete Ecken um die Ziffernzeilen herum, ohne Stuetzpunkte
+  static Mesh BuildGrob(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten);
+
+ private:
+  static Mesh BuildMinimal(const TafelParameter& tp, const Stuetzpunkte& stuetzpunkte_oben, const Stuetzpunkte& stuetzpunkte_unten);
+};
+
+// Anordnung der Ziffern auf der Tafel, Zwischenergebnis von ZiffernBuilder::Build().
+// X-Koordinaten in mm relativ zur Tafelmitte.
+struct ZiffernLayout final {
+  InlineVector<int, kMaxZiffern> ziffern_oben;
+  InlineVector<int, kMaxZiffern> ziffern_unten;  ///< Hektometer, ggf. gefolgt vom Ueberlaengen-Wert
+  InlineVector<int, kMaxZiffern + 1> abstaende_oben;  ///< links, zwischen den Ziffern, rechts
+  InlineVector<int, kMaxZiffern + 1> abstaende_unten;
+  InlineVector<std::pair<int, int>, 2 * kMaxZiffern> intervalle_oben;  ///< zulaessige Bereiche der Stuetzpunkte
+  InlineVector<std::pair<int, int>, 2 * kMaxZiffern> intervalle_unten;
+  Stuetzpunkte stuetzpunkte_oben;
+  Stuetzpunkte stuetzpunkte_unten;
 };
 
 class ZiffernBuilder final {
  public:
-  static Ziffern Build(const TafelParameter& tp, bool ist_negativ, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge);
+  static ZiffernLayout Layout(const TafelParameter& tp, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge);
+
+  // Ab Detailstufe kGrob wird jede Ziffer als einfaches Viereck ohne die Stuetzpunkte der anderen Zeile erzeugt.
+  static Ziffern Build(const TafelParameter& tp, bool ist_negativ, int zahl_oben, int ziffer_unten, std::optional<int> ueberlaenge,
+      Detailstufe detailstufe = Detailstufe::kVoll);
 };
 
 class MastBuilder final {
  public:
-  static Mesh Build(const TafelParameter& tp);
+  // In der Detailstufe kFern ohne Deckel
+  static Mesh Build(const TafelParameter& tp, Detailstufe detailstufe = Detailstufe::kVoll);
+};
+
+// Textur-Variante einer Tafel und das Ziel, in das sie geschrieben wird.
+struct TexturVariante final {
+  TexturDatei textur;
+  Rueckstrahlend rueckstrahlend;
+  Ausgabe* ausgabe;
+};
+
+// Geometrie einer Tafel, aufgeteilt auf die beiden Subsets einer Landschaftsdatei.
+struct TafelMeshes final {
+  Mesh beleuchtet;  ///< Vorderseite(n) rueckstrahlender Tafeln
+  Mesh unbeleuchtet;
+};
+
+// Datei einer Detailstufe, wie sie in der Verknuepfungsdatei referenziert wird.
+struct DetailstufenDatei final {
+  Detailstufe detailstufe;
+  std::string dateiname;  ///< Zusi-Pfad oder Dateiname relativ zur verknuepfenden Datei
 };
 
+// Eine Datei, die in einer Platzierungsdatei an der angegebenen Stelle verknuepft wird.
+struct VerknuepfteDatei final {
+  std::string dateiname;  ///< Zusi-Pfad oder Dateiname relativ zur verknuepfenden Datei
+  Koordinate x, y, z;
+  double richtung;  ///< Drehung um die Z-Achse im Bogenmass
+};
+
+// Alle Build-Funktionen setzen kilometrierung.istDarstellbar() voraus; Aufrufer pruefen Eingaben vorher.
 class HektoBuilder final {
  public:
   static void Build(FILE* fd, const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm);
+  static void Build(Ausgabe* ausgabe, const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm);
+
+  // Erzeugt die Geometrie einmal und schreibt sie in jede der angegebenen Varianten.
+  // `textur` und `rueckstrahlend` aus `bauparameter` werden ignoriert.
+  // Falls `mesh_fehler` gesetzt ist, wird die Geometrie vorher mit ValidateMesh() geprueft; bei Fehlern
+  // wird nichts geschrieben und die Fehler stehen in `mesh_fehler`.
+  static void BuildVarianten(const std::vector<TexturVariante>& varianten,
+      const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm,
+      std::vector<MeshFehler>* mesh_fehler = nullptr);
+
+  // Erzeugt die Geometrie einer Tafel ohne Ankerpunkte, etwa um mehrere Tafeln in einer Datei zusammenzufassen.
+  static TafelMeshes BuildMeshes(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm);
+
+  // Abmessungen und (je nach Wert gespiegelte) Texturen der Tafel fuer den angegebenen Wert.
+  static TafelParameter BaueTafelParameter(Groesse groesse, bool ist_negativ, int zahl_oben, int ziffer_unten,
+      std::optional<int> ueberlaenge_hm);
+
+  // Schreibt eine Landschaftsdatei mit den beiden Subsets, Farben und Textur wie bei Build().
+  static void WriteLandschaft(Ausgabe* ausgabe, TexturDatei textur, const SubsetBuilder& beleuchtet, const SubsetBuilder& unbeleuchtet);
+
+  // Schreibt eine Landschaftsdatei, die die Dateien der Detailstufen mit passendem LODbit verknuepft
+  // (kVoll: LOD 0, kGrob: LOD 1, kFern: LOD 2 und 3), sowie ggf. die Ankerpunkte der Tafel.
+  // Die Dateien der Detailstufen sollten deshalb ohne Ankerpunkte erzeugt werden.
+  static void BuildVerknuepfung(Ausgabe* ausgabe, const BauParameter& bauparameter, const std::vector<DetailstufenDatei>& dateien);
+
+  // Schreibt eine Landschaftsdatei, die jede der Dateien mit Position und Drehung verknuepft,
+  // im selben Format wie die Ankerpunkte (Nullwerte werden weggelassen).
+  static void BuildPlatzierung(Ausgabe* ausgabe, const std::vector<VerknuepfteDatei>& dateien);
 };
 
 #endif  // HEKTO_BUILDER_HPP_
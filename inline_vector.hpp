@@ -0,0 +1,98 @@
+// Copyright 2026 Zusitools
+
+#ifndef INLINE_VECTOR_HPP_
+#define INLINE_VECTOR_HPP_
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+/**
+ * Vektor mit fester Maximalgroesse N, dessen Elemente direkt im Objekt
+ * gespeichert werden (keine Heap-Allokation). Gedacht fuer kleine Werttypen.
+ * Ein Ueberlauf bricht das Programm auch in Release-Builds ab.
+ */
+template <typename T, size_t N>
+class InlineVector final {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr InlineVector() = default;
+
+  constexpr InlineVector(std::initializer_list<T> init) {
+    for (const auto& wert : init) {
+      push_back(wert);
+    }
+  }
+
+  static constexpr size_t capacity() { return N; }
+  constexpr size_t size() const { return groesse_; }
+  constexpr bool empty() const { return groesse_ == 0; }
+
+  constexpr void push_back(const T& wert) {
+    PruefeKapazitaet();
+    daten_[groesse_++] = wert;
+  }
+
+  template <typename... Args>
+  constexpr T& emplace_back(Args&&... args) {
+    PruefeKapazitaet();
+    daten_[groesse_] = T(std::forward<Args>(args)...);
+    return daten_[groesse_++];
+  }
+
+  constexpr void pop_back() {
+    assert(groesse_ > 0);
+    --groesse_;
+  }
+
+  // Entfernt das Element an Position `i`; nachfolgende Elemente ruecken auf.
+  constexpr void erase_at(size_t i) {
+    assert(i < groesse_);
+    for (size_t j = i + 1; j < groesse_; ++j) {
+      daten_[j - 1] = std::move(daten_[j]);
+    }
+    --groesse_;
+  }
+
+  constexpr void clear() { groesse_ = 0; }
+
+  constexpr T& operator[](size_t i) { assert(i < groesse_); return daten_[i]; }
+  constexpr const T& operator[](size_t i) const { assert(i < groesse_); return daten_[i]; }
+
+  constexpr T& front() { assert(groesse_ > 0); return daten_[0]; }
+  constexpr const T& front() const { assert(groesse_ > 0); return daten_[0]; }
+  constexpr T& back() { assert(groesse_ > 0); return daten_[groesse_ - 1]; }
+  constexpr const T& back() const { assert(groesse_ > 0); return daten_[groesse_ - 1]; }
+
+  constexpr iterator begin() { return daten_.data(); }
+  constexpr const_iterator begin() const { return daten_.data(); }
+  constexpr iterator end() { return daten_.data() + groesse_; }
+  constexpr const_iterator end() const { return daten_.data() + groesse_; }
+
+  constexpr reverse_iterator rbegin() { return reverse_iterator(end()); }
+  constexpr const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  constexpr reverse_iterator rend() { return reverse_iterator(begin()); }
+  constexpr const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+ private:
+  constexpr void PruefeKapazitaet() const {
+    if (groesse_ >= N) {
+      std::abort();
+    }
+  }
+
+  std::array<T, N> daten_ {};
+  size_t groesse_ = 0;
+};
+
+#endif  // INLINE_VECTOR_HPP_
@@ -0,0 +1,403 @@
+// Copyright 2026 Zusitools
+
+#include "io_uring_schreiber.hpp"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace {
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+constexpr int kOpenFlags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+constexpr mode_t kOpenModus = 0644;
+
+}  // namespace
+
+// Minimale io_uring-Anbindung ohne liburing.
+struct IoUringDateiSchreiber::Ring final {
+  int fd = -1;
+
+  void* sq_ptr = MAP_FAILED;
+  size_t sq_laenge = 0;
+  void* cq_ptr = MAP_FAILED;
+  size_t cq_laenge = 0;
+  io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_laenge = 0;
+
+  unsigned* sq_tail = nullptr;
+  unsigned* sq_mask = nullptr;
+  unsigned* sq_array = nullptr;
+  unsigned sq_eintraege = 0;
+
+  unsigned* cq_head = nullptr;
+  unsigned* cq_tail = nullptr;
+  unsigned* cq_mask = nullptr;
+  io_uring_cqe* cqes = nullptr;
+
+  unsigned vorbereitet = 0;  ///< SQEs seit dem letzten Einreichen
+  bool hat_unlinkat = false;  ///< IORING_OP_UNLINKAT gibt es erst seit Linux 5.11
+
+  ~Ring() {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_laenge);
+    }
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+      munmap(cq_ptr, cq_laenge);
+    }
+    if (sq_ptr != MAP_FAILED) {
+      munmap(sq_ptr, sq_laenge);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  // Gibt nullptr zurueck, falls io_uring oder eine der benoetigten Operationen nicht verfuegbar ist.
+  static std::unique_ptr<Ring> Erstelle(unsigned eintraege) {
+    auto ring = std::make_unique<Ring>();
+
+    io_uring_params params {};
+    ring->fd = io_uring_setup(eintraege, &params);
+    if (ring->fd < 0) {
+      return nullptr;
+    }
+
+    // IORING_REGISTER_PROBE gibt es seit Linux 5.6, ebenso IORING_OP_OPENAT und IORING_OP_CLOSE.
+    constexpr unsigned kAnzahlOps = 256;
+    std::vector<char> probe_speicher(sizeof(io_uring_probe) + kAnzahlOps * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(probe_speicher.data());
+    if (io_uring_register(ring->fd, IORING_REGISTER_PROBE, probe, kAnzahlOps) < 0) {
+      return nullptr;
+    }
+    for (const auto op : { IORING_OP_OPENAT, IORING_OP_WRITE_FIXED, IORING_OP_WRITE, IORING_OP_CLOSE }) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+        return nullptr;
+      }
+    }
+    ring->hat_unlinkat = IORING_OP_UNLINKAT <= probe->last_op && (probe->ops[IORING_OP_UNLINKAT].flags & IO_URING_OP_SUPPORTED);
+
+    ring->sq_laenge = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_laenge = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->sq_laenge = ring->cq_laenge = std::max(ring->sq_laenge, ring->cq_laenge);
+    }
+
+    ring->sq_ptr = mmap(nullptr, ring->sq_laenge, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+      return nullptr;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->cq_ptr = ring->sq_ptr;
+    } else {
+      ring->cq_ptr = mmap(nullptr, ring->cq_laenge, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+      if (ring->cq_ptr == MAP_FAILED) {
+        return nullptr;
+      }
+    }
+
+    ring->sqes_laenge = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqes_laenge, PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+      return nullptr;
+    }
+
+    auto* sq = static_cast<char*>(ring->sq_ptr);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sq_eintraege = params.sq_entries;
+
+    auto* cq = static_cast<char*>(ring->cq_ptr);
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return ring;
+  }
+
+  io_uring_sqe* NeueSqe() {
+    const unsigned tail = *sq_tail + vorbereitet;
+    const unsigned idx = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[idx] = idx;
+    ++vorbereitet;
+    return sqe;
+  }
+
+  // Reicht alle vorbereiteten SQEs ein und ruft `verarbeite(user_data, res)` fuer `anzahl` Ergebnisse auf.
+  template <typename Fn>
+  bool ReicheEinUndWarte(unsigned anzahl, Fn&& verarbeite) {
+    __atomic_store_n(sq_tail, *sq_tail + vorbereitet, __ATOMIC_RELEASE);
+    unsigned einzureichen = vorbereitet;
+    vorbereitet = 0;
+
+    unsigned erhalten = 0;
+    while (erhalten < anzahl) {
+      const int ret = io_uring_enter(fd, einzureichen, 1, IORING_ENTER_GETEVENTS);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      einzureichen -= std::min(einzureichen, static_cast<unsigned>(ret));
+
+      unsigned head = *cq_head;
+      const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & *cq_mask];
+        verarbeite(cqe.user_data, cqe.res);
+        ++erhalten;
+      }
+      __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+    return true;
+  }
+};
+
+IoUringDateiSchreiber::IoUringDateiSchreiber(std::string zielverzeichnis, size_t stapelgroesse, size_t puffergroesse)
+    : zielverzeichnis_(std::move(zielverzeichnis)), stapelgroesse_(std::max<size_t>(stapelgroesse, 1)),
+    puffergroesse_(puffergroesse) {
+  // Pro Datei werden in der zweiten Phase zwei SQEs (Schreiben + Schliessen) benoetigt.
+  ring_ = Ring::Erstelle(static_cast<unsigned>(2 * stapelgroesse_));
+  if (ring_ == nullptr) {
+    return;
+  }
+
+  puffer_ = std::make_unique<char[]>(stapelgroesse_ * puffergroesse_);
+  std::vector<iovec> iovecs(stapelgroesse_);
+  for (size_t i = 0; i < stapelgroesse_; ++i) {
+    iovecs[i].iov_base = Puffer(i);
+    iovecs[i].iov_len = puffergroesse_;
+  }
+  if (io_uring_register(ring_->fd, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) < 0) {
+    // z.B. RLIMIT_MEMLOCK zu klein
+    ring_.reset();
+    puffer_.reset();
+    return;
+  }
+  offen_.reserve(stapelgroesse_);
+}
+
+IoUringDateiSchreiber::~IoUringDateiSchreiber() {
+  Abschliessen();
+}
+
+bool IoUringDateiSchreiber::SchreibeDirekt(const std::string& voller_pfad, const char* daten, size_t laenge) {
+  unlink(voller_pfad.c_str());
+  int fd = open(voller_pfad.c_str(), kOpenFlags, kOpenModus);
+  if (fd < 0 && errno == ENOENT) {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(voller_pfad).parent_path(), ec);
+    fd = open(voller_pfad.c_str(), kOpenFlags, kOpenModus);
+  }
+  if (fd < 0) {
+    return false;
+  }
+
+  bool ok = true;
+  while (laenge > 0) {
+    const ssize_t geschrieben = write(fd, daten, laenge);
+    if (geschrieben < 0 && errno == EINTR) {
+      continue;
+    }
+    if (geschrieben <= 0) {
+      ok = false;
+      break;
+    }
+    daten += geschrieben;
+    laenge -= geschrieben;
+  }
+  return (close(fd) == 0) && ok;
+}
+
+bool IoUringDateiSchreiber::SchreibeDatei(const std::string& pfad, const std::string& inhalt) {
+  auto voller_pfad = (std::filesystem::path(zielverzeichnis_) / pfad).string();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ring_ == nullptr) {
+    return SchreibeDirekt(voller_pfad, inhalt.data(), inhalt.size());
+  }
+
+  OffeneDatei datei { pfad, std::move(voller_pfad), inhalt.size(), {}, -1, 0, false };
+  if (inhalt.size() <= puffergroesse_) {
+    std::memcpy(Puffer(offen_.size()), inhalt.data(), inhalt.size());
+  } else {
+    datei.inhalt_gross = inhalt;
+  }
+  offen_.push_back(std::move(datei));
+
+  if (offen_.size() == stapelgroesse_) {
+    return SchreibeStapel(offen_.size() - 1);
+  }
+  return true;
+}
+
+bool IoUringDateiSchreiber::SchreibeStapel(size_t eigene) {
+  if (offen_.empty()) {
+    return true;
+  }
+
+  // Phase 1: Vorhandene Dateien entfernen (siehe DateiSchreiber::SchreibeDatei) und alle Dateien oeffnen.
+  // Das Oeffnen ist hart verkettet und findet auch statt, wenn es nichts zu entfernen gab.
+  unsigned anzahl_phase1 = 0;
+  for (size_t i = 0; i < offen_.size(); ++i) {
+    io_uring_sqe* sqe;
+    if (ring_->hat_unlinkat) {
+      sqe = ring_->NeueSqe();
+      sqe->opcode = IORING_OP_UNLINKAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<uintptr_t>(offen_[i].voller_pfad.c_str());
+      sqe->flags = IOSQE_IO_HARDLINK;
+      sqe->user_data = 2 * i;
+      ++anzahl_phase1;
+    } else {
+      unlink(offen_[i].voller_pfad.c_str());
+    }
+
+    sqe = ring_->NeueSqe();
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<uintptr_t>(offen_[i].voller_pfad.c_str());
+    sqe->len = kOpenModus;
+    sqe->open_flags = kOpenFlags;
+    sqe->user_data = 2 * i + 1;
+    ++anzahl_phase1;
+  }
+  const bool geoeffnet = ring_->ReicheEinUndWarte(anzahl_phase1, [this](uint64_t user_data, int res) {
+    if (user_data % 2 == 1) {
+      offen_[user_data / 2].fd = res;
+    }
+  });
+  if (!geoeffnet) {
+    // Welche Dateien geoeffnet wurden, ist nicht bekannt
+    for (auto& datei : offen_) {
+      datei.fd = -1;
+      datei.fehler = true;
+    }
+  }
+
+  // Fehlende Verzeichnisse anlegen und direkt schreiben
+  for (size_t i = 0; i < offen_.size(); ++i) {
+    auto& datei = offen_[i];
+    if (datei.fd < 0 && !datei.fehler) {
+      const char* daten = datei.inhalt_gross.empty() ? Puffer(i) : datei.inhalt_gross.data();
+      datei.fehler = (datei.fd != -ENOENT) || !SchreibeDirekt(datei.voller_pfad, daten, datei.laenge);
+      datei.geschrieben = datei.laenge;
+      datei.fd = -1;
+    }
+  }
+
+  // Phase 2: Schreiben und Schliessen, jeweils verkettet. Nach einem kurzen Schreibvorgang wird das
+  // Schliessen abgebrochen und der Rest in einer weiteren Runde eingereicht.
+  while (true) {
+    unsigned anzahl = 0;
+    for (size_t i = 0; i < offen_.size(); ++i) {
+      const auto& datei = offen_[i];
+      if (datei.fd < 0) {
+        continue;
+      }
+
+      io_uring_sqe* sqe = ring_->NeueSqe();
+      if (datei.inhalt_gross.empty()) {
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->addr = reinterpret_cast<uintptr_t>(Puffer(i) + datei.geschrieben);
+        sqe->buf_index = static_cast<uint16_t>(i);
+      } else {
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->addr = reinterpret_cast<uintptr_t>(datei.inhalt_gross.data() + datei.geschrieben);
+      }
+      sqe->fd = datei.fd;
+      sqe->len = static_cast<uint32_t>(datei.laenge - datei.geschrieben);
+      sqe->off = datei.geschrieben;
+      sqe->flags = IOSQE_IO_LINK;
+      sqe->user_data = 2 * i;
+
+      sqe = ring_->NeueSqe();
+      sqe->opcode = IORING_OP_CLOSE;
+      sqe->fd = datei.fd;
+      sqe->user_data = 2 * i + 1;
+      anzahl += 2;
+    }
+    if (anzahl == 0) {
+      break;
+    }
+
+    const bool ok = ring_->ReicheEinUndWarte(anzahl, [this](uint64_t user_data, int res) {
+      auto& datei = offen_[user_data / 2];
+      if (user_data % 2 == 0) {
+        if (res > 0) {
+          datei.geschrieben += res;
+        } else if (res != -EINTR && res != -EAGAIN) {
+          datei.fehler = true;  // auch bei 0 Bytes, sonst kaeme das Schreiben nie voran
+        }
+      } else if (res == -ECANCELED) {
+        // Schliessen wurde wegen eines fehlgeschlagenen oder kurzen Schreibvorgangs abgebrochen
+        if (datei.fehler) {
+          close(datei.fd);
+          datei.fd = -1;
+        }
+      } else {
+        datei.fehler |= (res != 0) || (datei.geschrieben != datei.laenge);
+        datei.fd = -1;
+      }
+    });
+    if (!ok) {
+      // Der Zustand der eingereichten Operationen ist unbekannt; die Dateien bleiben offen.
+      for (auto& datei : offen_) {
+        datei.fehler |= datei.fd >= 0;
+        datei.fd = -1;
+      }
+    }
+  }
+
+  bool result = true;
+  for (size_t i = 0; i < offen_.size(); ++i) {
+    const auto& datei = offen_[i];
+    if (i == eigene) {
+      result = !datei.fehler;
+    } else if (datei.fehler) {
+      fehlgeschlagen_.push_back({ datei.pfad, datei.laenge });
+    }
+  }
+  offen_.clear();
+  return result;
+}
+
+bool IoUringDateiSchreiber::Abschliessen() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ring_ != nullptr) {
+    SchreibeStapel(SIZE_MAX);
+  }
+  return true;
+}
+
+std::vector<SchreibFehler> IoUringDateiSchreiber::NachtraeglicheFehler() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fehlgeschlagen_;
+}
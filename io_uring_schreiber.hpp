@@ -0,0 +1,67 @@
+// Copyright 2026 Zusitools
+
+#ifndef IO_URING_SCHREIBER_HPP_
+#define IO_URING_SCHREIBER_HPP_
+
+#include "batch.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * DateiSchreiber fuer Linux, der Dateien stapelweise per io_uring schreibt:
+ * Alle Oeffnen-Operationen eines Stapels werden gemeinsam eingereicht, jeweils nach dem Entfernen
+ * einer vorhandenen Datei, danach alle Schreib- und Schliessen-Operationen (verkettet) aus registrierten Puffern.
+ * So fallen pro Stapel statt pro Datei zwei Systemaufrufe an.
+ *
+ * Ist io_uring nicht verfuegbar (alter Kernel, seccomp), wird jede Datei
+ * mit open/write/close geschrieben.
+ */
+class IoUringDateiSchreiber final : public DateiSchreiber {
+ public:
+  explicit IoUringDateiSchreiber(std::string zielverzeichnis, size_t stapelgroesse = 64, size_t puffergroesse = 128 * 1024);
+  ~IoUringDateiSchreiber() override;
+
+  IoUringDateiSchreiber(const IoUringDateiSchreiber&) = delete;
+  IoUringDateiSchreiber& operator=(const IoUringDateiSchreiber&) = delete;
+
+  bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) override;
+  bool Abschliessen() override;
+  std::vector<SchreibFehler> NachtraeglicheFehler() const override;
+
+  bool NutztIoUring() const { return ring_ != nullptr; }
+
+ private:
+  struct Ring;
+
+  struct OffeneDatei final {
+    std::string pfad;  ///< wie an SchreibeDatei() uebergeben
+    std::string voller_pfad;
+    size_t laenge;
+    std::string inhalt_gross;  ///< nur belegt, falls der Inhalt nicht in einen registrierten Puffer passt
+    int fd;  ///< -1, falls nicht (mehr) geoeffnet
+    size_t geschrieben;
+    bool fehler;
+  };
+
+  bool SchreibeDirekt(const std::string& voller_pfad, const char* daten, size_t laenge);
+  // Schreibt alle gesammelten Dateien. Das Ergebnis der Datei `eigene` (Index in offen_) wird
+  // zurueckgegeben, die uebrigen fehlgeschlagenen Dateien landen in fehlgeschlagen_.
+  bool SchreibeStapel(size_t eigene);
+  char* Puffer(size_t idx) { return puffer_.get() + idx * puffergroesse_; }
+
+  const std::string zielverzeichnis_;
+  const size_t stapelgroesse_;
+  const size_t puffergroesse_;
+
+  mutable std::mutex mutex_;
+  std::unique_ptr<Ring> ring_;
+  std::unique_ptr<char[]> puffer_;  ///< stapelgroesse_ registrierte Puffer zu je puffergroesse_ Bytes
+  std::vector<OffeneDatei> offen_;
+  std::vector<SchreibFehler> fehlgeschlagen_;
+};
+
+#endif  // IO_URING_SCHREIBER_HPP_
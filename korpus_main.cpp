@@ -0,0 +1,386 @@
+// Copyright 2026 Zusitools
+
+#include "batch.hpp"
+#include "hekto_builder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Referenzkorpus fuer byte-genaue Ausgabe: erzeugt jede Tafel des Korpus (alle Kombinationen der
+ * Bauparameter sowie die Ziffernanordnungen aller Kilometer) in eine Hash-Ausgabe und vergleicht die
+ * Hashes mit einer eingecheckten Tabelle. Neben dem Hash der ganzen Datei enthaelt die Tabelle kurze
+ * Hashes von Bloecken fester Groesse, damit eine Abweichung auf einen Byte-Bereich eingegrenzt werden kann.
+ */
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+constexpr char kKennung[8] = { 'H', 'E', 'K', 'T', 'O', 'R', 'E', 'F' };
+constexpr uint32_t kVersion = 2;
+constexpr uint32_t kBlockgroesse = 1024;
+
+struct Kopf final {
+  char kennung[8];
+  uint32_t version;
+  uint32_t blockgroesse;
+  uint64_t anzahl_tafeln;
+  uint64_t anzahl_bloecke;
+  uint32_t ausgabe_version;  ///< kAusgabeVersion beim Schreiben
+  uint32_t reserviert;
+};
+static_assert(sizeof(Kopf) == 40);
+
+struct Eintrag final {
+  uint64_t hash;
+  uint32_t laenge;
+  uint32_t erster_block;  ///< Index in die Blockhashes nach den Eintraegen
+};
+static_assert(sizeof(Eintrag) == 16);
+
+void Hilfe(const char* programm) {
+  fprintf(stderr,
+      "Aufruf: %s [Optionen] <Tabelle>\n"
+      "\n"
+      "Erzeugt alle Tafeln des Referenzkorpus und vergleicht ihre Hashes mit der Tabelle.\n"
+      "Endet mit Fehlercode 1 und nennt die erste abweichende Tafel, falls sich die Ausgabe geaendert hat,\n"
+      "oder falls die Tabelle zu einer anderen kAusgabeVersion gehoert.\n"
+      "\n"
+      "  --schreibe                Tabelle neu schreiben statt vergleichen; weicht die Ausgabe von einer\n"
+      "                            vorhandenen Tabelle derselben kAusgabeVersion ab, muss diese erst erhoeht werden\n"
+      "  --threads <n>             Anzahl Threads (Standard: Anzahl Prozessorkerne)\n",
+      programm);
+}
+
+struct KorpusTafel final {
+  BauParameter bauparameter;
+  int wert_m;
+  std::optional<int> ueberlaenge_hm;
+
+  std::string Name() const {
+    const auto& bp = bauparameter;
+    char result[256];
+    snprintf(result, sizeof(result), "%s (Hoehe %d, Ankerpunkt %d, Textur %d, Triangulierung %d, Indexreihenfolge %d, "
+        "Detailstufe %d, Attributausgabe %d, Genauigkeit %d)",
+        Dateiname(bp, Kilometrierung::fromMeter(wert_m), ueberlaenge_hm).c_str(), static_cast<int>(bp.hoehe),
+        static_cast<int>(bp.ankerpunkt), static_cast<int>(bp.textur), static_cast<int>(bp.triangulierung),
+        static_cast<int>(bp.index_reihenfolge), static_cast<int>(bp.detailstufe), static_cast<int>(bp.attributausgabe),
+        static_cast<int>(bp.genauigkeit));
+    return result;
+  }
+};
+
+// Die Reihenfolge ist Teil des Tabellenformats; neue Tafeln nur am Ende anfuegen.
+std::vector<KorpusTafel> Korpus() {
+  std::vector<KorpusTafel> result;
+
+  // Jede Kombination der Bauparameter, reihum mit einer dieser Kilometrierungen:
+  // ein- bis dreistellig, negativ, mit Ueberlaenge und mit unterschnittenen Ziffernpaaren.
+  const std::pair<int, std::optional<int>> kWerte[] = {
+    { 0, std::nullopt }, { 3400, 7 }, { -12300, std::nullopt }, { 70400, 5 },
+    { 123500, kMaxUeberlaenge }, { 999900, std::nullopt }, { 47700, 0 },
+  };
+  constexpr int kAnzahlKombinationen = 2 * 2 * 2 * 2 * 2 * 2 * 4 * 2 * 2 * 3 * 2 * 2;
+  for (int i = 0; i < kAnzahlKombinationen; ++i) {
+    int rest = i;
+    auto Waehle = [&rest](int anzahl) {
+      const int wert = rest % anzahl;
+      rest /= anzahl;
+      return wert;
+    };
+    const BauParameter bauparameter {
+      static_cast<Hoehe>(Waehle(2)),
+      static_cast<Mast>(Waehle(2)),
+      static_cast<Beidseitig>(Waehle(2)),
+      static_cast<Groesse>(Waehle(2)),
+      static_cast<Rueckstrahlend>(Waehle(2)),
+      static_cast<Ankerpunkt>(Waehle(2)),
+      static_cast<TexturDatei>(Waehle(4)),
+      static_cast<Triangulierung>(Waehle(2)),
+      static_cast<IndexReihenfolge>(Waehle(2)),
+      static_cast<Detailstufe>(Waehle(3)),
+      static_cast<Attributausgabe>(Waehle(2)),
+      static_cast<Genauigkeit>(Waehle(2)),
+    };
+    const auto& [wert_m, ueberlaenge_hm] = kWerte[i % std::size(kWerte)];
+    result.push_back({ bauparameter, wert_m, ueberlaenge_hm });
+  }
+
+  // Jeder Kilometer beider Groessen und Vorzeichen mit Standard-Bauparametern, wechselnde Hektometer
+  // und Ueberlaengen-Werte
+  for (const auto groesse : { Groesse::kGross, Groesse::kKlein }) {
+    for (const int vorzeichen : { 1, -1 }) {
+      for (int km = 0; km < 1000; ++km) {
+        BauParameter bauparameter {};
+        bauparameter.groesse = groesse;
+        const int hm = km % 10;
+        std::optional<int> ueberlaenge_hm;
+        if (vorzeichen > 0 && km % 2 == 1) {
+          ueberlaenge_hm = km % (kMaxUeberlaenge + 1);
+        }
+        result.push_back({ bauparameter, vorzeichen * (1000 * km + 100 * hm), ueberlaenge_hm });
+      }
+    }
+  }
+  return result;
+}
+
+// Hash einer Tafel: FNV-1a je Block, der Gesamthash aus den vollen Blockhashes.
+struct TafelHash final {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  uint32_t laenge = 0;
+  std::vector<uint16_t> bloecke;
+};
+
+class HashAusgabe final : public Ausgabe {
+ public:
+  explicit HashAusgabe(TafelHash* ziel) : ziel_(ziel) { }
+
+  void Schreibe(const char* daten, size_t laenge) override {
+    for (size_t i = 0; i < laenge; ++i) {
+      block_hash_ = (block_hash_ ^ static_cast<unsigned char>(daten[i])) * 0x100000001b3ull;
+      if (++block_laenge_ == kBlockgroesse) {
+        BeendeBlock();
+      }
+    }
+  }
+  using Ausgabe::Schreibe;
+
+  void Abschliessen() {
+    if (block_laenge_ != 0) {
+      BeendeBlock();
+    }
+  }
+
+ private:
+  void BeendeBlock() {
+    ziel_->hash = (ziel_->hash ^ block_hash_) * 0x100000001b3ull;
+    ziel_->laenge += block_laenge_;
+    ziel_->bloecke.push_back(static_cast<uint16_t>(block_hash_ ^ (block_hash_ >> 16) ^ (block_hash_ >> 32) ^ (block_hash_ >> 48)));
+    block_hash_ = kStartwert;
+    block_laenge_ = 0;
+  }
+
+  static constexpr uint64_t kStartwert = 0xcbf29ce484222325ull;
+  TafelHash* const ziel_;
+  uint64_t block_hash_ = kStartwert;
+  uint32_t block_laenge_ = 0;
+};
+
+bool SchreibeTabelle(const std::string& pfad, const std::vector<TafelHash>& hashes) {
+  Kopf kopf {};
+  memcpy(kopf.kennung, kKennung, sizeof(kKennung));
+  kopf.version = kVersion;
+  kopf.blockgroesse = kBlockgroesse;
+  kopf.anzahl_tafeln = hashes.size();
+  kopf.ausgabe_version = kAusgabeVersion;
+
+  std::vector<Eintrag> eintraege;
+  std::vector<uint16_t> bloecke;
+  for (const auto& tafel : hashes) {
+    eintraege.push_back({ tafel.hash, tafel.laenge, static_cast<uint32_t>(bloecke.size()) });
+    bloecke.insert(std::end(bloecke), std::begin(tafel.bloecke), std::end(tafel.bloecke));
+  }
+  kopf.anzahl_bloecke = bloecke.size();
+
+  FILE* fd = fopen(pfad.c_str(), "wb");
+  if (fd == nullptr) {
+    return false;
+  }
+  const bool ok = fwrite(&kopf, sizeof(kopf), 1, fd) == 1
+    && fwrite(eintraege.data(), sizeof(Eintrag), eintraege.size(), fd) == eintraege.size()
+    && fwrite(bloecke.data(), sizeof(uint16_t), bloecke.size(), fd) == bloecke.size();
+  return (fclose(fd) == 0) && ok;
+}
+
+bool LiesTabelle(const std::string& pfad, std::vector<TafelHash>* hashes, uint32_t* ausgabe_version, std::string* fehler) {
+  FILE* fd = fopen(pfad.c_str(), "rb");
+  if (fd == nullptr) {
+    *fehler = "Kann " + pfad + " nicht oeffnen";
+    return false;
+  }
+  Kopf kopf;
+  std::vector<Eintrag> eintraege;
+  std::vector<uint16_t> bloecke;
+  bool ok = fread(&kopf, sizeof(kopf), 1, fd) == 1 && !memcmp(kopf.kennung, kKennung, sizeof(kKennung))
+    && kopf.version == kVersion && kopf.blockgroesse == kBlockgroesse;
+  if (ok) {
+    eintraege.resize(kopf.anzahl_tafeln);
+    bloecke.resize(kopf.anzahl_bloecke);
+    ok = fread(eintraege.data(), sizeof(Eintrag), eintraege.size(), fd) == eintraege.size()
+      && fread(bloecke.data(), sizeof(uint16_t), bloecke.size(), fd) == bloecke.size();
+  }
+  fclose(fd);
+  if (!ok) {
+    *fehler = pfad + " ist keine Referenztabelle dieser Version";
+    return false;
+  }
+
+  *ausgabe_version = kopf.ausgabe_version;
+  hashes->resize(eintraege.size());
+  for (size_t i = 0; i < eintraege.size(); ++i) {
+    const auto& eintrag = eintraege[i];
+    const size_t anzahl = (eintrag.laenge + kBlockgroesse - 1) / kBlockgroesse;
+    if (eintrag.erster_block + anzahl > bloecke.size()) {
+      *fehler = pfad + " ist beschaedigt";
+      return false;
+    }
+    auto& tafel = (*hashes)[i];
+    tafel.hash = eintrag.hash;
+    tafel.laenge = eintrag.laenge;
+    tafel.bloecke.assign(std::begin(bloecke) + eintrag.erster_block, std::begin(bloecke) + eintrag.erster_block + anzahl);
+  }
+  return true;
+}
+
+// Byte, ab dem sich die Tafeln unterscheiden, sowie die Genauigkeit dieser Angabe.
+std::pair<uint32_t, uint32_t> ErsteAbweichung(const TafelHash& referenz, const TafelHash& aktuell) {
+  const size_t anzahl = std::min(referenz.bloecke.size(), aktuell.bloecke.size());
+  for (size_t i = 0; i < anzahl; ++i) {
+    if (referenz.bloecke[i] != aktuell.bloecke[i]) {
+      return { static_cast<uint32_t>(i * kBlockgroesse), kBlockgroesse };
+    }
+  }
+  // Alle gemeinsamen Bloecke gleich: Die kuerzere Datei ist der Anfang der laengeren. Bei gleicher Laenge
+  // kollidieren die kurzen Blockhashes, dann ist nur bekannt, dass sich die Dateien unterscheiden.
+  if (referenz.laenge != aktuell.laenge) {
+    return { std::min(referenz.laenge, aktuell.laenge), 1 };
+  }
+  return { 0, referenz.laenge };
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t anzahl_threads = 0;
+  bool schreiben = false;
+  const char* tabelle = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hat_wert = i + 1 < argc;
+    if (!strcmp(arg, "--threads") && hat_wert) {
+      anzahl_threads = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(arg, "--schreibe")) {
+      schreiben = true;
+    } else if (arg[0] != '-' && tabelle == nullptr) {
+      tabelle = arg;
+    } else {
+      Hilfe(argv[0]);
+      return 1;
+    }
+  }
+  if (tabelle == nullptr) {
+    Hilfe(argv[0]);
+    return 1;
+  }
+  if (anzahl_threads == 0) {
+    anzahl_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Beim Schreiben ist die alte Tabelle optional; sie dient nur der Pruefung von kAusgabeVersion.
+  std::vector<TafelHash> referenz;
+  uint32_t referenz_version = 0;
+  std::string fehler;
+  if (!LiesTabelle(tabelle, &referenz, &referenz_version, &fehler)) {
+    if (!schreiben) {
+      fprintf(stderr, "%s\n", fehler.c_str());
+      return 1;
+    }
+    referenz.clear();
+  }
+
+  const auto start = Uhr::now();
+  const auto korpus = Korpus();
+  std::vector<TafelHash> hashes(korpus.size());
+
+  constexpr size_t kTafelnProEinheit = 64;
+  std::atomic<size_t> naechste_tafel { 0 };
+  auto Arbeite = [&]() {
+    while (true) {
+      const size_t anfang = naechste_tafel.fetch_add(kTafelnProEinheit);
+      if (anfang >= korpus.size()) {
+        break;
+      }
+      for (size_t i = anfang, ende = std::min(anfang + kTafelnProEinheit, korpus.size()); i < ende; ++i) {
+        const auto& tafel = korpus[i];
+        HashAusgabe ausgabe(&hashes[i]);
+        HektoBuilder::Build(&ausgabe, tafel.bauparameter, Kilometrierung::fromMeter(tafel.wert_m), tafel.ueberlaenge_hm);
+        ausgabe.Abschliessen();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < anzahl_threads; ++i) {
+    threads.emplace_back(Arbeite);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t bytes = 0;
+  for (const auto& tafel : hashes) {
+    bytes += tafel.laenge;
+  }
+  printf("%zu Tafeln (%.1f MB) in %.1f s mit %zu Threads erzeugt\n", hashes.size(), bytes / 1e6,
+      std::chrono::duration<double>(Uhr::now() - start).count(), anzahl_threads);
+
+  size_t anzahl_abweichend = 0;
+  if (referenz.size() == hashes.size()) {
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      if (hashes[i].hash != referenz[i].hash || hashes[i].laenge != referenz[i].laenge) {
+        ++anzahl_abweichend;
+      }
+    }
+  }
+
+  if (schreiben) {
+    if (referenz.size() == hashes.size() && anzahl_abweichend != 0 && referenz_version == kAusgabeVersion) {
+      fprintf(stderr, "%zu Tafeln weichen von der Tabelle ab; zuerst kAusgabeVersion (hekto_builder.hpp) erhoehen\n",
+          anzahl_abweichend);
+      return 1;
+    }
+    if (!SchreibeTabelle(tabelle, hashes)) {
+      fprintf(stderr, "Kann %s nicht schreiben\n", tabelle);
+      return 1;
+    }
+    return 0;
+  }
+
+  if (referenz.size() != hashes.size()) {
+    fprintf(stderr, "Die Tabelle enthaelt %zu statt %zu Tafeln; Korpus geaendert? Tabelle mit --schreibe neu erzeugen.\n",
+        referenz.size(), hashes.size());
+    return 1;
+  }
+
+  if (anzahl_abweichend != 0) {
+    size_t i = 0;
+    while (hashes[i].hash == referenz[i].hash && hashes[i].laenge == referenz[i].laenge) {
+      ++i;
+    }
+    const auto [offset, genauigkeit] = ErsteAbweichung(referenz[i], hashes[i]);
+    const auto kilometrierung = Kilometrierung::fromMeter(korpus[i].wert_m);
+    fprintf(stderr, "Erste Abweichung bei Tafel %zu, km %s%d.%d: %s\n"
+        "  %u statt %u Bytes, erste Abweichung zwischen Byte %u und %u\n",
+        i, kilometrierung.istNegativ() ? "-" : "", std::abs(kilometrierung.km), std::abs(kilometrierung.hm),
+        korpus[i].Name().c_str(), hashes[i].laenge, referenz[i].laenge, offset, offset + genauigkeit);
+    fprintf(stderr, "%zu von %zu Tafeln weichen ab\n", anzahl_abweichend, hashes.size());
+    return 1;
+  }
+  if (referenz_version != kAusgabeVersion) {
+    fprintf(stderr, "Die Tabelle gehoert zu kAusgabeVersion %u statt %u; Tabelle mit --schreibe neu erzeugen.\n",
+        referenz_version, kAusgabeVersion);
+    return 1;
+  }
+  printf("Alle Tafeln stimmen mit der Referenz ueberein\n");
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright 2026 Zusitools
+
+#ifndef LRU_CACHE_HPP_
+#define LRU_CACHE_HPP_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Threadsicherer LRU-Cache fester Kapazitaet. Die Werte werden als
+ * shared_ptr<const Value> herausgegeben, sodass ein verdraengter Eintrag
+ * so lange gueltig bleibt, wie er noch verwendet wird.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache final {
+ public:
+  explicit LruCache(size_t kapazitaet) : kapazitaet_(kapazitaet) { }
+
+  LruCache(const LruCache&) = delete;
+  LruCache& operator=(const LruCache&) = delete;
+
+  std::shared_ptr<const Value> Get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    eintraege_.splice(eintraege_.begin(), eintraege_, it->second);
+    return it->second->second;
+  }
+
+  void Put(const Key& key, std::shared_ptr<const Value> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+      it->second->second = std::move(value);
+      eintraege_.splice(eintraege_.begin(), eintraege_, it->second);
+      return;
+    }
+
+    eintraege_.emplace_front(key, std::move(value));
+    index_.emplace(key, eintraege_.begin());
+
+    while (eintraege_.size() > kapazitaet_) {
+      index_.erase(eintraege_.back().first);
+      eintraege_.pop_back();
+    }
+  }
+
+  /**
+   * Liefert den Wert zu `key` oder erzeugt ihn mittels `erzeuge()`.
+   * `erzeuge` wird ausserhalb der Sperre aufgerufen; erzeugen zwei Threads
+   * gleichzeitig denselben Wert, gewinnt der zuletzt eingefuegte.
+   */
+  template <typename Fn>
+  std::shared_ptr<const Value> GetOrBuild(const Key& key, Fn&& erzeuge) {
+    if (auto result = Get(key)) {
+      return result;
+    }
+    auto result = std::make_shared<const Value>(erzeuge());
+    Put(key, result);
+    return result;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    eintraege_.clear();
+  }
+
+ private:
+  using Eintraege = std::list<std::pair<Key, std::shared_ptr<const Value>>>;
+
+  const size_t kapazitaet_;
+  std::mutex mutex_;
+  Eintraege eintraege_;
+  std::unordered_map<Key, typename Eintraege::iterator, Hash> index_;
+};
+
+#endif  // LRU_CACHE_HPP_
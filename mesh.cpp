@@ -2,7 +2,21 @@
 
 #include "mesh.hpp"
 
-Mesh MeshOps::translate(float dx, float dy, float dz, const Mesh& mesh)  {
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+void MeshOps::append(Mesh* ziel, const Mesh& mesh) {
+  const VertexIndex indexOffset = ziel->vertices.size();
+
+  std::copy(std::begin(mesh.vertices), std::end(mesh.vertices), std::back_inserter(ziel->vertices));
+  std::transform(std::begin(mesh.faces), std::end(mesh.faces), std::back_inserter(ziel->faces),
+      [indexOffset](const auto& face) -> Face {
+        return { indexOffset + face.i1, indexOffset + face.i2, indexOffset + face.i3 };
+      });
+}
+
+Mesh MeshOps::translate(Koordinate dx, Koordinate dy, Koordinate dz, const Mesh& mesh)  {
   Mesh result(mesh);
   for (auto& vertex : result.vertices) {
     vertex.pos_x += dx;
@@ -23,3 +37,125 @@ Mesh MeshOps::rotateZ180(const Mesh& mesh) {
   }
   return result;
 }
+
+Mesh MeshOps::rotateZ(double winkel, const Mesh& mesh) {
+  const double c = std::cos(winkel);
+  const double s = std::sin(winkel);
+  Mesh result(mesh);
+  for (auto& vertex : result.vertices) {
+    const double x = vertex.pos_x;
+    const double y = vertex.pos_y;
+    vertex.pos_x = static_cast<Koordinate>(std::lround(c * x - s * y));
+    vertex.pos_y = static_cast<Koordinate>(std::lround(s * x + c * y));
+    const float nor_x = vertex.nor_x;
+    const float nor_y = vertex.nor_y;
+    vertex.nor_x = static_cast<float>(c * nor_x - s * nor_y);
+    vertex.nor_y = static_cast<float>(s * nor_x + c * nor_y);
+  }
+  return result;
+}
+
+namespace {
+
+// Anzahl Vertices bzw. Faces, die ohne Verzweigung gemeinsam geprueft werden
+constexpr size_t kPruefBlock = 64;
+
+bool IstEndlich(const Vertex& v) {
+  return std::isfinite(v.nor_x) & std::isfinite(v.nor_y) & std::isfinite(v.nor_z)
+    & std::isfinite(v.u1) & std::isfinite(v.v1) & std::isfinite(v.u2) & std::isfinite(v.v2);
+}
+
+bool IstImBereich(const Vertex& v, const Texturbereich& b) {
+  return (v.u1 >= b.u_min) & (v.u1 <= b.u_max) & (v.v1 >= b.v_min) & (v.v1 <= b.v_max)
+    & (v.u2 >= b.u_min) & (v.u2 <= b.u_max) & (v.v2 >= b.v_min) & (v.v2 <= b.v_max);
+}
+
+bool IndizesGueltig(const Face& face, size_t anzahl_vertices) {
+  return (face.i1 < anzahl_vertices) & (face.i2 < anzahl_vertices) & (face.i3 < anzahl_vertices);
+}
+
+// Die Normale des Dreiecks (Kreuzprodukt, Zusi-Koordinaten) zeigt bei Umlaufsinn im Uhrzeigersinn
+// entgegen der Vertex-Normalen. Dreiecke ohne Flaeche sind ebenfalls gueltig.
+bool UmlaufsinnGueltig(const Face& face, const std::vector<Vertex>& vertices) {
+  const auto& p1 = vertices[face.i1];
+  const auto& p2 = vertices[face.i2];
+  const auto& p3 = vertices[face.i3];
+  const int64_t a[3] = { int64_t { p2.pos_x } - p1.pos_x, int64_t { p2.pos_y } - p1.pos_y, int64_t { p2.pos_z } - p1.pos_z };
+  const int64_t b[3] = { int64_t { p3.pos_x } - p1.pos_x, int64_t { p3.pos_y } - p1.pos_y, int64_t { p3.pos_z } - p1.pos_z };
+  const int64_t n[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+  const double richtung = static_cast<double>(n[0]) * p1.nor_x + static_cast<double>(n[1]) * p1.nor_y
+    + static_cast<double>(n[2]) * p1.nor_z;
+  return (richtung < 0) | ((n[0] == 0) & (n[1] == 0) & (n[2] == 0));
+}
+
+}  // namespace
+
+std::string Beschreibung(const MeshFehler& fehler) {
+  const auto index = std::to_string(fehler.index);
+  switch (fehler.art) {
+    case MeshFehlerArt::kNichtEndlich:
+      return "Vertex " + index + ": Normale oder Texturkoordinate nicht endlich";
+    case MeshFehlerArt::kTexturkoordinateAusserhalb:
+      return "Vertex " + index + ": Texturkoordinate ausserhalb des zulaessigen Bereichs";
+    case MeshFehlerArt::kIndexAusserhalb:
+      return "Face " + index + ": verweist auf einen nicht vorhandenen Vertex";
+    case MeshFehlerArt::kUmlaufsinn:
+      return "Face " + index + ": falscher Umlaufsinn";
+  }
+  return "Unbekannter Fehler";
+}
+
+std::vector<MeshFehler> ValidateMesh(const Mesh& mesh, const Texturbereich& texturbereich, size_t max_fehler) {
+  std::vector<MeshFehler> result;
+  auto Melde = [&result, max_fehler](MeshFehlerArt art, size_t index) {
+    if (result.size() < max_fehler) {
+      result.push_back({ art, index });
+    }
+  };
+
+  const auto& vertices = mesh.vertices;
+  for (size_t anfang = 0; anfang < vertices.size(); anfang += kPruefBlock) {
+    const size_t ende = std::min(anfang + kPruefBlock, vertices.size());
+    bool ok = true;
+    for (size_t i = anfang; i < ende; ++i) {
+      ok &= IstEndlich(vertices[i]) & IstImBereich(vertices[i], texturbereich);
+    }
+    if (ok) {
+      continue;
+    }
+    for (size_t i = anfang; i < ende; ++i) {
+      if (!IstEndlich(vertices[i])) {
+        Melde(MeshFehlerArt::kNichtEndlich, i);
+      } else if (!IstImBereich(vertices[i], texturbereich)) {
+        Melde(MeshFehlerArt::kTexturkoordinateAusserhalb, i);
+      }
+    }
+  }
+
+  const auto& faces = mesh.faces;
+  for (size_t anfang = 0; anfang < faces.size(); anfang += kPruefBlock) {
+    const size_t ende = std::min(anfang + kPruefBlock, faces.size());
+    bool ok = true;
+    for (size_t i = anfang; i < ende; ++i) {
+      ok &= IndizesGueltig(faces[i], vertices.size());
+    }
+    // Der Umlaufsinn wird erst geprueft, wenn alle Indizes des Blocks gueltig sind.
+    if (ok) {
+      for (size_t i = anfang; i < ende; ++i) {
+        ok &= UmlaufsinnGueltig(faces[i], vertices);
+      }
+    }
+    if (ok) {
+      continue;
+    }
+    for (size_t i = anfang; i < ende; ++i) {
+      if (!IndizesGueltig(faces[i], vertices.size())) {
+        Melde(MeshFehlerArt::kIndexAusserhalb, i);
+      } else if (IstEndlich(vertices[faces[i].i1]) && !UmlaufsinnGueltig(faces[i], vertices)) {
+        // Nicht endliche Normalen wurden bereits als Vertex-Fehler gemeldet
+        Melde(MeshFehlerArt::kUmlaufsinn, i);
+      }
+    }
+  }
+  return result;
+}
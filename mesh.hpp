@@ -3,10 +3,34 @@
 #ifndef MESH_HPP_
 #define MESH_HPP_
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <utility>
 
+/* Positionen werden als Festkommazahlen in Mikrometern gespeichert.
+ * Die Geometrie wird fast ausschliesslich in ganzen Millimetern berechnet
+ * und gelangt so ohne Rundungsfehler bis zur Ausgabe.
+ */
+using Koordinate = int32_t;
+
+constexpr Koordinate kKoordinateProMm = 1000;
+constexpr Koordinate kKoordinateProMeter = 1000 * kKoordinateProMm;
+
+constexpr Koordinate Millimeter(int mm) {
+  return mm * kKoordinateProMm;
+}
+
+inline Koordinate Millimeter(double mm) {
+  return static_cast<Koordinate>(std::lround(mm * kKoordinateProMm));
+}
+
+inline float InMeter(Koordinate koordinate) {
+  return koordinate / static_cast<float>(kKoordinateProMeter);
+}
+
 /* Koordinatensystem (Zusi)
  *     z
  *     ^
@@ -16,13 +40,13 @@
  * Die x-Achse zeigt in den Bildschirm hinein.
  */
 struct Vertex final {
-  float pos_x, pos_y, pos_z;
+  Koordinate pos_x, pos_y, pos_z;
   float nor_x, nor_y, nor_z;
   float u1, v1;
   float u2, v2;
 
   inline Vertex(
-      float pos_x, float pos_y, float pos_z,
+      Koordinate pos_x, Koordinate pos_y, Koordinate pos_z,
       float nor_x, float nor_y, float nor_z,
       float u1, float v1, float u2, float v2)
     : pos_x(pos_x), pos_y(pos_y), pos_z(pos_z),
@@ -60,8 +84,44 @@ struct Mesh final {
 };
 
 namespace MeshOps {
-  Mesh translate(float dx, float dy, float dz, const Mesh& mesh);
+  // Haengt `mesh` an `ziel` an. Die Vertex-Indizes der Faces werden entsprechend verschoben.
+  void append(Mesh* ziel, const Mesh& mesh);
+  Mesh translate(Koordinate dx, Koordinate dy, Koordinate dz, const Mesh& mesh);
   Mesh rotateZ180(const Mesh& mesh);
+  // Dreht um die Z-Achse (Bogenmass, gegen den Uhrzeigersinn von oben gesehen). Positionen werden auf ganze Mikrometer gerundet.
+  Mesh rotateZ(double winkel, const Mesh& mesh);
 }
 
+// Verletzte Invariante eines Mesh, siehe ValidateMesh().
+enum class MeshFehlerArt {
+  kNichtEndlich,  ///< Normale oder Texturkoordinate ist NaN oder unendlich
+  kTexturkoordinateAusserhalb,  ///< Texturkoordinate ausserhalb des Texturbereichs
+  kIndexAusserhalb,  ///< Face verweist auf einen nicht vorhandenen Vertex
+  kUmlaufsinn,  ///< Face ist nicht im Uhrzeigersinn zur Normalen seines ersten Vertex
+};
+
+struct MeshFehler final {
+  MeshFehlerArt art;
+  size_t index;  ///< Vertex bzw. Face (kIndexAusserhalb, kUmlaufsinn)
+};
+
+std::string Beschreibung(const MeshFehler& fehler);
+
+// Zulaessiger Bereich beider Texturkoordinaten. Standard: der Texturatlas mit einem halben Pixel
+// (bei 256x256 Pixeln) Zugabe an jedem Rand.
+struct Texturbereich final {
+  float u_min = -0.5f / 256;
+  float u_max = 1 + 0.5f / 256;
+  float v_min = -0.5f / 256;
+  float v_max = 1 + 0.5f / 256;
+};
+
+/**
+ * Prueft alle Vertices und Faces von `mesh` und gibt die ersten `max_fehler` Fehler zurueck,
+ * leer, falls das Mesh gueltig ist. Dreiecke ohne Flaeche (z.B. aus der Faecher-Triangulierung)
+ * haben keinen Umlaufsinn und gelten als gueltig.
+ * Die Pruefung laeuft blockweise ohne Verzweigungen; nur Bloecke mit Fehlern werden einzeln untersucht.
+ */
+std::vector<MeshFehler> ValidateMesh(const Mesh& mesh, const Texturbereich& texturbereich = {}, size_t max_fehler = 16);
+
 #endif  // MESH_HPP_
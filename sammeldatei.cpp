@@ -0,0 +1,233 @@
+// Copyright 2026 Zusitools
+
+#include "sammeldatei.hpp"
+
+#include "ausgabe.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+using Teil = std::pair<SubsetBuilder, SubsetBuilder>;  // beleuchtet, unbeleuchtet
+
+Mesh Platziere(const Mesh& mesh, const PlatzierteTafel& tafel) {
+  // Ohne Drehung bleiben die Vertices (bis auf die Verschiebung) exakt wie in einer Einzeldatei
+  if (tafel.richtung == 0) {
+    return MeshOps::translate(tafel.x, tafel.y, tafel.z, mesh);
+  }
+  return MeshOps::translate(tafel.x, tafel.y, tafel.z, MeshOps::rotateZ(tafel.richtung, mesh));
+}
+
+std::vector<Teil> BaueTeile(const Streckenabschnitt& abschnitt, const BauParameter& bauparameter) {
+  TraceBereich bereich("Sammeldatei", abschnitt.name.c_str());
+  assert(bauparameter.ankerpunkt == Ankerpunkt::kNo);  // BuildMeshes liefert keine Ankerpunkte
+
+  std::vector<Teil> result;
+  auto NeuerTeil = [&result, &bauparameter]() {
+    result.emplace_back(SubsetBuilder(0, 0, 0, AusgabeformatVon(bauparameter)), SubsetBuilder(0, 0, 0, AusgabeformatVon(bauparameter)));
+  };
+  NeuerTeil();
+
+  for (const auto& tafel : abschnitt.tafeln) {
+    const auto meshes = HektoBuilder::BuildMeshes(bauparameter, tafel.kilometrierung, tafel.ueberlaenge_hm);
+    assert(meshes.beleuchtet.vertices.size() <= kMaxVerticesProSubset);
+    assert(meshes.unbeleuchtet.vertices.size() <= kMaxVerticesProSubset);
+
+    if (result.back().first.AnzahlVertices() + meshes.beleuchtet.vertices.size() > kMaxVerticesProSubset
+        || result.back().second.AnzahlVertices() + meshes.unbeleuchtet.vertices.size() > kMaxVerticesProSubset) {
+      NeuerTeil();
+    }
+    result.back().first.AddMesh(Platziere(meshes.beleuchtet, tafel));
+    result.back().second.AddMesh(Platziere(meshes.unbeleuchtet, tafel));
+  }
+
+  if (bauparameter.index_reihenfolge == IndexReihenfolge::kVertexCache) {
+    for (auto& [beleuchtet, unbeleuchtet] : result) {
+      beleuchtet.OptimiereVertexCache();
+      unbeleuchtet.OptimiereVertexCache();
+    }
+  }
+  return result;
+}
+
+/**
+ * Verteilt die Abschnitte auf optionen.anzahl_erzeuger Threads. `erzeuge(abschnitt, ausgabe, Schreibe)`
+ * fuellt `ausgabe` und uebergibt den Inhalt mit Schreibe(pfad) an den DateiSchreiber.
+ */
+template <typename Erzeuge>
+BatchStatistik FuehreProAbschnittAus(const std::vector<Streckenabschnitt>& abschnitte, DateiSchreiber* schreiber,
+    const BatchOptionen& optionen, Erzeuge erzeuge) {
+  const auto start = Uhr::now();
+
+  const size_t anzahl_threads = std::max<size_t>(1,
+      optionen.anzahl_erzeuger != 0 ? optionen.anzahl_erzeuger : std::thread::hardware_concurrency());
+
+  std::atomic<size_t> naechster_abschnitt { 0 };
+  std::atomic<size_t> anzahl_dateien { 0 };
+  std::atomic<size_t> anzahl_fehler { 0 };
+  std::atomic<uint64_t> anzahl_bytes { 0 };
+
+  auto Erzeuger = [&](size_t nr) {
+    BenenneTraceThread(("Erzeuger " + std::to_string(nr + 1)).c_str());
+    PufferAusgabe ausgabe;
+    auto Schreibe = [&](const std::string& pfad) {
+      TraceBereich bereich("Schreiben", pfad.c_str());
+      if (schreiber->SchreibeDatei(pfad, ausgabe.Inhalt())) {
+        ++anzahl_dateien;
+        anzahl_bytes += ausgabe.Inhalt().size();
+      } else {
+        fprintf(stderr, "%s: Schreiben fehlgeschlagen\n", pfad.c_str());
+        ++anzahl_fehler;
+      }
+    };
+    while (true) {
+      const size_t idx = naechster_abschnitt++;
+      if (idx >= abschnitte.size()) {
+        break;
+      }
+      erzeuge(abschnitte[idx], &ausgabe, Schreibe);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < anzahl_threads; ++i) {
+    threads.emplace_back(Erzeuger, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (!schreiber->Abschliessen()) {
+    ++anzahl_fehler;
+  }
+
+  BatchStatistik result;
+  result.anzahl_dateien = anzahl_dateien;
+  result.anzahl_fehler = anzahl_fehler;
+  result.anzahl_bytes = anzahl_bytes;
+  ErfasseNachtraeglicheFehler(*schreiber, &result);
+  result.gesamtdauer = Uhr::now() - start;
+  return result;
+}
+
+}  // namespace
+
+bool KoordinateAusMeter(double wert_m, Koordinate* result) {
+  if (!std::isfinite(wert_m) || std::abs(wert_m) > kMaxAbstandUrsprung_m) {
+    return false;
+  }
+  *result = static_cast<Koordinate>(std::lround(wert_m * kKoordinateProMeter));
+  return true;
+}
+
+void AbschnittsSammler::FuegeHinzu(const std::string& abschnitt, int wert_m, Koordinate x, Koordinate y, Koordinate z, double richtung) {
+  const auto wert = Kilometrierung::fromMeter(wert_m);
+  const auto kilometrierung = ueberlaenge_basis_.value_or(wert);
+  const auto ueberlaenge_hm = ueberlaenge_basis_.has_value() ?
+    std::optional { wert.toHektometer() - ueberlaenge_basis_->toHektometer() } : std::nullopt;
+  if (ueberlaenge_hm.has_value() && ((ueberlaenge_hm < 0) || (ueberlaenge_hm > kMaxUeberlaenge))) {
+    return;
+  }
+
+  const auto [it, neu] = indizes_.try_emplace(abschnitt, abschnitte_->size());
+  if (neu) {
+    abschnitte_->push_back({ abschnitt, {} });
+  }
+  (*abschnitte_)[it->second].tafeln.push_back({ kilometrierung, ueberlaenge_hm, x, y, z, richtung });
+}
+
+bool LiesPlatzierungen(FILE* fd, std::optional<Kilometrierung> ueberlaenge_basis,
+    std::vector<Streckenabschnitt>* result, std::string* fehler) {
+  AbschnittsSammler sammler(ueberlaenge_basis, result);
+  char zeile[1024];
+  for (size_t zeilennummer = 1; fgets(zeile, sizeof(zeile), fd) != nullptr; ++zeilennummer) {
+    char name[256];
+    double x_m = 0;
+    double y_m = 0;
+    double z_m = 0;
+    double richtung = 0;
+    double wert_m = 0;
+    const int anzahl = sscanf(zeile, "%255s %lf %lf %lf %lf %lf", name, &x_m, &y_m, &z_m, &richtung, &wert_m);
+    if (anzahl <= 0 || name[0] == '#') {
+      continue;
+    }
+
+    auto Fehler = [&](const char* text) {
+      *fehler = "Zeile " + std::to_string(zeilennummer) + ": " + text;
+      return false;
+    };
+    if (anzahl != 6 || !std::isfinite(richtung) || !std::isfinite(wert_m)) {
+      return Fehler("erwartet <abschnitt> <x> <y> <z> <richtung> <kilometrierung>");
+    }
+
+    // Der Name wird Teil des Dateinamens und darf nicht aus dem Zielverzeichnis herausfuehren
+    if (strpbrk(name, "/\\") != nullptr || strstr(name, "..") != nullptr) {
+      return Fehler("Abschnittsname darf weder /, \\ noch .. enthalten");
+    }
+    if (std::abs(wert_m) > kMaxWert_m) {
+      return Fehler(("Kilometrierung ausserhalb von +/-" + std::to_string(kMaxKm) + ",9 km").c_str());
+    }
+
+    Koordinate x;
+    Koordinate y;
+    Koordinate z;
+    if (!KoordinateAusMeter(x_m, &x) || !KoordinateAusMeter(y_m, &y) || !KoordinateAusMeter(z_m, &z)) {
+      return Fehler("Koordinate zu weit vom Ursprung des Abschnitts entfernt");
+    }
+
+    sammler.FuegeHinzu(name, static_cast<int>(std::lround(wert_m)), x, y, z, richtung);
+  }
+  return true;
+}
+
+std::string SammeldateiName(const std::string& abschnitt, size_t teil) {
+  return abschnitt + (teil == 0 ? "" : "_" + std::to_string(teil + 1)) + ".ls3";
+}
+
+BatchStatistik FuehreSammelBatchAus(const std::vector<Streckenabschnitt>& abschnitte, const BauParameter& bauparameter,
+    const std::vector<std::pair<TexturDatei, std::string>>& texturen, DateiSchreiber* schreiber, const BatchOptionen& optionen) {
+  return FuehreProAbschnittAus(abschnitte, schreiber, optionen, [&](const Streckenabschnitt& abschnitt, PufferAusgabe* ausgabe, auto Schreibe) {
+    // Die Geometrie ist unabhaengig von der Textur und wird nur einmal gebaut.
+    const auto teile = BaueTeile(abschnitt, bauparameter);
+    for (const auto& [textur, verzeichnis] : texturen) {
+      for (size_t i = 0; i < teile.size(); ++i) {
+        ausgabe->Inhalt().clear();
+        HektoBuilder::WriteLandschaft(ausgabe, textur, teile[i].first, teile[i].second);
+        Schreibe(verzeichnis + SammeldateiName(abschnitt.name, i));
+      }
+    }
+  });
+}
+
+std::vector<VerknuepfteDatei> PlatzierteDateien(const Streckenabschnitt& abschnitt, const BauParameter& bauparameter,
+    const std::string& praefix) {
+  std::vector<VerknuepfteDatei> result;
+  result.reserve(abschnitt.tafeln.size());
+  for (const auto& tafel : abschnitt.tafeln) {
+    result.push_back({ praefix + Dateiname(bauparameter, tafel.kilometrierung, tafel.ueberlaenge_hm),
+        tafel.x, tafel.y, tafel.z, tafel.richtung });
+  }
+  return result;
+}
+
+BatchStatistik FuehrePlatzierungsBatchAus(const std::vector<Streckenabschnitt>& abschnitte, const BauParameter& bauparameter,
+    const std::vector<PlatzierungsZiel>& ziele, DateiSchreiber* schreiber, const BatchOptionen& optionen) {
+  return FuehreProAbschnittAus(abschnitte, schreiber, optionen, [&](const Streckenabschnitt& abschnitt, PufferAusgabe* ausgabe, auto Schreibe) {
+    TraceBereich bereich("Platzierungsdatei", abschnitt.name.c_str());
+    for (const auto& ziel : ziele) {
+      ausgabe->Inhalt().clear();
+      HektoBuilder::BuildPlatzierung(ausgabe, PlatzierteDateien(abschnitt, bauparameter, ziel.praefix));
+      Schreibe(ziel.verzeichnis + SammeldateiName(abschnitt.name, 0));
+    }
+  });
+}
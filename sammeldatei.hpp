@@ -0,0 +1,107 @@
+// Copyright 2026 Zusitools
+
+#ifndef SAMMELDATEI_HPP_
+#define SAMMELDATEI_HPP_
+
+#include "batch.hpp"
+#include "hekto_builder.hpp"
+#include "mesh.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Sammeldateien: alle Tafeln eines Streckenabschnitts in einer Landschaftsdatei mit nur
+ * einem beleuchteten und einem unbeleuchteten Subset, statt einer Datei (und damit
+ * eigener Draw Calls) pro Tafel.
+ */
+
+// Hoechstens so viele Vertices pro Subset, damit die Indizes in 16 Bit passen.
+constexpr size_t kMaxVerticesProSubset = 65535;
+
+// Koordinaten werden als Mikrometer in 32 Bit gespeichert, siehe Koordinate.
+constexpr double kMaxAbstandUrsprung_m = 2000;
+
+// Rechnet Meter in eine Koordinate um. Gibt false zurueck, falls der Wert ausserhalb von kMaxAbstandUrsprung_m liegt.
+bool KoordinateAusMeter(double wert_m, Koordinate* result);
+
+struct PlatzierteTafel final {
+  Kilometrierung kilometrierung;
+  std::optional<int> ueberlaenge_hm;
+  Koordinate x, y, z;  ///< relativ zum Ursprung der Sammeldatei
+  double richtung;  ///< Drehung um die Z-Achse im Bogenmass wie in Zusi
+};
+
+struct Streckenabschnitt final {
+  std::string name;
+  std::vector<PlatzierteTafel> tafeln;
+};
+
+/**
+ * Ordnet Tafeln ihren Abschnitten zu. Abschnitte erscheinen in der Reihenfolge ihres ersten Auftretens.
+ * Im Ueberlaengen-Modus werden Tafeln ausserhalb des darstellbaren Bereichs uebersprungen.
+ */
+class AbschnittsSammler final {
+ public:
+  AbschnittsSammler(std::optional<Kilometrierung> ueberlaenge_basis, std::vector<Streckenabschnitt>* abschnitte)
+    : ueberlaenge_basis_(ueberlaenge_basis), abschnitte_(abschnitte) { }
+
+  void FuegeHinzu(const std::string& abschnitt, int wert_m, Koordinate x, Koordinate y, Koordinate z, double richtung);
+
+ private:
+  const std::optional<Kilometrierung> ueberlaenge_basis_;
+  std::vector<Streckenabschnitt>* const abschnitte_;
+  std::unordered_map<std::string, size_t> indizes_;
+};
+
+/**
+ * Liest eine Platzierungsliste mit einer Tafel pro Zeile:
+ *   <abschnitt> <x> <y> <z> <richtung> <kilometrierung>
+ * Koordinaten in Metern relativ zum Ursprung des Abschnitts, Richtung im Bogenmass,
+ * Kilometrierung in Metern (hoechstens +/-kMaxWert_m). Leerzeilen und Zeilen, die mit # beginnen,
+ * werden ignoriert. Abschnittsnamen mit /, \ oder .. sind Fehler, da sie Teil des Dateinamens werden.
+ * Die Tafeln werden wie mit AbschnittsSammler zugeordnet.
+ */
+bool LiesPlatzierungen(FILE* fd, std::optional<Kilometrierung> ueberlaenge_basis,
+    std::vector<Streckenabschnitt>* result, std::string* fehler);
+
+// <abschnitt>.ls3, <abschnitt>_2.ls3, ... fuer teil = 0, 1, ...
+std::string SammeldateiName(const std::string& abschnitt, size_t teil);
+
+/**
+ * Baut und schreibt die Sammeldateien aller Abschnitte parallel (optionen.anzahl_erzeuger Threads)
+ * fuer jede Textur; der zweite Eintrag eines Paares ist das Unterverzeichnis (leer oder mit '/').
+ * Wuerde ein Subset mehr als kMaxVerticesProSubset Vertices enthalten, wird eine weitere Datei
+ * begonnen. Sammeldateien enthalten keine Ankerpunkte, `bauparameter.ankerpunkt` muss kNo sein.
+ * In der Statistik sind nur Dateien, Fehler, Bytes und Gesamtdauer gesetzt.
+ */
+BatchStatistik FuehreSammelBatchAus(const std::vector<Streckenabschnitt>& abschnitte, const BauParameter& bauparameter,
+    const std::vector<std::pair<TexturDatei, std::string>>& texturen, DateiSchreiber* schreiber, const BatchOptionen& optionen);
+
+// Ziel der Platzierungsdateien einer Textur.
+struct PlatzierungsZiel final {
+  std::string verzeichnis;  ///< Unterverzeichnis der Platzierungsdatei (leer oder mit '/')
+  std::string praefix;  ///< wird den Dateinamen der Tafeln vorangestellt (leer oder Zusi-Pfad mit '\\')
+};
+
+/**
+ * Eintraege der Platzierungsdatei eines Abschnitts: eine Verknuepfung pro Tafel auf die
+ * Einzeldatei mit dem Namen aus Dateiname(), an der Position und mit der Drehung der Tafel.
+ */
+std::vector<VerknuepfteDatei> PlatzierteDateien(const Streckenabschnitt& abschnitt, const BauParameter& bauparameter,
+    const std::string& praefix);
+
+/**
+ * Schreibt die Platzierungsdateien <abschnitt>.ls3 aller Abschnitte parallel fuer jedes Ziel.
+ * Die Einzeldateien der Tafeln muessen separat erzeugt werden, z.B. mit FuehreBatchAus.
+ * In der Statistik sind nur Dateien, Fehler, Bytes und Gesamtdauer gesetzt.
+ */
+BatchStatistik FuehrePlatzierungsBatchAus(const std::vector<Streckenabschnitt>& abschnitte, const BauParameter& bauparameter,
+    const std::vector<PlatzierungsZiel>& ziele, DateiSchreiber* schreiber, const BatchOptionen& optionen);
+
+#endif  // SAMMELDATEI_HPP_
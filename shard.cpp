@@ -0,0 +1,312 @@
+// Copyright 2026 Zusitools
+
+#include "shard.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <unordered_set>
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+constexpr const char* kManifestKennung = "# hekto_batch manifest 1";
+
+const char* ModusName(ShardModus modus) {
+  return modus == ShardModus::kHash ? "hash" : "bereich";
+}
+
+std::string ShardName(const Shard& shard) {
+  return std::to_string(shard.nummer) + "/" + std::to_string(shard.anzahl);
+}
+
+// Pfade aus Manifesten muessen relativ sein und duerfen nicht aus dem Verzeichnis herausfuehren
+// (kein .. als Bestandteil); / und \ gelten beide als Trenner, ein : als Laufwerksangabe.
+bool IstRelativerPfad(const std::string& pfad) {
+  if (pfad.empty() || pfad[0] == '/' || pfad[0] == '\\' || pfad.find(':') != std::string::npos) {
+    return false;
+  }
+  size_t anfang = 0;
+  while (anfang <= pfad.size()) {
+    const size_t ende = std::min(pfad.find_first_of("/\\", anfang), pfad.size());
+    if (pfad.compare(anfang, ende - anfang, "..") == 0) {
+      return false;
+    }
+    anfang = ende + 1;
+  }
+  return true;
+}
+
+bool LiesDatei(std::ifstream* datei, uint64_t offset, uint64_t groesse, std::string* result) {
+  result->resize(groesse);
+  datei->clear();
+  datei->seekg(static_cast<std::streamoff>(offset));
+  datei->read(result->data(), static_cast<std::streamsize>(groesse));
+  return static_cast<uint64_t>(datei->gcount()) == groesse;
+}
+
+}  // namespace
+
+bool LiesShard(const char* text, Shard* result) {
+  size_t nummer = 0;
+  size_t anzahl = 0;
+  int gelesen = 0;
+  if (sscanf(text, "%zu/%zu%n", &nummer, &anzahl, &gelesen) != 2 || text[gelesen] != '\0'
+      || nummer < 1 || nummer > anzahl) {
+    return false;
+  }
+  result->nummer = nummer;
+  result->anzahl = anzahl;
+  return true;
+}
+
+bool GehoertZuShard(const Shard& shard, size_t index, size_t anzahl_einheiten, std::string_view schluessel) {
+  if (shard.anzahl <= 1) {
+    return true;
+  }
+  if (shard.modus == ShardModus::kHash) {
+    return InhaltsHash(schluessel).first % shard.anzahl + 1 == shard.nummer;
+  }
+  return static_cast<uint64_t>(index) * shard.anzahl / anzahl_einheiten + 1 == shard.nummer;
+}
+
+bool SchreibeManifest(FILE* fd, const Manifest& manifest) {
+  fprintf(fd, "%s\nshard %s %s\n", kManifestKennung, ShardName(manifest.shard).c_str(), ModusName(manifest.shard.modus));
+  if (!manifest.buendel.empty()) {
+    fprintf(fd, "buendel %s\n", manifest.buendel.c_str());
+  } else if (!manifest.verzeichnis.empty()) {
+    fprintf(fd, "verzeichnis %s\n", manifest.verzeichnis.c_str());
+  }
+  for (const auto& eintrag : manifest.eintraege) {
+    fprintf(fd, "%016" PRIx64 "%016" PRIx64 " %" PRIu64 " %" PRIu64 " %s\n",
+        eintrag.hash.first, eintrag.hash.second, eintrag.groesse, eintrag.buendel_offset, eintrag.pfad.c_str());
+  }
+  return !ferror(fd);
+}
+
+bool LiesManifest(FILE* fd, Manifest* result, std::string* fehler) {
+  char zeile[4096];
+  bool kennung = false;
+  for (size_t zeilennummer = 1; fgets(zeile, sizeof(zeile), fd) != nullptr; ++zeilennummer) {
+    zeile[strcspn(zeile, "\r\n")] = '\0';
+    auto Fehler = [&](const char* text) {
+      *fehler = "Zeile " + std::to_string(zeilennummer) + ": " + text;
+      return false;
+    };
+
+    if (zeilennummer == 1) {
+      kennung = !strcmp(zeile, kManifestKennung);
+      if (!kennung) {
+        return Fehler("kein hekto_batch-Manifest");
+      }
+      continue;
+    }
+    if (zeile[0] == '\0' || zeile[0] == '#') {
+      continue;
+    }
+
+    if (!strncmp(zeile, "shard ", 6)) {
+      char shard[64];
+      char modus[16];
+      if (sscanf(zeile + 6, "%63s %15s", shard, modus) != 2 || !LiesShard(shard, &result->shard)
+          || (strcmp(modus, "bereich") && strcmp(modus, "hash"))) {
+        return Fehler("ungueltige Shard-Angabe");
+      }
+      result->shard.modus = strcmp(modus, "hash") ? ShardModus::kBereich : ShardModus::kHash;
+    } else if (!strncmp(zeile, "verzeichnis ", 12)) {
+      result->verzeichnis = zeile + 12;
+    } else if (!strncmp(zeile, "buendel ", 8)) {
+      result->buendel = zeile + 8;
+      if (!IstRelativerPfad(result->buendel)) {
+        return Fehler("Buendel muss relativ zum Manifest liegen");
+      }
+    } else {
+      ManifestEintrag eintrag;
+      int pfad_anfang = 0;
+      if (sscanf(zeile, "%16" SCNx64 "%16" SCNx64 " %" SCNu64 " %" SCNu64 " %n",
+            &eintrag.hash.first, &eintrag.hash.second, &eintrag.groesse, &eintrag.buendel_offset, &pfad_anfang) != 4
+          || zeile[pfad_anfang] == '\0') {
+        return Fehler("erwartet <hash> <groesse> <offset> <pfad>");
+      }
+      eintrag.pfad = zeile + pfad_anfang;
+      if (!IstRelativerPfad(eintrag.pfad)) {
+        return Fehler("Pfad muss relativ sein und darf kein .. enthalten");
+      }
+      result->eintraege.push_back(std::move(eintrag));
+    }
+  }
+  if (!kennung) {
+    *fehler = "leere Datei";
+    return false;
+  }
+  return true;
+}
+
+bool ManifestDateiSchreiber::SchreibeDatei(const std::string& pfad, const std::string& inhalt) {
+  ManifestEintrag eintrag { pfad, inhalt.size(), InhaltsHash(inhalt), 0 };
+  if (buendel_ == nullptr) {
+    if (!basis_->SchreibeDatei(pfad, inhalt)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    eintraege_.push_back(std::move(eintrag));
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fwrite(inhalt.data(), 1, inhalt.size(), buendel_) != inhalt.size()) {
+    buendel_fehler_ = true;
+    return false;
+  }
+  eintrag.buendel_offset = buendel_groesse_;
+  buendel_groesse_ += inhalt.size();
+  eintraege_.push_back(std::move(eintrag));
+  return true;
+}
+
+bool ManifestDateiSchreiber::Abschliessen() {
+  if (buendel_ == nullptr) {
+    const bool ok = basis_->Abschliessen();
+    // Nachtraeglich fehlgeschlagene Dateien gehoeren nicht ins Manifest
+    std::unordered_set<std::string> fehlgeschlagen;
+    for (auto& fehler : basis_->NachtraeglicheFehler()) {
+      fehlgeschlagen.insert(std::move(fehler.pfad));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    eintraege_.erase(std::remove_if(eintraege_.begin(), eintraege_.end(),
+        [&fehlgeschlagen](const ManifestEintrag& eintrag) { return fehlgeschlagen.count(eintrag.pfad) != 0; }), eintraege_.end());
+    return ok;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fflush(buendel_) == 0 && !buendel_fehler_;
+}
+
+std::vector<ManifestEintrag> ManifestDateiSchreiber::Eintraege() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto result = eintraege_;
+  // Wird eine Datei mehrfach geschrieben, gilt der letzte Inhalt.
+  std::stable_sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.pfad < b.pfad; });
+  const auto ende = std::unique(result.rbegin(), result.rend(), [](const auto& a, const auto& b) { return a.pfad == b.pfad; });
+  result.erase(result.begin(), ende.base());
+  return result;
+}
+
+bool FuehreManifesteZusammen(const std::vector<std::string>& manifest_dateien, const std::string& zielverzeichnis,
+    DateiSchreiber* schreiber, Manifest* result, BatchStatistik* statistik, std::string* fehler) {
+  const auto start = Uhr::now();
+
+  struct Quelle final {
+    ManifestEintrag eintrag;
+    size_t manifest;
+  };
+
+  std::vector<Manifest> manifeste(manifest_dateien.size());
+  std::vector<std::unique_ptr<std::ifstream>> buendel(manifest_dateien.size());
+  std::map<std::string, Quelle> quellen;
+  std::vector<bool> shard_vorhanden;
+
+  for (size_t i = 0; i < manifest_dateien.size(); ++i) {
+    const auto& datei = manifest_dateien[i];
+    FILE* fd = fopen(datei.c_str(), "r");
+    if (fd == nullptr) {
+      *fehler = datei + ": kann nicht gelesen werden";
+      return false;
+    }
+    std::string manifest_fehler;
+    const bool ok = LiesManifest(fd, &manifeste[i], &manifest_fehler);
+    fclose(fd);
+    if (!ok) {
+      *fehler = datei + ": " + manifest_fehler;
+      return false;
+    }
+
+    auto& manifest = manifeste[i];
+    if (i == 0) {
+      result->shard = { 1, 1, manifest.shard.modus };
+      shard_vorhanden.resize(manifest.shard.anzahl);
+    } else if (manifest.shard.anzahl != shard_vorhanden.size() || manifest.shard.modus != manifeste[0].shard.modus) {
+      *fehler = datei + ": Shard " + ShardName(manifest.shard) + " gehoert nicht zum selben Lauf wie " + manifest_dateien[0];
+      return false;
+    }
+    if (shard_vorhanden[manifest.shard.nummer - 1]) {
+      *fehler = datei + ": Shard " + ShardName(manifest.shard) + " ist doppelt angegeben";
+      return false;
+    }
+    shard_vorhanden[manifest.shard.nummer - 1] = true;
+
+    if (!manifest.buendel.empty()) {
+      const auto pfad = std::filesystem::path(datei).parent_path() / manifest.buendel;
+      buendel[i] = std::make_unique<std::ifstream>(pfad, std::ios::binary);
+      if (!*buendel[i]) {
+        *fehler = pfad.string() + ": kann nicht gelesen werden";
+        return false;
+      }
+    }
+
+    for (auto& eintrag : manifest.eintraege) {
+      const auto [it, neu] = quellen.try_emplace(eintrag.pfad, Quelle { eintrag, i });
+      if (!neu && it->second.eintrag.hash != eintrag.hash) {
+        *fehler = eintrag.pfad + ": unterschiedlicher Inhalt in Shard " + ShardName(manifeste[it->second.manifest].shard)
+          + " und " + ShardName(manifest.shard);
+        return false;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < shard_vorhanden.size(); ++i) {
+    if (!shard_vorhanden[i]) {
+      *fehler = "Shard " + std::to_string(i + 1) + "/" + std::to_string(shard_vorhanden.size()) + " fehlt";
+      return false;
+    }
+  }
+
+  result->verzeichnis = std::filesystem::absolute(zielverzeichnis).string();
+  result->buendel.clear();
+  result->eintraege.clear();
+
+  std::string inhalt;
+  for (const auto& [pfad, quelle] : quellen) {
+    const auto& manifest = manifeste[quelle.manifest];
+    const auto ziel = std::filesystem::path(zielverzeichnis) / pfad;
+    bool schreiben = true;
+    bool ok;
+    if (buendel[quelle.manifest] != nullptr) {
+      ok = LiesDatei(buendel[quelle.manifest].get(), quelle.eintrag.buendel_offset, quelle.eintrag.groesse, &inhalt);
+    } else {
+      const auto herkunft = std::filesystem::path(manifest.verzeichnis) / pfad;
+      std::error_code ec;
+      schreiben = !std::filesystem::equivalent(herkunft, ziel, ec);
+      std::ifstream datei(herkunft, std::ios::binary);
+      ok = datei && LiesDatei(&datei, 0, quelle.eintrag.groesse, &inhalt) && datei.peek() == std::ifstream::traits_type::eof();
+    }
+    if (!ok || InhaltsHash(inhalt) != quelle.eintrag.hash) {
+      *fehler = pfad + ": Inhalt fehlt oder passt nicht zum Manifest von Shard " + ShardName(manifest.shard);
+      return false;
+    }
+
+    if (schreiben) {
+      if (!schreiber->SchreibeDatei(pfad, inhalt)) {
+        fprintf(stderr, "%s: Schreiben fehlgeschlagen\n", pfad.c_str());
+        ++statistik->anzahl_fehler;
+        continue;
+      }
+      ++statistik->anzahl_dateien;
+      statistik->anzahl_bytes += inhalt.size();
+    }
+    result->eintraege.push_back({ pfad, quelle.eintrag.groesse, quelle.eintrag.hash, 0 });
+  }
+
+  if (!schreiber->Abschliessen()) {
+    ++statistik->anzahl_fehler;
+  }
+  ErfasseNachtraeglicheFehler(*schreiber, statistik);
+  statistik->gesamtdauer = Uhr::now() - start;
+  return true;
+}
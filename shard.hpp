@@ -0,0 +1,106 @@
+// Copyright 2026 Zusitools
+
+#ifndef SHARD_HPP_
+#define SHARD_HPP_
+
+#include "batch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Verteilung eines Batch-Laufs auf mehrere Prozesse oder Rechner: jeder Shard erzeugt nur einen
+ * Teil der Dateien und beschreibt ihn in einem Manifest. Die Manifeste (und ggf. Buendeldateien)
+ * aller Shards werden anschliessend deterministisch zu einem Ausgabeverzeichnis zusammengefuehrt.
+ */
+
+enum class ShardModus {
+  kBereich,  ///< zusammenhaengende Bereiche in Erzeugungsreihenfolge (Kilometrierung bzw. Abschnitte)
+  kHash,  ///< nach Hash des Dateinamens bzw. Abschnittsnamens
+};
+
+struct Shard final {
+  size_t nummer = 1;  ///< 1 bis anzahl
+  size_t anzahl = 1;
+  ShardModus modus = ShardModus::kBereich;
+};
+
+// Liest "<i>/<n>" mit 1 <= i <= n.
+bool LiesShard(const char* text, Shard* result);
+
+// Ob die Einheit `index` (von `anzahl_einheiten`) mit dem Namen `schluessel` zu `shard` gehoert.
+// Jede Einheit gehoert zu genau einem Shard.
+bool GehoertZuShard(const Shard& shard, size_t index, size_t anzahl_einheiten, std::string_view schluessel);
+
+struct ManifestEintrag final {
+  std::string pfad;  ///< relativ zum Zielverzeichnis
+  uint64_t groesse;
+  std::pair<uint64_t, uint64_t> hash;  ///< siehe InhaltsHash
+  uint64_t buendel_offset;  ///< nur mit Buendeldatei
+};
+
+/**
+ * Manifest eines Shards bzw. des zusammengefuehrten Ergebnisses. Textformat, eine Datei pro Zeile:
+ *   # hekto_batch manifest 1
+ *   shard <i>/<n> bereich|hash
+ *   verzeichnis <absoluter pfad>      (Dateien einzeln geschrieben)
+ *   buendel <pfad>                    (oder: Dateien in einer Buendeldatei, Pfad relativ zum Manifest)
+ *   <hash, 32 Hex-Ziffern> <groesse> <offset> <pfad>
+ * Die Eintraege sind nach Pfad sortiert, sodass gleiche Ausgaben gleiche Manifeste ergeben.
+ */
+struct Manifest final {
+  Shard shard;
+  std::string verzeichnis;
+  std::string buendel;
+  std::vector<ManifestEintrag> eintraege;
+};
+
+bool SchreibeManifest(FILE* fd, const Manifest& manifest);
+// Pfade der Eintraege und des Buendels muessen relativ sein und duerfen kein .. enthalten.
+bool LiesManifest(FILE* fd, Manifest* result, std::string* fehler);
+
+/**
+ * Merkt sich Pfad, Groesse und Hash jeder geschriebenen Datei. Die Dateien werden entweder an
+ * `basis` weitergereicht oder nacheinander an eine Buendeldatei angehaengt, was bei vielen
+ * kleinen Dateien das Uebertragen zwischen Rechnern vereinfacht.
+ */
+class ManifestDateiSchreiber final : public DateiSchreiber {
+ public:
+  explicit ManifestDateiSchreiber(DateiSchreiber* basis) : basis_(basis), buendel_(nullptr) { }
+  explicit ManifestDateiSchreiber(FILE* buendel) : basis_(nullptr), buendel_(buendel) { }
+
+  bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) override;
+  bool Abschliessen() override;
+  std::vector<SchreibFehler> NachtraeglicheFehler() const override {
+    return basis_ != nullptr ? basis_->NachtraeglicheFehler() : std::vector<SchreibFehler> {};
+  }
+
+  // Nach Pfad sortiert.
+  std::vector<ManifestEintrag> Eintraege() const;
+
+ private:
+  DateiSchreiber* const basis_;
+  FILE* const buendel_;
+
+  mutable std::mutex mutex_;
+  std::vector<ManifestEintrag> eintraege_;
+  uint64_t buendel_groesse_ = 0;
+  bool buendel_fehler_ = false;
+};
+
+/**
+ * Fuehrt die Manifeste aller Shards eines Laufs zusammen: prueft, dass alle Shards vorhanden sind
+ * und keine zwei Shards unterschiedliche Inhalte unter demselben Pfad liefern, und schreibt Dateien
+ * aus Buendeln bzw. fremden Verzeichnissen ueber `schreiber` nach `zielverzeichnis`. Bereits dort
+ * liegende Dateien werden nur gegen das Manifest geprueft. `result` enthaelt danach das Gesamtmanifest.
+ */
+bool FuehreManifesteZusammen(const std::vector<std::string>& manifest_dateien, const std::string& zielverzeichnis,
+    DateiSchreiber* schreiber, Manifest* result, BatchStatistik* statistik, std::string* fehler);
+
+#endif  // SHARD_HPP_
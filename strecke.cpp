@@ -0,0 +1,218 @@
+// Copyright 2026 Zusitools
+
+#include "strecke.hpp"
+
+#include "xml_leser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace {
+
+struct Punkt3D final {
+  double x = 0;
+  double y = 0;
+  double z = 0;
+};
+
+struct StreckenElement final {
+  uint32_t nr = 0;
+  Punkt3D b;  ///< Anfang in Normrichtung
+  Punkt3D g;  ///< Ende in Normrichtung
+  std::optional<double> km_norm;  ///< Kilometrierung am Anfang in Normrichtung (b)
+  bool pos_norm = false;  ///< Kilometrierung steigt in Normrichtung
+  std::optional<double> km_gegen;  ///< Kilometrierung am Anfang in Gegenrichtung (g)
+  bool pos_gegen = false;  ///< Kilometrierung steigt in Gegenrichtung
+};
+
+template <typename T>
+bool LiesZahl(const XmlLeser& leser, std::string_view attribut, T* result) {
+  const auto wert = leser.Attribut(attribut);
+  if (!wert.has_value()) {
+    return true;  // Zusi laesst Attribute mit Standardwert weg
+  }
+  const auto [ende, fehler] = std::from_chars(wert->data(), wert->data() + wert->size(), *result);
+  return fehler == std::errc() && ende == wert->data() + wert->size();
+}
+
+bool LiesPunkt(const XmlLeser& leser, Punkt3D* result) {
+  return LiesZahl(leser, "X", &result->x) && LiesZahl(leser, "Y", &result->y) && LiesZahl(leser, "Z", &result->z);
+}
+
+bool LiesKilometrierung(const XmlLeser& leser, std::optional<double>* km, bool* pos) {
+  double wert = 0;
+  int positiv = 0;
+  if (!LiesZahl(leser, "km", &wert) || !LiesZahl(leser, "pos", &positiv)) {
+    return false;
+  }
+  *km = wert;
+  *pos = positiv != 0;
+  return true;
+}
+
+void BestimmeStandorte(const StreckenElement& element, const StreckenOptionen& optionen,
+    const std::function<void(const TafelStandort&)>& ziel, StreckenStatistik* statistik) {
+  const double dx = element.g.x - element.b.x;
+  const double dy = element.g.y - element.b.y;
+  const double dz = element.g.z - element.b.z;
+  const double laenge_m = std::sqrt(dx * dx + dy * dy + dz * dz);
+  if (laenge_m == 0) {
+    return;
+  }
+
+  // Kilometrierung in Metern an b und g. Sind beide Richtungen angegeben, wird nichts aus der
+  // Elementlaenge abgeleitet, sodass benachbarte Elemente am gemeinsamen Knoten genau denselben Wert haben.
+  double km_b_m;
+  double km_g_m;
+  if (element.km_norm.has_value() && element.km_gegen.has_value()) {
+    km_b_m = 1000 * *element.km_norm;
+    km_g_m = 1000 * *element.km_gegen;
+  } else if (element.km_norm.has_value()) {
+    km_b_m = 1000 * *element.km_norm;
+    km_g_m = km_b_m + (element.pos_norm ? laenge_m : -laenge_m);
+  } else if (element.km_gegen.has_value()) {
+    km_g_m = 1000 * *element.km_gegen;
+    km_b_m = km_g_m + (element.pos_gegen ? laenge_m : -laenge_m);
+  } else {
+    ++statistik->anzahl_ohne_kilometrierung;
+    return;
+  }
+
+  const double richtung = std::atan2(dy, dx);
+  const double seite_x = std::sin(richtung) * optionen.seitenabstand_m;
+  const double seite_y = -std::cos(richtung) * optionen.seitenabstand_m;
+
+  // Halboffenes Intervall, damit ein Standort auf der Grenze zweier Elemente nur einmal vorkommt
+  if (km_b_m == km_g_m) {
+    return;
+  }
+  // Standorte ausserhalb des darstellbaren Bereichs werden uebersprungen
+  if (!std::isfinite(km_b_m) || !std::isfinite(km_g_m)) {
+    ++statistik->anzahl_ausserhalb;
+    return;
+  }
+  const double min_m = std::min(km_b_m, km_g_m);
+  const double max_m = std::max(km_b_m, km_g_m);
+  if (min_m < -kMaxWert_m || max_m > kMaxWert_m) {
+    ++statistik->anzahl_ausserhalb;
+  }
+  const double von_m = std::max(min_m, -kMaxWert_m - 1.0);
+  const double bis_m = std::min(max_m, kMaxWert_m + 1.0);
+  if (von_m >= bis_m) {
+    return;
+  }
+  for (auto i = static_cast<int64_t>(std::ceil(von_m / optionen.abstand_m)); i * optionen.abstand_m < bis_m; ++i) {
+    const double wert_m = i * optionen.abstand_m;
+    if (std::abs(std::lround(wert_m)) > kMaxWert_m) {
+      continue;
+    }
+    const double t = (wert_m - km_b_m) / (km_g_m - km_b_m);
+    ziel({
+      element.b.x + t * dx + seite_x,
+      element.b.y + t * dy + seite_y,
+      element.b.z + t * dz,
+      richtung,
+      static_cast<int>(std::lround(wert_m)),
+      element.nr,
+    });
+    ++statistik->anzahl_standorte;
+  }
+}
+
+}  // namespace
+
+bool LiesStrecke(FILE* fd, const StreckenOptionen& optionen, const std::function<void(const TafelStandort&)>& ziel,
+    StreckenStatistik* statistik, std::string* fehler) {
+  if (!(optionen.abstand_m > 0)) {
+    *fehler = "Abstand muss positiv sein";
+    return false;
+  }
+
+  XmlLeser leser(fd);
+  StreckenElement element;
+  size_t element_tiefe = 0;  ///< 0 = ausserhalb eines Streckenelements
+
+  auto Fehler = [&](const std::string& text) {
+    *fehler = "Streckenelement " + std::to_string(element.nr) + ": " + text;
+    return false;
+  };
+
+  while (true) {
+    const auto ereignis = leser.Naechstes();
+    if (ereignis == XmlLeser::Ereignis::kDateiende) {
+      break;
+    } else if (ereignis == XmlLeser::Ereignis::kFehler) {
+      *fehler = leser.Fehler();
+      return false;
+    }
+
+    const auto name = leser.Name();
+    if (ereignis == XmlLeser::Ereignis::kStart) {
+      if (element_tiefe == 0) {
+        if (name == "StrElement") {
+          element = StreckenElement();
+          element_tiefe = leser.Tiefe();
+          if (!LiesZahl(leser, "Nr", &element.nr)) {
+            return Fehler("ungueltige Nummer");
+          }
+        }
+      } else if (leser.Tiefe() == element_tiefe + 1) {
+        bool ok = true;
+        if (name == "b") {
+          ok = LiesPunkt(leser, &element.b);
+        } else if (name == "g") {
+          ok = LiesPunkt(leser, &element.g);
+        } else if (name == "InfoNormRichtung") {
+          ok = LiesKilometrierung(leser, &element.km_norm, &element.pos_norm);
+        } else if (name == "InfoGegenRichtung") {
+          ok = LiesKilometrierung(leser, &element.km_gegen, &element.pos_gegen);
+        }
+        if (!ok) {
+          return Fehler("ungueltiger Zahlenwert in <" + std::string(name) + ">");
+        }
+      }
+    } else if (element_tiefe != 0 && leser.Tiefe() + 1 == element_tiefe) {
+      ++statistik->anzahl_elemente;
+      BestimmeStandorte(element, optionen, ziel, statistik);
+      element_tiefe = 0;
+    }
+  }
+
+  statistik->gelesene_bytes = leser.GeleseneBytes();
+  return true;
+}
+
+bool LiesStreckenabschnitte(FILE* fd, const StreckenOptionen& optionen, std::optional<Kilometrierung> ueberlaenge_basis,
+    std::vector<Streckenabschnitt>* result, StreckenStatistik* statistik, std::string* fehler) {
+  AbschnittsSammler sammler(ueberlaenge_basis, result);
+  std::string standort_fehler;
+  const bool ok = LiesStrecke(fd, optionen, [&](const TafelStandort& standort) {
+    if (!standort_fehler.empty()) {
+      return;
+    }
+
+    const double kachel_x = std::floor(standort.x_m / kKachelGroesse_m + 0.5);
+    const double kachel_y = std::floor(standort.y_m / kKachelGroesse_m + 0.5);
+    Koordinate x;
+    Koordinate y;
+    Koordinate z;
+    if (!KoordinateAusMeter(standort.x_m - kachel_x * kKachelGroesse_m, &x)
+        || !KoordinateAusMeter(standort.y_m - kachel_y * kKachelGroesse_m, &y)
+        || !KoordinateAusMeter(standort.z_m, &z)) {
+      standort_fehler = "Streckenelement " + std::to_string(standort.element_nr) + ": Hoehe ausserhalb des darstellbaren Bereichs";
+      return;
+    }
+
+    const auto name = "Kachel_" + std::to_string(static_cast<int64_t>(kachel_x * kKachelGroesse_m))
+      + "_" + std::to_string(static_cast<int64_t>(kachel_y * kKachelGroesse_m));
+    sammler.FuegeHinzu(name, standort.kilometrierung_m, x, y, z, standort.richtung);
+  }, statistik, fehler);
+
+  if (ok && !standort_fehler.empty()) {
+    *fehler = standort_fehler;
+    return false;
+  }
+  return ok;
+}
@@ -0,0 +1,75 @@
+// Copyright 2026 Zusitools
+
+#ifndef STRECKE_HPP_
+#define STRECKE_HPP_
+
+#include "hekto_builder.hpp"
+#include "sammeldatei.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Bestimmt die Tafelstandorte direkt aus einer Zusi-3-Streckendatei (.st3), statt jede Tafel
+ * im Editor einzeln zu setzen. Die Datei wird stueckweise gelesen (siehe XmlLeser), der
+ * Speicherbedarf haengt also nicht von ihrer Groesse ab.
+ */
+
+// Abstand zweier Tafeln entlang der Kilometrierung, siehe AbstandTafeln() der DLL.
+constexpr double kAbstandTafeln_m = 200;
+
+// Seitlicher Abstand der Tafel von der Gleismitte auf eigenem Standort, siehe AbstandGleis() der DLL.
+constexpr double kAbstandGleis_m = 3;
+
+// Kantenlaenge der Kacheln, zu denen die Tafeln zusammengefasst werden (siehe kMaxAbstandUrsprung_m).
+constexpr double kKachelGroesse_m = kMaxAbstandUrsprung_m;
+
+struct StreckenOptionen final {
+  double abstand_m = kAbstandTafeln_m;
+  double seitenabstand_m = kAbstandGleis_m;  ///< > 0: rechts in Normrichtung, < 0: links
+};
+
+/**
+ * Standort einer Tafel in Modulkoordinaten.
+ */
+struct TafelStandort final {
+  double x_m;
+  double y_m;
+  double z_m;
+  double richtung;  ///< Drehung um die Z-Achse im Bogenmass, Normrichtung des Streckenelements
+  int kilometrierung_m;
+  uint32_t element_nr;
+};
+
+struct StreckenStatistik final {
+  size_t anzahl_elemente = 0;
+  size_t anzahl_ohne_kilometrierung = 0;
+  size_t anzahl_ausserhalb = 0;  ///< Elemente mit Kilometrierung jenseits von +/-kMaxWert_m, dort ohne Standorte
+  size_t anzahl_standorte = 0;
+  uint64_t gelesene_bytes = 0;
+};
+
+/**
+ * Liest alle Streckenelemente (<StrElement> mit Anfang <b>, Ende <g> und Kilometrierung aus
+ * <InfoNormRichtung> bzw. <InfoGegenRichtung>) und ruft `ziel` in Dateireihenfolge fuer jeden
+ * Punkt auf, an dem die Kilometrierung ein Vielfaches von optionen.abstand_m erreicht.
+ * Die Kilometrierung wird innerhalb eines Elements linear interpoliert. Punkte ausserhalb von
+ * +/-kMaxWert_m werden uebersprungen.
+ */
+bool LiesStrecke(FILE* fd, const StreckenOptionen& optionen, const std::function<void(const TafelStandort&)>& ziel,
+    StreckenStatistik* statistik, std::string* fehler);
+
+/**
+ * Wie LiesStrecke, fasst die Standorte aber zu quadratischen Kacheln mit kKachelGroesse_m
+ * Kantenlaenge zusammen. Der Abschnittsname enthaelt den Ursprung der Kachel in Modulkoordinaten,
+ * z.B. Kachel_4000_-2000; die Koordinaten der Tafeln sind relativ zu diesem Ursprung.
+ */
+bool LiesStreckenabschnitte(FILE* fd, const StreckenOptionen& optionen, std::optional<Kilometrierung> ueberlaenge_basis,
+    std::vector<Streckenabschnitt>* result, StreckenStatistik* statistik, std::string* fehler);
+
+#endif  // STRECKE_HPP_
@@ -0,0 +1,252 @@
+// Copyright 2026 Zusitools
+
+#include "hekto_builder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Prueft fuer jede darstellbare Tafel (Groesse, Vorzeichen, Kilometer, Hektometer, Ueberlaenge)
+ * die Invarianten der Ziffernanordnung und der erzeugten Vorderseite explizit, also unabhaengig
+ * davon, ob die asserts in hekto_builder.cpp einkompiliert sind.
+ */
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+// Anzahl gemeldeter Fehler, danach wird nur noch gezaehlt.
+constexpr size_t kMaxMeldungen = 20;
+
+void Hilfe(const char* programm) {
+  fprintf(stderr,
+      "Aufruf: %s [Optionen]\n"
+      "\n"
+      "Prueft fuer alle Kombinationen aus Groesse, Vorzeichen, Kilometer, Hektometer und Ueberlaenge\n"
+      "die Ziffernabstaende, die Stuetzpunkte und die Dreiecke und Texturkoordinaten der Vorderseite.\n"
+      "Endet mit Fehlercode 1, falls eine Invariante verletzt ist.\n"
+      "\n"
+      "  --threads <n>             Anzahl Threads (Standard: Anzahl Prozessorkerne)\n",
+      programm);
+}
+
+struct Tafel final {
+  Groesse groesse;
+  bool ist_negativ;
+  int zahl_oben;
+  int ziffer_unten;
+  std::optional<int> ueberlaenge;
+
+  std::string Name() const {
+    return std::string(groesse == Groesse::kGross ? "gross " : "klein ") + (ist_negativ ? "-" : "")
+      + std::to_string(zahl_oben) + "." + std::to_string(ziffer_unten)
+      + (ueberlaenge.has_value() ? " Ueberlaenge " + std::to_string(*ueberlaenge) : "");
+  }
+};
+
+class Pruefung final {
+ public:
+  explicit Pruefung(const Tafel& tafel) : tafel_(tafel) { }
+
+  void Fehler(const std::string& text) {
+    if (fehler_.empty()) {
+      fehler_ = tafel_.Name() + ": " + text;
+    }
+  }
+
+  const std::string& Ergebnis() const { return fehler_; }
+
+ private:
+  const Tafel& tafel_;
+  std::string fehler_;
+};
+
+void PruefeZeile(const TafelParameter& tp, const InlineVector<int, kMaxZiffern>& ziffern,
+    const InlineVector<int, kMaxZiffern + 1>& abstaende, const InlineVector<std::pair<int, int>, 2 * kMaxZiffern>& intervalle,
+    const Stuetzpunkte& stuetzpunkte, bool unten, Pruefung* pruefung) {
+  const std::string zeile = unten ? "unten: " : "oben: ";
+  if (abstaende.size() != ziffern.size() + 1 || intervalle.size() != 2 * ziffern.size()
+      || stuetzpunkte.size() != 2 * ziffern.size()) {
+    pruefung->Fehler(zeile + "falsche Anzahl Abstaende, Intervalle oder Stuetzpunkte");
+    return;
+  }
+
+  int breite = std::accumulate(std::begin(abstaende), std::end(abstaende), 0);
+  for (const auto ziffer : ziffern) {
+    breite += tp.tex_ziffern[ziffer].breite_mm;
+  }
+  if (breite != tp.breite_mm) {
+    pruefung->Fehler(zeile + "Ziffern und Abstaende ergeben " + std::to_string(breite) + " mm statt der Tafelbreite");
+  }
+
+  for (size_t i = 0; i < abstaende.size(); ++i) {
+    if (abstaende[i] < 0) {
+      pruefung->Fehler(zeile + "Abstand " + std::to_string(i) + " ist negativ");
+    }
+    // Zwischen erster Ziffer und Ueberlaengen-Wert darf der Abstand groesser sein
+    const bool innen = i != 0 && i != abstaende.size() - 1 && !(unten && i == 1);
+    if (innen && abstaende[i] > tp.max_ziffernabstand_mm) {
+      pruefung->Fehler(zeile + "Abstand " + std::to_string(i) + " ist groesser als der maximale Ziffernabstand");
+    }
+  }
+
+  for (size_t i = 0; i < intervalle.size(); ++i) {
+    const auto [von, bis] = intervalle[i];
+    if (von > bis || von < tp.XLinks() || bis > tp.XRechts()) {
+      pruefung->Fehler(zeile + "Intervall " + std::to_string(i) + " ist leer oder liegt ausserhalb der Tafel");
+    }
+    if (i > 0 && von < intervalle[i - 1].first) {
+      pruefung->Fehler(zeile + "Intervalle sind nicht sortiert");
+    }
+    if (stuetzpunkte[i] < von || stuetzpunkte[i] > bis) {
+      pruefung->Fehler(zeile + "Stuetzpunkt " + std::to_string(i) + " liegt ausserhalb seines Intervalls");
+    }
+    if (i > 0 && stuetzpunkte[i] < stuetzpunkte[i - 1]) {
+      pruefung->Fehler(zeile + "Stuetzpunkte sind nicht sortiert");
+    }
+  }
+
+  // Jede Ziffer liegt zwischen ihren beiden Stuetzpunkten
+  int offset = tp.XLinks() + abstaende.front();
+  for (size_t i = 0; i < ziffern.size(); ++i) {
+    const int ziffer_breite = tp.tex_ziffern[ziffern[i]].breite_mm;
+    if (offset < stuetzpunkte[2 * i] || offset + ziffer_breite > stuetzpunkte[2 * i + 1]) {
+      pruefung->Fehler(zeile + "Ziffer " + std::to_string(i) + " liegt nicht zwischen ihren Stuetzpunkten");
+    }
+    offset += ziffer_breite + abstaende[i + 1];
+  }
+}
+
+// Grundpruefung ueber ValidateMesh() (endliche Werte, Indizes, Texturkoordinaten bis auf einen halben Pixel
+// des Atlas, Umlaufsinn). Zusaetzlich muessen Dreiecke eine Flaeche haben; die Faecher-Triangulierung erzeugt
+// bekanntermassen Dreiecke ohne Flaeche entlang der Stuetzpunkte (`entartete_erlaubt`).
+void PruefeMesh(const Mesh& mesh, const char* name, bool entartete_erlaubt, Pruefung* pruefung) {
+  for (const auto& fehler : ValidateMesh(mesh, {}, 1)) {
+    pruefung->Fehler(std::string(name) + ": " + Beschreibung(fehler));
+  }
+  if (entartete_erlaubt) {
+    return;
+  }
+  for (size_t i = 0; i < mesh.faces.size(); ++i) {
+    const auto& face = mesh.faces[i];
+    if (std::max({ face.i1, face.i2, face.i3 }) >= mesh.vertices.size()) {
+      continue;
+    }
+    const auto& p1 = mesh.vertices[face.i1];
+    const auto& p2 = mesh.vertices[face.i2];
+    const auto& p3 = mesh.vertices[face.i3];
+    const int64_t a[3] = { p2.pos_x - p1.pos_x, p2.pos_y - p1.pos_y, p2.pos_z - p1.pos_z };
+    const int64_t b[3] = { p3.pos_x - p1.pos_x, p3.pos_y - p1.pos_y, p3.pos_z - p1.pos_z };
+    if (a[1] * b[2] == a[2] * b[1] && a[2] * b[0] == a[0] * b[2] && a[0] * b[1] == a[1] * b[0]) {
+      pruefung->Fehler(std::string(name) + ": Face " + std::to_string(i) + " ist entartet");
+    }
+  }
+}
+
+std::string PruefeTafel(const Tafel& tafel) {
+  Pruefung pruefung(tafel);
+  const auto tp = HektoBuilder::BaueTafelParameter(tafel.groesse, tafel.ist_negativ, tafel.zahl_oben, tafel.ziffer_unten,
+      tafel.ueberlaenge);
+
+  const auto layout = ZiffernBuilder::Layout(tp, tafel.zahl_oben, tafel.ziffer_unten, tafel.ueberlaenge);
+  PruefeZeile(tp, layout.ziffern_oben, layout.abstaende_oben, layout.intervalle_oben, layout.stuetzpunkte_oben, false, &pruefung);
+  PruefeZeile(tp, layout.ziffern_unten, layout.abstaende_unten, layout.intervalle_unten, layout.stuetzpunkte_unten, true, &pruefung);
+  if (!pruefung.Ergebnis().empty()) {
+    return pruefung.Ergebnis();
+  }
+
+  for (const auto detailstufe : { Detailstufe::kVoll, Detailstufe::kGrob }) {
+    const auto ziffern = ZiffernBuilder::Build(tp, tafel.ist_negativ, tafel.zahl_oben, tafel.ziffer_unten, tafel.ueberlaenge, detailstufe);
+    PruefeMesh(ziffern.mesh1, detailstufe == Detailstufe::kVoll ? "Ziffern" : "Ziffern (grob)", false, &pruefung);
+    PruefeMesh(ziffern.mesh2, "Vorzeichen und Ueberlaenge", false, &pruefung);
+  }
+  PruefeMesh(TafelVorderseiteBuilder::Build(tp, layout.stuetzpunkte_oben, layout.stuetzpunkte_unten, Triangulierung::kFaecher),
+      "Vorderseite (Faecher)", true, &pruefung);
+  PruefeMesh(TafelVorderseiteBuilder::Build(tp, layout.stuetzpunkte_oben, layout.stuetzpunkte_unten, Triangulierung::kMinimal),
+      "Vorderseite (minimal)", false, &pruefung);
+  PruefeMesh(TafelVorderseiteBuilder::BuildGrob(tp, layout.stuetzpunkte_oben, layout.stuetzpunkte_unten),
+      "Vorderseite (grob)", false, &pruefung);
+  return pruefung.Ergebnis();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t anzahl_threads = 0;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hat_wert = i + 1 < argc;
+    if (!strcmp(arg, "--threads") && hat_wert) {
+      anzahl_threads = strtoul(argv[++i], nullptr, 10);
+    } else {
+      Hilfe(argv[0]);
+      return 1;
+    }
+  }
+  if (anzahl_threads == 0) {
+    anzahl_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Eine Arbeitseinheit: alle Hektometer- und Ueberlaengen-Werte zu Groesse, Vorzeichen und Kilometer
+  constexpr int kAnzahlKilometer = 1000;
+  constexpr int kAnzahlEinheiten = 2 * 2 * kAnzahlKilometer;
+
+  const auto start = Uhr::now();
+  std::atomic<int> naechste_einheit { 0 };
+  std::atomic<size_t> anzahl_tafeln { 0 };
+  std::atomic<size_t> anzahl_fehler { 0 };
+  std::mutex mutex;
+  std::vector<std::string> meldungen;
+
+  auto Arbeite = [&]() {
+    while (true) {
+      const int einheit = naechste_einheit++;
+      if (einheit >= kAnzahlEinheiten) {
+        break;
+      }
+      Tafel tafel {
+        einheit / (2 * kAnzahlKilometer) == 0 ? Groesse::kGross : Groesse::kKlein,
+        (einheit / kAnzahlKilometer) % 2 == 1,
+        einheit % kAnzahlKilometer,
+        0,
+        std::nullopt,
+      };
+      for (tafel.ziffer_unten = 0; tafel.ziffer_unten <= 9; ++tafel.ziffer_unten) {
+        for (int ueberlaenge = -1; ueberlaenge <= kMaxUeberlaenge; ++ueberlaenge) {
+          tafel.ueberlaenge = ueberlaenge < 0 ? std::nullopt : std::optional { ueberlaenge };
+          ++anzahl_tafeln;
+          auto fehler = PruefeTafel(tafel);
+          if (!fehler.empty() && anzahl_fehler++ < kMaxMeldungen) {
+            std::lock_guard<std::mutex> lock(mutex);
+            meldungen.push_back(std::move(fehler));
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < anzahl_threads; ++i) {
+    threads.emplace_back(Arbeite);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::sort(std::begin(meldungen), std::end(meldungen));
+  for (const auto& meldung : meldungen) {
+    fprintf(stderr, "%s\n", meldung.c_str());
+  }
+  printf("%zu Tafeln in %.1f s mit %zu Threads geprueft, %zu fehlerhaft\n", anzahl_tafeln.load(),
+      std::chrono::duration<double>(Uhr::now() - start).count(), anzahl_threads, anzahl_fehler.load());
+  return anzahl_fehler == 0 ? 0 : 1;
+}
@@ -0,0 +1,456 @@
+// Copyright 2026 Zusitools
+
+#include "tafel_index.hpp"
+
+#include "batch.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+constexpr char kKennung[8] = { 'H', 'E', 'K', 'T', 'O', 'I', 'D', 'X' };
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kMinKapazitaet = 1024;
+
+struct Kopf final {
+  char kennung[8];
+  uint32_t version;
+  uint32_t slot_groesse;
+  uint64_t kapazitaet;  ///< Anzahl Slots, Zweierpotenz
+  uint64_t anzahl;
+  uint64_t reserviert[4];
+};
+static_assert(sizeof(Kopf) == 64);
+
+struct Slot final {
+  uint64_t schluessel;  ///< 0 = frei
+  uint64_t inhalt_hash;
+  uint32_t groesse;
+  uint32_t pfad_offset;  ///< ab Dateianfang
+  uint32_t pfad_laenge;
+  uint32_t reserviert;
+};
+static_assert(sizeof(Slot) == 32);
+
+constexpr size_t SlotOffset(uint64_t i) {
+  return sizeof(Kopf) + i * sizeof(Slot);
+}
+
+// Prueft Kopf und Groesse der Tabelle. `daten` muss mindestens sizeof(Kopf) Bytes enthalten.
+bool IstGueltig(const unsigned char* daten, size_t groesse, Kopf* kopf) {
+  if (groesse < sizeof(Kopf)) {
+    return false;
+  }
+  memcpy(kopf, daten, sizeof(Kopf));
+  return !memcmp(kopf->kennung, kKennung, sizeof(kKennung)) && kopf->version == kVersion && kopf->slot_groesse == sizeof(Slot)
+    && kopf->kapazitaet != 0 && (kopf->kapazitaet & (kopf->kapazitaet - 1)) == 0
+    && kopf->kapazitaet <= (groesse - sizeof(Kopf)) / sizeof(Slot);
+}
+
+Slot LiesSlot(const unsigned char* daten, uint64_t i) {
+  Slot slot;
+  memcpy(&slot.schluessel, daten + SlotOffset(i), sizeof(slot.schluessel));
+  // Der Schluessel wird zuletzt geschrieben; ist er gesetzt, sind es die Nutzdaten auch.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  memcpy(reinterpret_cast<unsigned char*>(&slot) + sizeof(slot.schluessel),
+      daten + SlotOffset(i) + sizeof(slot.schluessel), sizeof(Slot) - sizeof(slot.schluessel));
+  return slot;
+}
+
+// Slot mit `schluessel` oder der erste freie Slot auf dessen Sondierungsfolge; kapazitaet, falls die Tabelle voll ist.
+uint64_t FindeSlot(const unsigned char* daten, uint64_t kapazitaet, uint64_t schluessel) {
+  for (uint64_t n = 0, i = schluessel & (kapazitaet - 1); n < kapazitaet; ++n, i = (i + 1) & (kapazitaet - 1)) {
+    uint64_t slot_schluessel;
+    memcpy(&slot_schluessel, daten + SlotOffset(i), sizeof(slot_schluessel));
+    if (slot_schluessel == 0 || slot_schluessel == schluessel) {
+      return i;
+    }
+  }
+  return kapazitaet;
+}
+
+// Baut eine neue Indexdatei; die Eintraege werden nach Schluessel sortiert eingefuegt, damit
+// gleiche Inhalte eine gleiche Datei ergeben.
+std::vector<unsigned char> BaueIndex(std::vector<IndexEintrag> eintraege) {
+  std::sort(eintraege.begin(), eintraege.end(), [](const auto& a, const auto& b) { return a.schluessel < b.schluessel; });
+
+  // Nach dem Neuaufbau hoechstens zu einem Viertel gefuellt, damit nicht jedes Anhaengen neu aufbaut.
+  uint64_t kapazitaet = kMinKapazitaet;
+  while (kapazitaet < 4 * eintraege.size()) {
+    kapazitaet *= 2;
+  }
+
+  std::vector<unsigned char> result(SlotOffset(kapazitaet));
+  Kopf kopf {};
+  memcpy(kopf.kennung, kKennung, sizeof(kKennung));
+  kopf.version = kVersion;
+  kopf.slot_groesse = sizeof(Slot);
+  kopf.kapazitaet = kapazitaet;
+  kopf.anzahl = eintraege.size();
+  memcpy(result.data(), &kopf, sizeof(kopf));
+
+  for (const auto& eintrag : eintraege) {
+    const Slot slot { eintrag.schluessel, eintrag.inhalt_hash, eintrag.groesse,
+      static_cast<uint32_t>(result.size()), static_cast<uint32_t>(eintrag.pfad.size()), 0 };
+    memcpy(result.data() + SlotOffset(FindeSlot(result.data(), kapazitaet, eintrag.schluessel)), &slot, sizeof(slot));
+    result.insert(result.end(), eintrag.pfad.begin(), eintrag.pfad.end());
+  }
+  return result;
+}
+
+}  // namespace
+
+uint64_t TafelSchluessel(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm,
+    std::string_view zusatz) {
+  const int32_t werte[] = {
+    static_cast<int32_t>(bauparameter.hoehe),
+    static_cast<int32_t>(bauparameter.mast),
+    static_cast<int32_t>(bauparameter.beidseitig),
+    static_cast<int32_t>(bauparameter.groesse),
+    static_cast<int32_t>(bauparameter.rueckstrahlend),
+    static_cast<int32_t>(bauparameter.ankerpunkt),
+    static_cast<int32_t>(bauparameter.textur),
+    static_cast<int32_t>(bauparameter.triangulierung),
+    static_cast<int32_t>(bauparameter.index_reihenfolge),
+    static_cast<int32_t>(bauparameter.detailstufe),
+    static_cast<int32_t>(bauparameter.attributausgabe),
+    static_cast<int32_t>(bauparameter.genauigkeit),
+    static_cast<int32_t>(kAusgabeVersion),
+    kilometrierung.km,
+    kilometrierung.hm,
+    ueberlaenge_hm.has_value(),
+    ueberlaenge_hm.value_or(0),
+  };
+  std::string daten(reinterpret_cast<const char*>(werte), sizeof(werte));
+  daten.append(zusatz);
+  const uint64_t result = InhaltsHash(daten).first;
+  return result != 0 ? result : 1;
+}
+
+uint64_t TafelSchluessel(const BatchAuftrag& auftrag, const BatchZiel& ziel) {
+  auto bauparameter = auftrag.bauparameter;
+  bauparameter.textur = ziel.textur;
+  bauparameter.rueckstrahlend = ziel.rueckstrahlend;
+  std::string zusatz;
+  for (const auto& datei : auftrag.detailstufen) {
+    zusatz += datei.dateiname;
+    zusatz += '\n';
+  }
+  return TafelSchluessel(bauparameter, auftrag.kilometrierung, auftrag.ueberlaenge_hm, zusatz);
+}
+
+IndexDateiSchreiber::IndexDateiSchreiber(std::string index_pfad, std::unordered_map<std::string, uint64_t> schluessel,
+    DateiSchreiber* basis)
+  : index_pfad_(std::move(index_pfad)), schluessel_(std::move(schluessel)), basis_(basis) { }
+
+bool IndexDateiSchreiber::SchreibeDatei(const std::string& pfad, const std::string& inhalt) {
+  if (!basis_->SchreibeDatei(pfad, inhalt)) {
+    return false;
+  }
+  const auto it = schluessel_.find(pfad);
+  if (it != schluessel_.end()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eintraege_.push_back({ it->second, InhaltsHash(inhalt).first, static_cast<uint32_t>(inhalt.size()), pfad });
+  }
+  return true;
+}
+
+bool IndexDateiSchreiber::Abschliessen() {
+  // Erst eintragen, wenn die Dateien sicher geschrieben sind
+  if (!basis_->Abschliessen()) {
+    return false;
+  }
+  // Nachtraeglich fehlgeschlagene Dateien werden nicht eingetragen
+  std::unordered_set<std::string> fehlgeschlagen;
+  for (auto& fehler : basis_->NachtraeglicheFehler()) {
+    fehlgeschlagen.insert(std::move(fehler.pfad));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  eintraege_.erase(std::remove_if(eintraege_.begin(), eintraege_.end(),
+      [&fehlgeschlagen](const IndexEintrag& eintrag) { return fehlgeschlagen.count(eintrag.pfad) != 0; }), eintraege_.end());
+  if (eintraege_.empty()) {
+    return true;
+  }
+  const bool ok = FuegeZumIndexHinzu(index_pfad_, eintraege_, &fehler_);
+  eintraege_.clear();
+  return ok;
+}
+
+TafelIndex::TafelIndex(const std::string& pfad) {
+  const unsigned char* daten = nullptr;
+  size_t groesse = 0;
+#ifdef _WIN32
+  HANDLE datei = CreateFileA(pfad.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (datei == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER dateigroesse;
+  if (GetFileSizeEx(datei, &dateigroesse) && dateigroesse.QuadPart >= static_cast<LONGLONG>(sizeof(Kopf))) {
+    HANDLE mapping = CreateFileMappingA(datei, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      daten = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      groesse = static_cast<size_t>(dateigroesse.QuadPart);
+      CloseHandle(mapping);  // die Ansicht haelt das Mapping offen
+    }
+  }
+  CloseHandle(datei);
+#else
+  const int fd = open(pfad.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Kopf))) {
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED) {
+      daten = static_cast<const unsigned char*>(mapping);
+      groesse = st.st_size;
+    }
+  }
+  close(fd);
+#endif
+
+  Kopf kopf;
+  if (daten != nullptr && IstGueltig(daten, groesse, &kopf)) {
+    daten_ = daten;
+    groesse_ = groesse;
+  } else if (daten != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(daten);
+#else
+    munmap(const_cast<unsigned char*>(daten), groesse);
+#endif
+  }
+}
+
+TafelIndex::~TafelIndex() {
+  if (daten_ == nullptr) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(daten_);
+#else
+  munmap(const_cast<unsigned char*>(daten_), groesse_);
+#endif
+}
+
+size_t TafelIndex::Anzahl() const {
+  if (daten_ == nullptr) {
+    return 0;
+  }
+  Kopf kopf;
+  memcpy(&kopf, daten_, sizeof(kopf));
+  return kopf.anzahl;
+}
+
+std::optional<IndexEintrag> TafelIndex::Suche(uint64_t schluessel) const {
+  if (daten_ == nullptr) {
+    return std::nullopt;
+  }
+  Kopf kopf;
+  memcpy(&kopf, daten_, sizeof(kopf));
+  const uint64_t i = FindeSlot(daten_, kopf.kapazitaet, schluessel);
+  if (i == kopf.kapazitaet) {
+    return std::nullopt;
+  }
+  const Slot slot = LiesSlot(daten_, i);
+  // Der Pfad eines nach dem Einblenden angehaengten Eintrags liegt ggf. ausserhalb des Mappings.
+  if (slot.schluessel != schluessel || static_cast<uint64_t>(slot.pfad_offset) + slot.pfad_laenge > groesse_) {
+    return std::nullopt;
+  }
+  return IndexEintrag { slot.schluessel, slot.inhalt_hash, slot.groesse,
+    std::string(reinterpret_cast<const char*>(daten_) + slot.pfad_offset, slot.pfad_laenge) };
+}
+
+#ifdef _WIN32
+
+bool FuegeZumIndexHinzu(const std::string& pfad, const std::vector<IndexEintrag>& eintraege, std::string* fehler) {
+  *fehler = pfad + ": Schreiben des Index wird unter Windows nicht unterstuetzt";
+  return false;
+}
+
+#else
+
+namespace {
+
+bool SchreibeAlles(int fd, const void* daten, size_t laenge, off_t offset) {
+  const auto* zeiger = static_cast<const unsigned char*>(daten);
+  while (laenge > 0) {
+    const ssize_t geschrieben = pwrite(fd, zeiger, laenge, offset);
+    if (geschrieben <= 0) {
+      return false;
+    }
+    zeiger += geschrieben;
+    laenge -= geschrieben;
+    offset += geschrieben;
+  }
+  return true;
+}
+
+bool ErsetzeIndex(const std::string& pfad, const std::vector<unsigned char>& inhalt, std::string* fehler) {
+  const auto temp_pfad = pfad + "." + std::to_string(getpid()) + ".neu";
+  const int fd = open(temp_pfad.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    *fehler = temp_pfad + ": kann nicht geschrieben werden";
+    return false;
+  }
+  const bool ok = SchreibeAlles(fd, inhalt.data(), inhalt.size(), 0) && fsync(fd) == 0;
+  if ((close(fd) != 0) || !ok || rename(temp_pfad.c_str(), pfad.c_str()) != 0) {
+    unlink(temp_pfad.c_str());
+    *fehler = pfad + ": kann nicht ersetzt werden";
+    return false;
+  }
+  return true;
+}
+
+// Erwartet eine exklusiv gesperrte, aktuelle Indexdatei.
+bool SchreibeGesperrt(int fd, const std::string& pfad, const std::vector<IndexEintrag>& eintraege, std::string* fehler) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *fehler = pfad + ": kann nicht gelesen werden";
+    return false;
+  }
+  std::vector<unsigned char> daten(st.st_size);
+  if (!daten.empty() && pread(fd, daten.data(), daten.size(), 0) != static_cast<ssize_t>(daten.size())) {
+    *fehler = pfad + ": kann nicht gelesen werden";
+    return false;
+  }
+  Kopf kopf {};
+  if (!daten.empty() && !IstGueltig(daten.data(), daten.size(), &kopf)) {
+    *fehler = pfad + ": kein gueltiger Index";
+    return false;
+  }
+
+  // Bei mehrfach angegebenem Schluessel oder Pfad gilt der letzte Eintrag
+  std::vector<const IndexEintrag*> neue;
+  std::unordered_set<uint64_t> neue_schluessel;
+  std::unordered_map<std::string_view, uint64_t> neue_pfade;
+  for (auto it = eintraege.rbegin(); it != eintraege.rend(); ++it) {
+    if (neue_schluessel.insert(it->schluessel).second && neue_pfade.emplace(it->pfad, it->schluessel).second) {
+      neue.push_back(&*it);
+    }
+  }
+  // Ein alter Eintrag mit demselben Pfad unter anderem Schluessel (der Dateiname enthaelt nicht alle
+  // Bauparameter) verweist auf eine inzwischen ueberschriebene Datei und wird entfernt.
+  auto IstVerdraengt = [&neue_pfade, &daten](const Slot& slot) {
+    const auto it = neue_pfade.find(std::string_view(reinterpret_cast<const char*>(daten.data()) + slot.pfad_offset, slot.pfad_laenge));
+    return it != neue_pfade.end() && it->second != slot.schluessel;
+  };
+
+  bool neu_aufbauen = daten.empty();
+  for (uint64_t i = 0; !neu_aufbauen && i < kopf.kapazitaet; ++i) {
+    const Slot slot = LiesSlot(daten.data(), i);
+    neu_aufbauen = slot.schluessel != 0 && IstVerdraengt(slot);
+  }
+
+  std::vector<const IndexEintrag*> anzuhaengen;
+  for (const auto* eintrag : neue) {
+    if (neu_aufbauen) {
+      break;
+    }
+    const uint64_t i = FindeSlot(daten.data(), kopf.kapazitaet, eintrag->schluessel);
+    const Slot slot = i < kopf.kapazitaet ? LiesSlot(daten.data(), i) : Slot {};
+    if (slot.schluessel == 0) {
+      anzuhaengen.push_back(eintrag);
+    } else if (slot.inhalt_hash != eintrag->inhalt_hash || slot.groesse != eintrag->groesse
+        || std::string_view(reinterpret_cast<const char*>(daten.data()) + slot.pfad_offset, slot.pfad_laenge) != eintrag->pfad) {
+      neu_aufbauen = true;  // Eintraege werden nie an Ort und Stelle geaendert
+    }
+  }
+  neu_aufbauen |= 2 * (kopf.anzahl + anzuhaengen.size()) > kopf.kapazitaet;
+  uint64_t ende_neu = daten.size();
+  for (const auto* eintrag : anzuhaengen) {
+    ende_neu += eintrag->pfad.size();
+  }
+  neu_aufbauen |= ende_neu > UINT32_MAX;  // Pfad-Offsets sind 32 Bit breit; ein Neuaufbau entfernt alte Pfade
+
+  if (neu_aufbauen) {
+    std::unordered_map<uint64_t, IndexEintrag> alle;
+    for (uint64_t i = 0; !daten.empty() && i < kopf.kapazitaet; ++i) {
+      const Slot slot = LiesSlot(daten.data(), i);
+      if (slot.schluessel != 0 && !IstVerdraengt(slot)) {
+        alle[slot.schluessel] = { slot.schluessel, slot.inhalt_hash, slot.groesse,
+          std::string(reinterpret_cast<const char*>(daten.data()) + slot.pfad_offset, slot.pfad_laenge) };
+      }
+    }
+    for (const auto* eintrag : neue) {
+      alle[eintrag->schluessel] = *eintrag;
+    }
+    std::vector<IndexEintrag> liste;
+    liste.reserve(alle.size());
+    for (auto& [schluessel, eintrag] : alle) {
+      liste.push_back(std::move(eintrag));
+    }
+    return ErsetzeIndex(pfad, BaueIndex(std::move(liste)), fehler);
+  }
+
+  // Anhaengen: erst den Pfad, dann die Nutzdaten des Slots, zuletzt den Schluessel, dann die Anzahl.
+  off_t ende = daten.size();
+  for (const auto* eintrag : anzuhaengen) {
+    const uint64_t i = FindeSlot(daten.data(), kopf.kapazitaet, eintrag->schluessel);
+    const Slot slot { eintrag->schluessel, eintrag->inhalt_hash, eintrag->groesse,
+      static_cast<uint32_t>(ende), static_cast<uint32_t>(eintrag->pfad.size()), 0 };
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&slot);
+    if (!SchreibeAlles(fd, eintrag->pfad.data(), eintrag->pfad.size(), ende)
+        || !SchreibeAlles(fd, bytes + sizeof(slot.schluessel), sizeof(slot) - sizeof(slot.schluessel), SlotOffset(i) + sizeof(slot.schluessel))
+        || !SchreibeAlles(fd, bytes, sizeof(slot.schluessel), SlotOffset(i))) {
+      *fehler = pfad + ": Schreibfehler";
+      return false;
+    }
+    memcpy(daten.data() + SlotOffset(i), &slot, sizeof(slot));  // fuer das Sondieren der folgenden Eintraege
+    ende += eintrag->pfad.size();
+  }
+  kopf.anzahl += anzuhaengen.size();
+  if (!SchreibeAlles(fd, &kopf, sizeof(kopf), 0)) {
+    *fehler = pfad + ": Schreibfehler";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool FuegeZumIndexHinzu(const std::string& pfad, const std::vector<IndexEintrag>& eintraege, std::string* fehler) {
+  while (true) {
+    const int fd = open(pfad.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      *fehler = pfad + ": kann nicht geoeffnet werden";
+      return false;
+    }
+    if (flock(fd, LOCK_EX) != 0) {
+      close(fd);
+      *fehler = pfad + ": kann nicht gesperrt werden";
+      return false;
+    }
+
+    // Hat ein anderer Schreiber die Datei inzwischen ersetzt, gilt die Sperre der alten Datei nichts.
+    struct stat offen;
+    struct stat aktuell;
+    if (fstat(fd, &offen) != 0 || stat(pfad.c_str(), &aktuell) != 0
+        || offen.st_ino != aktuell.st_ino || offen.st_dev != aktuell.st_dev) {
+      close(fd);
+      continue;
+    }
+
+    const bool ok = SchreibeGesperrt(fd, pfad, eintraege, fehler);
+    close(fd);  // gibt auch die Sperre frei
+    return ok;
+  }
+}
+
+#endif
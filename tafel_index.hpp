@@ -0,0 +1,102 @@
+// Copyright 2026 Zusitools
+
+#ifndef TAFEL_INDEX_HPP_
+#define TAFEL_INDEX_HPP_
+
+#include "batch.hpp"
+#include "hekto_builder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Index der erzeugten Dateien: beantwortet "gibt es diese Tafel schon, und wo?" in O(1), ohne das
+ * Zielverzeichnis zu durchsuchen. Die Indexdatei hat ein festes Layout (Kopf, Hashtabelle mit offener
+ * Adressierung und linearem Sondieren, danach die Pfade) und wird von Lesern nur per mmap eingeblendet.
+ *
+ * Schreiber sperren die Datei exklusiv (flock). Neue Eintraege werden so geschrieben, dass ein Leser
+ * nie einen halb geschriebenen Eintrag sieht: erst Pfad und Nutzdaten, zuletzt der Schluessel.
+ * Muss die Tabelle wachsen oder ein Eintrag geaendert werden, wird eine neue Datei geschrieben und per
+ * rename() ersetzt; bereits geoeffnete Leser behalten die alte Datei.
+ */
+
+// Name der Indexdatei im Zielverzeichnis, wie ihn hekto_batch --index verwendet.
+constexpr const char* kIndexDateiname = "hekto_index.bin";
+
+// Schluessel einer Datei aus kAusgabeVersion, allen Bauparametern, der Kilometrierung und dem Ueberlaengen-Wert.
+// `zusatz` unterscheidet Dateien mit gleichen Parametern, z.B. die Verknuepfung der Detailstufen
+// (Dateinamen der Detailstufen) von der Geometrie der vollen Detailstufe (leer). Nie 0.
+uint64_t TafelSchluessel(const BauParameter& bauparameter, Kilometrierung kilometrierung, std::optional<int> ueberlaenge_hm,
+    std::string_view zusatz);
+
+struct IndexEintrag final {
+  uint64_t schluessel;
+  uint64_t inhalt_hash;  ///< erste Haelfte von InhaltsHash()
+  uint32_t groesse;
+  std::string pfad;  ///< relativ zum Zielverzeichnis
+};
+
+/**
+ * Nur lesender Zugriff auf eine Indexdatei. Spaeter hinzugefuegte Eintraege sind erst nach
+ * erneutem Oeffnen sichtbar.
+ */
+class TafelIndex final {
+ public:
+  explicit TafelIndex(const std::string& pfad);
+  ~TafelIndex();
+
+  TafelIndex(const TafelIndex&) = delete;
+  TafelIndex& operator=(const TafelIndex&) = delete;
+
+  // false, falls die Datei fehlt oder kein gueltiger Index ist; Suche() findet dann nichts.
+  bool Gueltig() const { return daten_ != nullptr; }
+
+  size_t Anzahl() const;
+  std::optional<IndexEintrag> Suche(uint64_t schluessel) const;
+
+ private:
+  const unsigned char* daten_ = nullptr;
+  size_t groesse_ = 0;
+};
+
+/**
+ * Fuegt Eintraege hinzu bzw. ersetzt Eintraege mit gleichem Schluessel. Eintraege mit gleichem Pfad, aber
+ * anderem Schluessel werden entfernt, da die Datei ueberschrieben wurde. Legt die Datei bei Bedarf an.
+ * Mehrere Prozesse duerfen gleichzeitig schreiben. Unter Windows nicht unterstuetzt.
+ */
+bool FuegeZumIndexHinzu(const std::string& pfad, const std::vector<IndexEintrag>& eintraege, std::string* fehler);
+
+// Schluessel der Datei, die fuer `ziel` eines Batch-Auftrags geschrieben wird.
+uint64_t TafelSchluessel(const BatchAuftrag& auftrag, const BatchZiel& ziel);
+
+/**
+ * Reicht jede Datei an `basis` weiter und traegt Dateien mit bekanntem Schluessel in Abschliessen()
+ * in den Index ein, in einem Schreibvorgang fuer alle.
+ */
+class IndexDateiSchreiber final : public DateiSchreiber {
+ public:
+  IndexDateiSchreiber(std::string index_pfad, std::unordered_map<std::string, uint64_t> schluessel, DateiSchreiber* basis);
+
+  bool SchreibeDatei(const std::string& pfad, const std::string& inhalt) override;
+  bool Abschliessen() override;
+  std::vector<SchreibFehler> NachtraeglicheFehler() const override { return basis_->NachtraeglicheFehler(); }
+
+  const std::string& Fehler() const { return fehler_; }
+
+ private:
+  const std::string index_pfad_;
+  const std::unordered_map<std::string, uint64_t> schluessel_;
+  DateiSchreiber* const basis_;
+
+  std::mutex mutex_;
+  std::vector<IndexEintrag> eintraege_;
+  std::string fehler_;
+};
+
+#endif  // TAFEL_INDEX_HPP_
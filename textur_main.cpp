@@ -0,0 +1,215 @@
+// Copyright 2026 Zusitools
+
+#include "bild.hpp"
+#include "dds.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void Hilfe(const char* programm) {
+  fprintf(stderr,
+      "Aufruf: %s [Optionen] <auftrag>...\n"
+      "\n"
+      "Erzeugt die DXT3-Texturen der Hektometertafeln (siehe assets/README.txt) aus RGBA-Bildern im\n"
+      "PAM-Format, z.B. per `pngtopam -alphapam` aus den Inkscape-Exporten.\n"
+      "\n"
+      "Auftrag:\n"
+      "  --normal <ziel.dds> <stufe0.pam> [<stufe1.pam> ...]\n"
+      "  --tunnel <ziel.dds> <stufe0.pam> [<stufe1.pam> ...]\n"
+      "                            Stufen 0 und 1 mit 75%% Helligkeit, jede weitere 75%% der vorherigen\n"
+      "  --verwittert <ziel.dds> <stufe0.pam> [<stufe1.pam> ...]\n"
+      "                            Ziffern in RGB(66, 57, 55)\n"
+      "  Nicht angegebene Mip-Stufen werden aus der vorherigen Stufe verkleinert.\n"
+      "\n"
+      "Optionen:\n"
+      "  --threads <n>             Threads zum Kodieren (Standard: Anzahl Prozessorkerne)\n"
+      "  --skalar                  SSE2-Blockkodierer nicht verwenden\n",
+      programm);
+}
+
+enum class Variante {
+  kNormal,
+  kTunnel,
+  kVerwittert,
+};
+
+constexpr double kTunnelHelligkeit = 0.75;
+
+constexpr uint8_t kVerwittertR = 66;
+constexpr uint8_t kVerwittertG = 57;
+constexpr uint8_t kVerwittertB = 55;
+
+// Bereich der Ziffern im Texturatlas (siehe MakeZiffernTexturen), bezogen auf 256x256 Pixel.
+constexpr BildBereich kZiffernBereich { 14 / 256.0, 136 / 256.0, 214 / 256.0, 250 / 256.0 };
+
+struct Auftrag final {
+  Variante variante;
+  std::string ziel;
+  std::vector<std::string> eingaben;
+  std::vector<Bild> stufen;  ///< unveraendert, vollstaendige Mip-Kette
+  std::vector<std::vector<uint8_t>> kodiert;
+};
+
+bool IstPotenzVonZwei(int wert) {
+  return wert > 0 && (wert & (wert - 1)) == 0;
+}
+
+bool LadeStufen(Auftrag* auftrag) {
+  for (size_t i = 0; i < auftrag->eingaben.size(); ++i) {
+    const auto& pfad = auftrag->eingaben[i];
+    FILE* fd = fopen(pfad.c_str(), "rb");
+    if (fd == nullptr) {
+      fprintf(stderr, "%s: kann nicht geoeffnet werden\n", pfad.c_str());
+      return false;
+    }
+    Bild bild;
+    std::string fehler;
+    const bool ok = LiesPam(fd, &bild, &fehler);
+    fclose(fd);
+    if (!ok) {
+      fprintf(stderr, "%s: %s\n", pfad.c_str(), fehler.c_str());
+      return false;
+    }
+
+    if (i == 0) {
+      if (!IstPotenzVonZwei(bild.breite) || !IstPotenzVonZwei(bild.hoehe)) {
+        fprintf(stderr, "%s: Breite und Hoehe muessen Zweierpotenzen sein\n", pfad.c_str());
+        return false;
+      }
+    } else {
+      const auto& vorher = auftrag->stufen.back();
+      if (bild.breite != std::max(1, vorher.breite / 2) || bild.hoehe != std::max(1, vorher.hoehe / 2)) {
+        fprintf(stderr, "%s: Mip-Stufe %zu muss %dx%d Pixel gross sein\n", pfad.c_str(), i,
+            std::max(1, vorher.breite / 2), std::max(1, vorher.hoehe / 2));
+        return false;
+      }
+    }
+    auftrag->stufen.push_back(std::move(bild));
+  }
+
+  while (auftrag->stufen.back().breite > 1 || auftrag->stufen.back().hoehe > 1) {
+    auftrag->stufen.push_back(Verkleinere(auftrag->stufen.back()));
+  }
+  auftrag->kodiert.resize(auftrag->stufen.size());
+  return true;
+}
+
+std::vector<uint8_t> KodiereStufe(const Auftrag& auftrag, size_t stufe, BlockKodierer kodierer) {
+  Bild bild = auftrag.stufen[stufe];
+  switch (auftrag.variante) {
+    case Variante::kNormal:
+      break;
+    case Variante::kTunnel:
+      // Simuliert die Beleuchtung durch Scheinwerfer: je weiter entfernt, desto dunkler
+      SkaliereHelligkeit(std::pow(kTunnelHelligkeit, std::max<size_t>(1, stufe)), &bild);
+      break;
+    case Variante::kVerwittert:
+      FaerbeUm(kZiffernBereich, kVerwittertR, kVerwittertG, kVerwittertB, &bild);
+      break;
+  }
+  return KodiereDxt3(bild, kodierer);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<Auftrag> auftraege;
+  size_t anzahl_threads = 0;
+  BlockKodierer kodierer = BlockKodierer::kSimd;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hat_wert = i + 1 < argc;
+    if (!strcmp(arg, "--threads") && hat_wert) {
+      anzahl_threads = static_cast<size_t>(atoi(argv[++i]));
+    } else if (!strcmp(arg, "--skalar")) {
+      kodierer = BlockKodierer::kSkalar;
+    } else if ((!strcmp(arg, "--normal") || !strcmp(arg, "--tunnel") || !strcmp(arg, "--verwittert")) && hat_wert) {
+      const auto variante = !strcmp(arg, "--normal") ? Variante::kNormal
+        : (!strcmp(arg, "--tunnel") ? Variante::kTunnel : Variante::kVerwittert);
+      auftraege.push_back({ variante, argv[++i], {}, {}, {} });
+    } else if (arg[0] != '-' && !auftraege.empty()) {
+      auftraege.back().eingaben.push_back(arg);
+    } else {
+      Hilfe(argv[0]);
+      return 1;
+    }
+  }
+
+  if (auftraege.empty() || std::any_of(auftraege.begin(), auftraege.end(), [](const Auftrag& a) { return a.eingaben.empty(); })) {
+    Hilfe(argv[0]);
+    return 1;
+  }
+
+  for (auto& auftrag : auftraege) {
+    if (!LadeStufen(&auftrag)) {
+      return 1;
+    }
+  }
+
+  // Jede Stufe jeder Variante ist eine eigene Aufgabe; die groessten zuerst, damit die Threads gleichmaessig ausgelastet sind
+  std::vector<std::pair<size_t, size_t>> aufgaben;
+  for (size_t stufe = 0; ; ++stufe) {
+    const size_t anzahl_vorher = aufgaben.size();
+    for (size_t a = 0; a < auftraege.size(); ++a) {
+      if (stufe < auftraege[a].stufen.size()) {
+        aufgaben.emplace_back(a, stufe);
+      }
+    }
+    if (aufgaben.size() == anzahl_vorher) {
+      break;
+    }
+  }
+
+  if (anzahl_threads == 0) {
+    anzahl_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  anzahl_threads = std::min(anzahl_threads, aufgaben.size());
+
+  std::atomic<size_t> naechste_aufgabe { 0 };
+  auto Kodierer = [&]() {
+    while (true) {
+      const size_t idx = naechste_aufgabe++;
+      if (idx >= aufgaben.size()) {
+        break;
+      }
+      const auto [a, stufe] = aufgaben[idx];
+      auftraege[a].kodiert[stufe] = KodiereStufe(auftraege[a], stufe, kodierer);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < anzahl_threads; ++i) {
+    threads.emplace_back(Kodierer);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int result = 0;
+  for (const auto& auftrag : auftraege) {
+    FILE* fd = fopen(auftrag.ziel.c_str(), "wb");
+    bool ok = fd != nullptr && SchreibeDds(fd, auftrag.stufen[0].breite, auftrag.stufen[0].hoehe, auftrag.kodiert);
+    if (fd != nullptr) {
+      ok = (fclose(fd) == 0) && ok;
+    }
+    if (!ok) {
+      fprintf(stderr, "%s: Schreiben fehlgeschlagen\n", auftrag.ziel.c_str());
+      result = 1;
+    } else {
+      printf("%s: %dx%d, %zu Mip-Stufen (%s)\n", auftrag.ziel.c_str(), auftrag.stufen[0].breite, auftrag.stufen[0].hoehe,
+          auftrag.stufen.size(), (kodierer == BlockKodierer::kSimd && SimdVerfuegbar()) ? "SSE2" : "skalar");
+    }
+  }
+  return result;
+}
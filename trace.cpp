@@ -0,0 +1,187 @@
+// Copyright 2026 Zusitools
+
+#include "trace.hpp"
+
+#include "allokationen.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Uhr = std::chrono::steady_clock;
+
+struct Ereignis final {
+  const char* name;
+  char phase;  ///< 'B', 'E' oder 'C' (Zaehler)
+  int64_t zeit_ns;
+  char detail[64];
+  const char* reihe[2];  ///< nur fuer Zaehler
+  double wert[2];
+};
+
+// Ereignisse eines Threads. Bleibt nach dem Ende des Threads bis zum naechsten SchreibeTrace() erhalten.
+struct ThreadPuffer final {
+  uint32_t tid;
+  std::string name;
+  std::mutex mutex;  // praktisch unumkaempft, nur SchreibeTrace() greift von aussen zu
+  std::vector<Ereignis> ereignisse;
+};
+
+std::atomic<bool> g_aktiv { false };
+Uhr::time_point g_start;
+
+std::mutex g_puffer_mutex;
+std::vector<std::unique_ptr<ThreadPuffer>> g_puffer;
+std::atomic<uint64_t> g_generation { 0 };  // wird bei SchreibeTrace() erhoeht, damit Threads neue Puffer anlegen
+
+ThreadPuffer* EigenerPuffer() {
+  thread_local ThreadPuffer* puffer = nullptr;
+  thread_local uint64_t generation = 0;
+  thread_local uint32_t tid = 0;
+
+  if (puffer == nullptr || generation != g_generation.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(g_puffer_mutex);
+    static uint32_t naechste_tid = 1;
+    if (tid == 0) {
+      tid = naechste_tid++;
+    }
+    g_puffer.push_back(std::make_unique<ThreadPuffer>());
+    puffer = g_puffer.back().get();
+    puffer->tid = tid;
+    generation = g_generation.load(std::memory_order_relaxed);
+  }
+  return puffer;
+}
+
+Ereignis NeuesEreignis(const char* name, char phase) {
+  return { name, phase, std::chrono::duration_cast<std::chrono::nanoseconds>(Uhr::now() - g_start).count(), {}, {}, {} };
+}
+
+void Zeichne(const Ereignis& ereignis) {
+  ThreadPuffer* puffer = EigenerPuffer();
+  std::lock_guard<std::mutex> lock(puffer->mutex);
+  puffer->ereignisse.push_back(ereignis);
+}
+
+void Zeichne(const char* name, char phase, const char* detail) {
+  auto ereignis = NeuesEreignis(name, phase);
+  if (detail != nullptr) {
+    strncpy(ereignis.detail, detail, sizeof(ereignis.detail) - 1);
+  }
+  Zeichne(ereignis);
+}
+
+void SchreibeJsonString(Ausgabe* ausgabe, const char* text) {
+  ausgabe->SchreibeLiteral("\"");
+  for (const char* c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      ausgabe->SchreibeLiteral("\\");
+    }
+    if (static_cast<unsigned char>(*c) >= 0x20) {
+      ausgabe->Schreibe(c, 1);
+    }
+  }
+  ausgabe->SchreibeLiteral("\"");
+}
+
+}  // namespace
+
+void StarteTrace() {
+  g_start = Uhr::now();
+  g_aktiv = true;
+}
+
+bool TraceAktiv() {
+  return g_aktiv.load(std::memory_order_relaxed);
+}
+
+void BenenneTraceThread(const char* name) {
+  if (!TraceAktiv()) {
+    return;
+  }
+  ThreadPuffer* puffer = EigenerPuffer();
+  std::lock_guard<std::mutex> lock(puffer->mutex);
+  puffer->name = name;
+}
+
+void TraceZaehler(const char* name, const char* reihe1, double wert1, const char* reihe2, double wert2) {
+  if (!TraceAktiv()) {
+    return;
+  }
+  auto ereignis = NeuesEreignis(name, 'C');
+  ereignis.reihe[0] = reihe1;
+  ereignis.wert[0] = wert1;
+  ereignis.reihe[1] = reihe2;
+  ereignis.wert[1] = wert2;
+  Zeichne(ereignis);
+}
+
+void SchreibeTrace(Ausgabe* ausgabe) {
+  std::lock_guard<std::mutex> lock(g_puffer_mutex);
+
+  ausgabe->SchreibeLiteral("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool erstes = true;
+  auto Trenner = [&]() {
+    if (!erstes) {
+      ausgabe->SchreibeLiteral(",\n");
+    }
+    erstes = false;
+  };
+
+  for (const auto& puffer : g_puffer) {
+    std::lock_guard<std::mutex> puffer_lock(puffer->mutex);
+    if (!puffer->name.empty()) {
+      Trenner();
+      ausgabe->SchreibeFormatiert("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", puffer->tid);
+      SchreibeJsonString(ausgabe, puffer->name.c_str());
+      ausgabe->SchreibeLiteral("}}");
+    }
+    for (const auto& ereignis : puffer->ereignisse) {
+      Trenner();
+      ausgabe->SchreibeFormatiert("{\"name\":\"%s\",\"cat\":\"hekto\",\"ph\":\"%c\",\"ts\":%lld.%03d,\"pid\":1,\"tid\":%u",
+          ereignis.name, ereignis.phase, static_cast<long long>(ereignis.zeit_ns / 1000),
+          static_cast<int>(ereignis.zeit_ns % 1000), puffer->tid);
+      if (ereignis.phase == 'C') {
+        ausgabe->SchreibeFormatiert(",\"args\":{\"%s\":%g", ereignis.reihe[0], ereignis.wert[0]);
+        if (ereignis.reihe[1] != nullptr) {
+          ausgabe->SchreibeFormatiert(",\"%s\":%g", ereignis.reihe[1], ereignis.wert[1]);
+        }
+        ausgabe->SchreibeLiteral("}");
+      } else if (ereignis.detail[0] != '\0') {
+        ausgabe->SchreibeLiteral(",\"args\":{\"detail\":");
+        SchreibeJsonString(ausgabe, ereignis.detail);
+        ausgabe->SchreibeLiteral("}");
+      }
+      ausgabe->SchreibeLiteral("}");
+    }
+  }
+  ausgabe->SchreibeLiteral("\n]}\n");
+
+  g_puffer.clear();
+  g_generation.fetch_add(1, std::memory_order_release);
+}
+
+TraceBereich::TraceBereich(const char* name, const char* detail)
+    : name_(name), vorheriger_bereich_(BetreteAllokationsBereich(name)), aufgezeichnet_(TraceAktiv()) {
+  if (aufgezeichnet_) {
+    Zeichne(name_, 'B', detail);
+  }
+}
+
+void TraceBereich::Beende() {
+  if (name_ == nullptr) {
+    return;
+  }
+  VerlasseAllokationsBereich(vorheriger_bereich_);
+  if (aufgezeichnet_) {
+    Zeichne(name_, 'E', nullptr);
+  }
+  name_ = nullptr;
+}
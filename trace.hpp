@@ -0,0 +1,52 @@
+// Copyright 2026 Zusitools
+
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include "ausgabe.hpp"
+
+/**
+ * Optionale Aufzeichnung von Begin-/End-Ereignissen pro Thread im Chrome-Trace-Format
+ * (chrome://tracing, ui.perfetto.dev). Standardmaessig deaktiviert; ein TraceBereich
+ * kostet dann nur das Lesen eines atomaren Flags und das Setzen des aktuellen Bereichs
+ * fuer die Allokationszaehlung (allokationen.hpp).
+ */
+
+// Beginnt die Aufzeichnung. Zeitstempel werden relativ zu diesem Zeitpunkt angegeben.
+void StarteTrace();
+
+bool TraceAktiv();
+
+// Name, unter dem der aufrufende Thread in der Zeitleiste erscheint.
+void BenenneTraceThread(const char* name);
+
+// Zeichnet einen Zaehler-Wert mit bis zu zwei Reihen auf (in der Zeitleiste als Diagramm dargestellt).
+// `name` und `reihe*` muessen Stringliterale sein.
+void TraceZaehler(const char* name, const char* reihe1, double wert1, const char* reihe2 = nullptr, double wert2 = 0);
+
+// Schreibt alle bisher aufgezeichneten Ereignisse als JSON und verwirft sie.
+// Darf erst aufgerufen werden, wenn keine Bereiche mehr offen sind.
+void SchreibeTrace(Ausgabe* ausgabe);
+
+/**
+ * Zeichnet fuer die Lebensdauer des Objekts (oder bis Beende()) einen Bereich auf.
+ * `name` muss ein Stringliteral sein; `detail` wird kopiert und ggf. gekuerzt.
+ * Bereiche eines Threads muessen in umgekehrter Reihenfolge beendet werden, in der sie begonnen wurden.
+ */
+class TraceBereich final {
+ public:
+  explicit TraceBereich(const char* name, const char* detail = nullptr);
+  ~TraceBereich() { Beende(); }
+
+  TraceBereich(const TraceBereich&) = delete;
+  TraceBereich& operator=(const TraceBereich&) = delete;
+
+  void Beende();
+
+ private:
+  const char* name_;  ///< nullptr nach Beende()
+  const char* vorheriger_bereich_;  ///< fuer die Allokationszaehlung
+  bool aufgezeichnet_;  ///< Beginn steht im Trace
+};
+
+#endif  // TRACE_HPP_
@@ -0,0 +1,226 @@
+// Copyright 2026 Zusitools
+
+#include "vertex_cache.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Parameter nach Forsyth. Das Verfahren modelliert einen LRU-Cache,
+// der etwas groesser sein darf als der tatsaechliche Cache.
+constexpr size_t kModellCacheGroesse = 32;
+constexpr float kCacheZerfall = 1.5f;
+constexpr float kLetztesDreieckScore = 0.75f;
+constexpr float kValenzSkalierung = 2.0f;
+constexpr float kValenzExponent = -0.5f;
+
+float VertexScore(int cache_position, uint32_t verbleibende_faces) {
+  if (verbleibende_faces == 0) {
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_position >= 0) {
+    if (cache_position < 3) {
+      // Die Vertices des zuletzt gezeichneten Dreiecks werden absichtlich schlechter bewertet,
+      // damit keine langen, duennen Streifen entstehen.
+      score = kLetztesDreieckScore;
+    } else {
+      const float skalierung = 1.0f / (kModellCacheGroesse - 3);
+      score = std::pow(1.0f - (cache_position - 3) * skalierung, kCacheZerfall);
+    }
+  }
+
+  // Vertices mit wenigen verbleibenden Faces bevorzugen, damit keine einzelnen Dreiecke uebrig bleiben
+  score += kValenzSkalierung * std::pow(static_cast<float>(verbleibende_faces), kValenzExponent);
+  return score;
+}
+
+std::atomic<uint64_t> g_anzahl_faces { 0 };
+std::atomic<uint64_t> g_anzahl_vertices { 0 };
+std::atomic<uint64_t> g_fehlgriffe_vorher { 0 };
+std::atomic<uint64_t> g_fehlgriffe_nachher { 0 };
+
+}  // namespace
+
+size_t ZaehleCacheFehlgriffe(const Mesh& mesh) {
+  std::array<VertexIndex, kVertexCacheGroesse> cache;
+  cache.fill(std::numeric_limits<VertexIndex>::max());
+  size_t naechste_position = 0;
+
+  size_t result = 0;
+  for (const auto& face : mesh.faces) {
+    for (const auto idx : { face.i1, face.i2, face.i3 }) {
+      if (std::find(std::cbegin(cache), std::cend(cache), idx) == std::cend(cache)) {
+        ++result;
+        cache[naechste_position] = idx;
+        naechste_position = (naechste_position + 1) % cache.size();
+      }
+    }
+  }
+  return result;
+}
+
+void OptimiereVertexCache(Mesh* mesh) {
+  const size_t anzahl_vertices = mesh->vertices.size();
+  const size_t anzahl_faces = mesh->faces.size();
+  if (anzahl_faces == 0) {
+    return;
+  }
+
+  TraceBereich bereich("Vertex-Cache");
+  const size_t fehlgriffe_vorher = ZaehleCacheFehlgriffe(*mesh);
+
+  // Faces pro Vertex
+  std::vector<uint32_t> verbleibend(anzahl_vertices, 0);
+  for (const auto& face : mesh->faces) {
+    ++verbleibend[face.i1];
+    ++verbleibend[face.i2];
+    ++verbleibend[face.i3];
+  }
+  std::vector<uint32_t> adjazenz_beginn(anzahl_vertices + 1, 0);
+  for (size_t v = 0; v < anzahl_vertices; ++v) {
+    adjazenz_beginn[v + 1] = adjazenz_beginn[v] + verbleibend[v];
+  }
+  std::vector<uint32_t> adjazenz(adjazenz_beginn.back());
+  {
+    auto schreibposition = adjazenz_beginn;
+    for (size_t f = 0; f < anzahl_faces; ++f) {
+      const auto& face = mesh->faces[f];
+      for (const auto idx : { face.i1, face.i2, face.i3 }) {
+        adjazenz[schreibposition[idx]++] = static_cast<uint32_t>(f);
+      }
+    }
+  }
+
+  std::vector<int> cache_position(anzahl_vertices, -1);
+  std::vector<float> vertex_score(anzahl_vertices);
+  for (size_t v = 0; v < anzahl_vertices; ++v) {
+    vertex_score[v] = VertexScore(-1, verbleibend[v]);
+  }
+
+  auto FaceScore = [&](const Face& face) {
+    return vertex_score[face.i1] + vertex_score[face.i2] + vertex_score[face.i3];
+  };
+
+  std::vector<bool> gezeichnet(anzahl_faces, false);
+  std::vector<Face> neue_faces;
+  neue_faces.reserve(anzahl_faces);
+
+  std::vector<VertexIndex> cache;
+  std::vector<VertexIndex> neuer_cache;
+  cache.reserve(kModellCacheGroesse + 3);
+  neuer_cache.reserve(kModellCacheGroesse + 3);
+
+  size_t bestes_face = anzahl_faces;
+  size_t erstes_ungezeichnetes = 0;
+  while (neue_faces.size() < anzahl_faces) {
+    if (bestes_face == anzahl_faces) {
+      // Kein Kandidat im Cache: mit dem naechsten Face in der urspruenglichen Reihenfolge fortfahren.
+      // Eine Suche ueber alle verbleibenden Faces waere bei Meshes aus vielen getrennten Teilen
+      // (z.B. Sammeldateien) quadratisch.
+      while (gezeichnet[erstes_ungezeichnetes]) {
+        ++erstes_ungezeichnetes;
+      }
+      bestes_face = erstes_ungezeichnetes;
+    }
+
+    const Face face = mesh->faces[bestes_face];
+    gezeichnet[bestes_face] = true;
+    neue_faces.push_back(face);
+
+    neuer_cache.clear();
+    for (const auto idx : { face.i1, face.i2, face.i3 }) {
+      --verbleibend[idx];
+      neuer_cache.push_back(idx);
+    }
+    for (const auto idx : cache) {
+      if (idx != face.i1 && idx != face.i2 && idx != face.i3) {
+        neuer_cache.push_back(idx);
+      }
+    }
+
+    // Neue Cache-Positionen; herausgefallene Vertices verlieren ihren Cache-Bonus
+    for (size_t i = 0; i < neuer_cache.size(); ++i) {
+      const auto idx = neuer_cache[i];
+      cache_position[idx] = i < kModellCacheGroesse ? static_cast<int>(i) : -1;
+      vertex_score[idx] = VertexScore(cache_position[idx], verbleibend[idx]);
+    }
+
+    // Naechstes Face unter den Nachbarn der Vertices im Cache suchen
+    bestes_face = anzahl_faces;
+    float bester_score = -std::numeric_limits<float>::max();
+    for (const auto idx : neuer_cache) {
+      for (uint32_t i = adjazenz_beginn[idx]; i < adjazenz_beginn[idx + 1]; ++i) {
+        const auto f = adjazenz[i];
+        if (!gezeichnet[f] && FaceScore(mesh->faces[f]) > bester_score) {
+          bester_score = FaceScore(mesh->faces[f]);
+          bestes_face = f;
+        }
+      }
+    }
+
+    cache.assign(std::cbegin(neuer_cache), std::cbegin(neuer_cache) + std::min(neuer_cache.size(), kModellCacheGroesse));
+  }
+
+  // Vertices in der Reihenfolge ihrer ersten Verwendung nummerieren
+  constexpr VertexIndex kOhneIndex = std::numeric_limits<VertexIndex>::max();
+  std::vector<VertexIndex> neuer_index(anzahl_vertices, kOhneIndex);
+  std::vector<Vertex> neue_vertices;
+  neue_vertices.reserve(anzahl_vertices);
+  auto NeuerIndex = [&](VertexIndex idx) {
+    if (neuer_index[idx] == kOhneIndex) {
+      neuer_index[idx] = neue_vertices.size();
+      neue_vertices.push_back(mesh->vertices[idx]);
+    }
+    return neuer_index[idx];
+  };
+  for (auto& face : neue_faces) {
+    face = Face(NeuerIndex(face.i1), NeuerIndex(face.i2), NeuerIndex(face.i3));
+  }
+  for (VertexIndex idx = 0; idx < anzahl_vertices; ++idx) {
+    NeuerIndex(idx);  // unbenutzte Vertices ans Ende
+  }
+
+  std::swap(mesh->vertices, neue_vertices);
+  std::swap(mesh->faces, neue_faces);
+
+  size_t fehlgriffe_nachher = ZaehleCacheFehlgriffe(*mesh);
+  if (fehlgriffe_nachher > fehlgriffe_vorher) {
+    // Bei sehr kleinen Meshes kann die urspruengliche Reihenfolge schon besser sein
+    std::swap(mesh->vertices, neue_vertices);
+    std::swap(mesh->faces, neue_faces);
+    fehlgriffe_nachher = fehlgriffe_vorher;
+  }
+
+  g_anzahl_faces += anzahl_faces;
+  g_anzahl_vertices += anzahl_vertices;
+  g_fehlgriffe_vorher += fehlgriffe_vorher;
+  g_fehlgriffe_nachher += fehlgriffe_nachher;
+  TraceZaehler("ACMR", "vorher", static_cast<double>(fehlgriffe_vorher) / anzahl_faces,
+      "nachher", static_cast<double>(fehlgriffe_nachher) / anzahl_faces);
+}
+
+VertexCacheStatistik HoleVertexCacheStatistik() {
+  VertexCacheStatistik result;
+  result.anzahl_faces = g_anzahl_faces;
+  result.anzahl_vertices = g_anzahl_vertices;
+  result.fehlgriffe_vorher = g_fehlgriffe_vorher;
+  result.fehlgriffe_nachher = g_fehlgriffe_nachher;
+  return result;
+}
+
+void SetzeVertexCacheStatistikZurueck() {
+  g_anzahl_faces = 0;
+  g_anzahl_vertices = 0;
+  g_fehlgriffe_vorher = 0;
+  g_fehlgriffe_nachher = 0;
+}
@@ -0,0 +1,44 @@
+// Copyright 2026 Zusitools
+
+#ifndef VERTEX_CACHE_HPP_
+#define VERTEX_CACHE_HPP_
+
+#include "mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Groesse des FIFO-Caches, mit dem die Cache-Trefferquote gemessen wird (typischer Post-Transform-Cache).
+constexpr size_t kVertexCacheGroesse = 16;
+
+/**
+ * Ordnet die Faces nach dem Verfahren von Forsyth ("Linear-Speed Vertex Cache Optimisation")
+ * so um, dass aufeinanderfolgende Faces moeglichst viele Vertices gemeinsam haben, und nummeriert
+ * die Vertices anschliessend in der Reihenfolge ihrer ersten Verwendung.
+ * Geometrie und Umlaufsinn der Faces bleiben unveraendert.
+ */
+void OptimiereVertexCache(Mesh* mesh);
+
+// Anzahl Cache-Fehlgriffe beim Zeichnen der Faces in ihrer Reihenfolge (FIFO-Cache der Groesse kVertexCacheGroesse).
+size_t ZaehleCacheFehlgriffe(const Mesh& mesh);
+
+/**
+ * Ueber alle bisher optimierten Meshes aufsummierte Fehlgriffe, threadsicher.
+ * ACMR (average cache miss ratio) = Fehlgriffe / Faces.
+ */
+struct VertexCacheStatistik final {
+  uint64_t anzahl_faces = 0;
+  uint64_t anzahl_vertices = 0;
+  uint64_t fehlgriffe_vorher = 0;
+  uint64_t fehlgriffe_nachher = 0;
+
+  double AcmrVorher() const { return anzahl_faces == 0 ? 0 : static_cast<double>(fehlgriffe_vorher) / anzahl_faces; }
+  double AcmrNachher() const { return anzahl_faces == 0 ? 0 : static_cast<double>(fehlgriffe_nachher) / anzahl_faces; }
+  // Untere Schranke: jeder Vertex muss mindestens einmal transformiert werden
+  double AcmrMinimum() const { return anzahl_faces == 0 ? 0 : static_cast<double>(anzahl_vertices) / anzahl_faces; }
+};
+
+VertexCacheStatistik HoleVertexCacheStatistik();
+void SetzeVertexCacheStatistikZurueck();
+
+#endif  // VERTEX_CACHE_HPP_
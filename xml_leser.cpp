@@ -0,0 +1,203 @@
+// Copyright 2026 Zusitools
+
+#include "xml_leser.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool IstLeerzeichen(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view OhneLeerzeichen(std::string_view text) {
+  while (!text.empty() && IstLeerzeichen(text.front())) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && IstLeerzeichen(text.back())) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+}  // namespace
+
+XmlLeser::XmlLeser(FILE* fd, size_t puffergroesse) : fd_(fd), puffer_(puffergroesse) { }
+
+bool XmlLeser::FuellePuffer() {
+  if (anfang_ > 0) {
+    std::memmove(puffer_.data(), puffer_.data() + anfang_, ende_ - anfang_);
+    ende_ -= anfang_;
+    anfang_ = 0;
+  }
+  if (dateiende_ || ende_ == puffer_.size()) {
+    return false;
+  }
+  const size_t gelesen = fread(puffer_.data() + ende_, 1, puffer_.size() - ende_, fd_);
+  if (gelesen == 0) {
+    dateiende_ = true;
+    return false;
+  }
+  ende_ += gelesen;
+  gelesene_bytes_ += gelesen;
+  return true;
+}
+
+size_t XmlLeser::Suche(std::string_view muster, size_t pos) {
+  while (true) {
+    const std::string_view daten(puffer_.data() + anfang_, ende_ - anfang_);
+    const auto gefunden = daten.find(muster, pos);
+    if (gefunden != std::string_view::npos) {
+      return gefunden;
+    }
+    if (daten.size() >= muster.size()) {
+      pos = std::max(pos, daten.size() - muster.size() + 1);
+    }
+    if (!FuellePuffer()) {
+      return std::string_view::npos;
+    }
+  }
+}
+
+XmlLeser::Ereignis XmlLeser::Fehlschlag(std::string fehler) {
+  fehler_ = std::move(fehler) + " (nach " + std::to_string(gelesene_bytes_ - (ende_ - anfang_)) + " Bytes)";
+  return Ereignis::kFehler;
+}
+
+std::optional<std::string_view> XmlLeser::Attribut(std::string_view name) const {
+  for (const auto& [attribut_name, wert] : attribute_) {
+    if (attribut_name == name) {
+      return wert;
+    }
+  }
+  return std::nullopt;
+}
+
+XmlLeser::Ereignis XmlLeser::Naechstes() {
+  attribute_.clear();
+  if (ende_ausstehend_) {
+    ende_ausstehend_ = false;
+    name_ = ende_name_;
+    --tiefe_;
+    return Ereignis::kEnde;
+  }
+
+  while (true) {
+    // Text bis zum naechsten Tag ueberspringen
+    while (true) {
+      const void* tag = std::memchr(puffer_.data() + anfang_, '<', ende_ - anfang_);
+      if (tag != nullptr) {
+        anfang_ = static_cast<const char*>(tag) - puffer_.data();
+        break;
+      }
+      anfang_ = ende_;
+      if (!FuellePuffer()) {
+        return tiefe_ == 0 ? Ereignis::kDateiende : Fehlschlag("unerwartetes Dateiende");
+      }
+    }
+
+    while (ende_ - anfang_ < 9 && FuellePuffer()) { }
+    const std::string_view daten(puffer_.data() + anfang_, ende_ - anfang_);
+
+    std::string_view ende_muster;
+    if (daten.substr(0, 4) == "<!--") {
+      ende_muster = "-->";
+    } else if (daten.substr(0, 9) == "<![CDATA[") {
+      ende_muster = "]]>";
+    } else if (daten.substr(0, 2) == "<?") {
+      ende_muster = "?>";
+    } else if (daten.substr(0, 2) == "<!") {
+      ende_muster = ">";
+    }
+
+    if (!ende_muster.empty()) {
+      const size_t pos = Suche(ende_muster, 2);
+      if (pos == std::string_view::npos) {
+        return Fehlschlag(dateiende_ ? "unerwartetes Dateiende" : "Kommentar oder CDATA groesser als der Lesepuffer");
+      }
+      anfang_ += pos + ende_muster.size();
+      continue;
+    }
+
+    // Ende des Tags; '>' in Attributwerten zaehlt nicht
+    char anfuehrungszeichen = 0;
+    for (size_t pos = 1; ; ++pos) {
+      if (anfang_ + pos == ende_ && !FuellePuffer()) {
+        return Fehlschlag(dateiende_ ? "unerwartetes Dateiende" : "Tag groesser als der Lesepuffer");
+      }
+      const char c = puffer_[anfang_ + pos];
+      if (anfuehrungszeichen != 0) {
+        if (c == anfuehrungszeichen) {
+          anfuehrungszeichen = 0;
+        }
+      } else if (c == '"' || c == '\'') {
+        anfuehrungszeichen = c;
+      } else if (c == '>') {
+        return LiesTag(pos + 1);
+      }
+    }
+  }
+}
+
+XmlLeser::Ereignis XmlLeser::LiesTag(size_t laenge) {
+  std::string_view inhalt(puffer_.data() + anfang_ + 1, laenge - 2);
+  anfang_ += laenge;
+
+  if (!inhalt.empty() && inhalt.front() == '/') {
+    if (tiefe_ == 0) {
+      return Fehlschlag("Ende-Tag ohne Start-Tag");
+    }
+    name_ = OhneLeerzeichen(inhalt.substr(1));
+    --tiefe_;
+    return Ereignis::kEnde;
+  }
+
+  const bool leer = !inhalt.empty() && inhalt.back() == '/';
+  if (leer) {
+    inhalt.remove_suffix(1);
+  }
+
+  size_t pos = 0;
+  while (pos < inhalt.size() && !IstLeerzeichen(inhalt[pos])) {
+    ++pos;
+  }
+  name_ = inhalt.substr(0, pos);
+  if (name_.empty()) {
+    return Fehlschlag("Tag ohne Namen");
+  }
+
+  while (true) {
+    while (pos < inhalt.size() && IstLeerzeichen(inhalt[pos])) {
+      ++pos;
+    }
+    if (pos == inhalt.size()) {
+      break;
+    }
+    const size_t gleich = inhalt.find('=', pos);
+    if (gleich == std::string_view::npos) {
+      return Fehlschlag("Attribut ohne Wert in <" + std::string(name_) + ">");
+    }
+    const auto attribut_name = OhneLeerzeichen(inhalt.substr(pos, gleich - pos));
+    pos = gleich + 1;
+    while (pos < inhalt.size() && IstLeerzeichen(inhalt[pos])) {
+      ++pos;
+    }
+    if (pos == inhalt.size() || (inhalt[pos] != '"' && inhalt[pos] != '\'')) {
+      return Fehlschlag("Attributwert ohne Anfuehrungszeichen in <" + std::string(name_) + ">");
+    }
+    const size_t wert_ende = inhalt.find(inhalt[pos], pos + 1);
+    if (wert_ende == std::string_view::npos) {
+      return Fehlschlag("Attributwert ohne Ende in <" + std::string(name_) + ">");
+    }
+    attribute_.emplace_back(attribut_name, inhalt.substr(pos + 1, wert_ende - pos - 1));
+    pos = wert_ende + 1;
+  }
+
+  ++tiefe_;
+  if (leer) {
+    ende_name_ = name_;
+    ende_ausstehend_ = true;
+  }
+  return Ereignis::kStart;
+}
@@ -0,0 +1,73 @@
+// Copyright 2026 Zusitools
+
+#ifndef XML_LESER_HPP_
+#define XML_LESER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Liest eine XML-Datei stueckweise durch einen Puffer fester Groesse, sodass auch sehr grosse
+ * Dateien mit konstantem Speicherbedarf verarbeitet werden koennen. Liefert nur Start- und
+ * Ende-Ereignisse; Text, Kommentare, CDATA, Verarbeitungsanweisungen und DOCTYPE werden uebersprungen.
+ * Entitaeten in Attributwerten werden nicht aufgeloest. Die Wohlgeformtheit wird nicht geprueft.
+ */
+class XmlLeser final {
+ public:
+  enum class Ereignis {
+    kStart,  ///< Start-Tag; bei <a/> folgt direkt kEnde
+    kEnde,
+    kDateiende,
+    kFehler,
+  };
+
+  // Ein einzelnes Tag darf nicht groesser als `puffergroesse` sein.
+  explicit XmlLeser(FILE* fd, size_t puffergroesse = 1 << 20);
+
+  Ereignis Naechstes();
+
+  // Name des aktuellen Elements, gueltig bis zum naechsten Aufruf von Naechstes().
+  std::string_view Name() const { return name_; }
+
+  // Attributwert des aktuellen Start-Tags, gueltig bis zum naechsten Aufruf von Naechstes().
+  std::optional<std::string_view> Attribut(std::string_view name) const;
+
+  // Anzahl offener Elemente einschliesslich des aktuellen Start-Tags.
+  size_t Tiefe() const { return tiefe_; }
+
+  uint64_t GeleseneBytes() const { return gelesene_bytes_; }
+  const std::string& Fehler() const { return fehler_; }
+
+ private:
+  // Liest weitere Daten in den Puffer nach; verschiebt dazu den ungelesenen Rest an den Anfang.
+  bool FuellePuffer();
+
+  // Sucht `muster` ab `pos` im ungelesenen Teil des Puffers und liest bei Bedarf nach.
+  // Gibt die Position relativ zu anfang_ oder std::string_view::npos zurueck.
+  size_t Suche(std::string_view muster, size_t pos);
+
+  Ereignis Fehlschlag(std::string fehler);
+  Ereignis LiesTag(size_t laenge);
+
+  FILE* fd_;
+  std::vector<char> puffer_;
+  size_t anfang_ = 0;  ///< erstes ungelesenes Zeichen
+  size_t ende_ = 0;
+  bool dateiende_ = false;
+  uint64_t gelesene_bytes_ = 0;
+
+  std::string_view name_;
+  std::string ende_name_;  ///< Name fuer das kEnde-Ereignis nach einem leeren Element
+  bool ende_ausstehend_ = false;
+  std::vector<std::pair<std::string_view, std::string_view>> attribute_;
+  size_t tiefe_ = 0;
+  std::string fehler_;
+};
+
+#endif  // XML_LESER_HPP_
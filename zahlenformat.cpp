@@ -0,0 +1,135 @@
+// Copyright 2026 Zusitools
+
+#include "zahlenformat.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Schreibt `wert` mit genau `stellen` Nachkommastellen (Festkomma zur Basis 10).
+// Mit `kuerzen` ohne Nullen am Ende der Nachkommastellen, ohne Dezimalpunkt bei ganzen Zahlen und
+// ohne Vorzeichen bei 0.
+char* FormatFestkomma(char* out, bool negativ, uint64_t wert, int stellen, bool kuerzen = false) {
+  char puffer[32];
+  char* ende = puffer + sizeof(puffer);
+  char* p = ende;
+  int i = 0;
+  if (kuerzen) {
+    negativ = negativ && wert != 0;
+    for (; i < stellen && wert % 10 == 0; ++i) {
+      wert /= 10;
+    }
+  }
+  if (i < stellen) {
+    for (; i < stellen; ++i) {
+      *--p = static_cast<char>('0' + wert % 10);
+      wert /= 10;
+    }
+    *--p = '.';
+  }
+  do {
+    *--p = static_cast<char>('0' + wert % 10);
+    wert /= 10;
+  } while (wert != 0);
+  if (negativ) {
+    *--p = '-';
+  }
+  while (p != ende) {
+    *out++ = *p++;
+  }
+  return out;
+}
+
+// Entfernt Nullen am Ende der Nachkommastellen von [anfang, ende) und ggf. den Dezimalpunkt.
+// Nur fuer Zahlen, die nicht mit FormatFestkomma geschrieben wurden.
+char* KuerzeNachkommastellen(char* anfang, char* ende) {
+  const char* punkt = anfang;
+  while (punkt != ende && *punkt != '.') {
+    ++punkt;
+  }
+  if (punkt == ende) {
+    return ende;
+  }
+  while (ende[-1] == '0') {
+    --ende;
+  }
+  if (ende[-1] == '.') {
+    --ende;
+  }
+  if (ende - anfang == 2 && anfang[0] == '-' && anfang[1] == '0') {
+    anfang[0] = '0';
+    --ende;
+  }
+  return ende;
+}
+
+}  // namespace
+
+char* FormatGanzzahl(char* out, uint64_t wert) {
+  char puffer[20];
+  char* p = puffer + sizeof(puffer);
+  do {
+    *--p = static_cast<char>('0' + wert % 10);
+    wert /= 10;
+  } while (wert != 0);
+  while (p != puffer + sizeof(puffer)) {
+    *out++ = *p++;
+  }
+  return out;
+}
+
+char* FormatKoordinate(char* out, Koordinate wert) {
+  static_assert(kKoordinateProMeter == 1000000, "FormatKoordinate geht von Mikrometern aus");
+  const bool negativ = wert < 0;
+  const uint64_t betrag = negativ ? -static_cast<int64_t>(wert) : wert;
+  return FormatFestkomma(out, negativ, betrag, 6);
+}
+
+char* FormatFloat(char* out, float wert) {
+  // float hat 24 Bit Mantisse, 10^6 = 15625 * 2^6 hat 14 signifikante Bits:
+  // Das Produkt ist als double exakt darstellbar, das Runden (half-to-even)
+  // entspricht damit genau dem von printf.
+  constexpr double kMaxExakt = 1e12;
+  const double skaliert = std::fabs(static_cast<double>(wert)) * 1e6;
+  if (!(skaliert < kMaxExakt)) {
+    const int laenge = snprintf(out, kMaxFloatLaenge, "%f", wert);
+    assert(laenge >= 0 && static_cast<size_t>(laenge) < kMaxFloatLaenge);
+    return out + laenge;
+  }
+  return FormatFestkomma(out, std::signbit(wert), static_cast<uint64_t>(std::nearbyint(skaliert)), 6);
+}
+
+char* FormatKoordinateKompakt(char* out, Koordinate wert) {
+  const bool negativ = wert < 0;
+  const uint64_t betrag = negativ ? -static_cast<int64_t>(wert) : wert;
+  return FormatFestkomma(out, negativ, betrag, 6, true);
+}
+
+char* FormatFloatKompakt(char* out, float wert) {
+  constexpr double kMaxExakt = 1e12;
+  const double skaliert = std::fabs(static_cast<double>(wert)) * 1e6;
+  if (!(skaliert < kMaxExakt)) {
+    return KuerzeNachkommastellen(out, FormatFloat(out, wert));
+  }
+  return FormatFestkomma(out, std::signbit(wert), static_cast<uint64_t>(std::nearbyint(skaliert)), 6, true);
+}
+
+char* FormatKoordinateMm(char* out, Koordinate wert) {
+  const bool negativ = wert < 0;
+  const uint64_t betrag = negativ ? -static_cast<int64_t>(wert) : wert;
+  return FormatFestkomma(out, negativ, (betrag + kKoordinateProMm / 2) / kKoordinateProMm, 3, true);
+}
+
+char* FormatFloatQuantisiert(char* out, float wert) {
+  constexpr double kMaxExakt = 1e12;
+  const double schritte = std::nearbyint(std::fabs(static_cast<double>(wert)) * kQuantisierungsSchritte);
+  if (!(schritte < kMaxExakt)) {
+    return FormatFloatKompakt(out, wert);
+  }
+  // Ganzzahlig gerundet: Schritte * 10^4 / 4096 = Schritte * 625 / 256
+  static_assert(kQuantisierungsSchritte == 4096, "Umrechnung geht von 4096 Schritten aus");
+  const uint64_t zehntausendstel = (static_cast<uint64_t>(schritte) * 625 + 128) / 256;
+  return FormatFestkomma(out, std::signbit(wert), zehntausendstel, 4, true);
+}
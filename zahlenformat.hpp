@@ -0,0 +1,45 @@
+// Copyright 2026 Zusitools
+
+#ifndef ZAHLENFORMAT_HPP_
+#define ZAHLENFORMAT_HPP_
+
+#include "mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/* Schnelle Zahlenformatierung fuer die Ausgabe.
+ *
+ * Alle Funktionen schreiben ohne abschliessendes Nullzeichen nach `out`
+ * und geben einen Zeiger hinter das letzte geschriebene Zeichen zurueck.
+ */
+
+// Maximale Laenge einer mit FormatFloat formatierten Zahl.
+constexpr size_t kMaxFloatLaenge = 48;
+
+// Ganzzahl in Dezimaldarstellung.
+char* FormatGanzzahl(char* out, uint64_t wert);
+
+// Koordinate in Metern mit 6 Nachkommastellen. Exakt, da reine Ganzzahlarithmetik.
+char* FormatKoordinate(char* out, Koordinate wert);
+
+// Float mit 6 Nachkommastellen, identisch zu printf("%f").
+char* FormatFloat(char* out, float wert);
+
+// Wie FormatKoordinate bzw. FormatFloat, aber ohne Nullen am Ende der Nachkommastellen
+// und ohne Dezimalpunkt bei ganzen Zahlen. Der gelesene Wert ist derselbe; 0 wird immer als "0" geschrieben.
+char* FormatKoordinateKompakt(char* out, Koordinate wert);
+char* FormatFloatKompakt(char* out, float wert);
+
+// Schritte pro Einheit fuer FormatFloatQuantisiert, 1/16 Pixel bei einem 256 Pixel breiten Atlas.
+constexpr int kQuantisierungsSchritte = 4096;
+
+// Koordinate auf ganze Millimeter gerundet, gekuerzt wie FormatKoordinateKompakt.
+char* FormatKoordinateMm(char* out, Koordinate wert);
+
+// Float auf Vielfache von 1/kQuantisierungsSchritte gerundet und mit 4 Nachkommastellen geschrieben,
+// gekuerzt wie FormatFloatKompakt. Genug Stellen, um den Schritt beim Lesen eindeutig wiederzufinden;
+// ganze Zahlen (z.B. Komponenten achsparalleler Normalen) werden ohne Nachkommastellen geschrieben.
+char* FormatFloatQuantisiert(char* out, float wert);
+
+#endif  // ZAHLENFORMAT_HPP_